@@ -0,0 +1,136 @@
+#!/usr/bin/env python
+# Host tool, not an XPMaster script: generates src/fontdata.h from the display
+# panel firmware's font sources, so text the host draws into its shadow
+# framebuffer matches what the panel's DrawString renders.
+#
+# usage: fontdata.py <firmware font dir> [output header]
+#
+# The firmware keeps each font as a bdf2c style C file, Font_<name>.c, holding
+# a glyph row table, a table of the character codes in it and a bitmap_font
+# struct { width, height, count, widths, index, bitmap }. Rows are one byte
+# each, written either as numbers or as bit pattern macros like ___XX___.
+import os
+import re
+import sys
+
+
+# panel font choices in fontChoices order, with the cell fonts.cpp expects
+FONTS = [
+    ('apple3x5',      4,  6),
+    ('apple5x7',      5,  7),
+    ('apple6x10',     6, 10),
+    ('apple8x13',     8, 13),
+    ('gohufont6x11',  6, 11),
+    ('gohufont6x11b', 6, 11),
+]
+
+FIRSTCHAR = 0x20
+LASTCHAR  = 0x7E
+
+
+def fail(message):
+    sys.stderr.write('fontdata.py error: %s\n' % message)
+    sys.exit(1)
+
+
+def strip_comments(source):
+    source = re.sub(r'/\*.*?\*/', ' ', source, flags=re.S)
+    return re.sub(r'//[^\n]*', ' ', source)
+
+
+def array(source, name):
+    match = re.search(r'\b' + re.escape(name) + r'\s*\[\s*\]\s*=\s*\{(.*?)\}', source, re.S)
+    if not match:
+        fail('no array %s' % name)
+    return [v.strip() for v in match.group(1).split(',') if v.strip()]
+
+
+def value(token):
+    # bit pattern macros name set pixels with X, most significant bit first
+    if re.match(r'^[_X]{8}$', token):
+        return int(token.replace('_', '0').replace('X', '1'), 2)
+    return int(token, 0)
+
+
+def load(path, name):
+    source = strip_comments(open(path).read())
+
+    match = re.search(r'bitmap_font\s+' + re.escape(name) + r'\s*=\s*\{(.*?)\}', source, re.S)
+    if not match:
+        fail('%s has no bitmap_font %s' % (path, name))
+
+    fields = [v.strip().lstrip('&') for v in match.group(1).split(',') if v.strip()]
+    if len(fields) != 6:
+        fail('%s: unexpected bitmap_font layout' % path)
+
+    width, height, count = int(fields[0], 0), int(fields[1], 0), int(fields[2], 0)
+    index  = [value(v) for v in array(source, fields[4])]
+    bitmap = [value(v) for v in array(source, fields[5])]
+
+    if (len(index) != count) or (len(bitmap) != (count * height)):
+        fail('%s: %u glyphs, index %u, %u rows' % (path, count, len(index), len(bitmap)))
+
+    glyphs = {}
+    for i, code in enumerate(index):
+        glyphs[code] = bitmap[i * height:(i + 1) * height]
+
+    return width, height, glyphs
+
+
+def emit(name, cell_width, cell_height, width, height, glyphs):
+    if (width > cell_width) or (height > cell_height):
+        fail('%s is %ux%u, larger than its %ux%u cell' % (name, width, height, cell_width, cell_height))
+
+    out  = '// %s, %ux%u pixel cell\n' % (name, cell_width, cell_height)
+    out += 'static constexpr uint8_t fontBitmap_%s[] =\n{\n' % name
+
+    for code in range(FIRSTCHAR, LASTCHAR + 1):
+        # characters the firmware lacks draw as '?' there as well
+        rows = glyphs.get(code, glyphs.get(ord('?'), [0] * height))
+        rows = list(rows) + [0] * (cell_height - height)
+
+        char = chr(code)
+        if char in '\\\'':
+            char = '\\' + char
+
+        out += '\t' + ', '.join('0x%02x' % (r & 0xFF) for r in rows) + ",\t// '%s'\n" % char
+
+    return out + '};\n'
+
+
+def main():
+    if len(sys.argv) < 2:
+        fail('usage: fontdata.py <firmware font dir> [output header]')
+
+    fontdir = sys.argv[1]
+    output  = sys.argv[2] if (len(sys.argv) > 2) else os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'src', 'fontdata.h')
+    parts   = []
+
+    for name, cell_width, cell_height in FONTS:
+        width, height, glyphs = load(os.path.join(fontdir, 'Font_%s.c' % name), name)
+        parts.append(emit(name, cell_width, cell_height, width, height, glyphs))
+
+    header = (
+        '#ifndef XPM_FONTDATA_H_\n'
+        '#define XPM_FONTDATA_H_\n'
+        '\n'
+        '/*\n'
+        ' * Glyph bitmaps of the display panel\'s built-in fonts, printable ASCII 0x20 - 0x7E.\n'
+        ' * Generated by scripts/fontdata.py from the firmware\'s font sources, don\'t edit.\n'
+        ' * \n'
+        ' * Each glyph is one byte per row, top row first, most significant bit is the\n'
+        ' * left most pixel. Only include from fonts.cpp.\n'
+        ' */\n'
+        '\n'
+        '\n'
+        '// glyphs are the firmware\'s own, host and panel rendered text look the same\n'
+        '#define FONTDATA_FIRMWARE\t1\n'
+        '\n'
+        '\n')
+
+    with open(output, 'w') as f:
+        f.write(header + '\n\n'.join(parts) + '\n\n#endif // XPM_FONTDATA_H_\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -6,6 +6,7 @@ from ledmatrixext.rgb24 import rgb24
 # Also all standard Python libraries and system installed are available
 from datetime import datetime, date, time
 import random
+from array import array
 
 # stdout works
 print('Showing off python script demo')
@@ -67,23 +68,8 @@ def centerText(font, color, text):
 
 
 def colorWheel(WheelPos):
-    if WheelPos < 85:
-        color_red   = WheelPos * 3
-        color_green = 255 - WheelPos * 3
-        color_blue  = 0
-        return rgb24(color_red, color_green, color_blue)
-    elif WheelPos < 170:
-        WheelPos   -=  85
-        color_red   = 255 - WheelPos * 3
-        color_green = 0
-        color_blue  = WheelPos * 3
-        return rgb24(color_red, color_green, color_blue)
-    else:
-        WheelPos   -= 170
-        color_red   = 0
-        color_green = WheelPos * 3
-        color_blue  = 255 - WheelPos * 3
-        return rgb24(color_red, color_green, color_blue)
+    # compile time generated table of the ledmatrix module
+    return rgb24(ledmatrix.colorWheel(WheelPos))
 
 
 # main loop
@@ -119,16 +105,16 @@ while True:
     matrix.fillScreen(rgb24(0, 0, 0))
     
     # draw color wheel while scrolling text
+    # one batch call per frame, columns as int16 buffer and their colors as rgb byte triples
     wheelPos = 128
+    columns = array('h', range(matrix.width / 2))
     while (scroller1.getScrollStatus() > 0):
         wheelPos = (wheelPos + 6) % 255
-        cw = wheelPos
-        for x in range(matrix.width / 2):
-            cw = (cw + 4) % 255
-            color = colorWheel(cw)
-            matrix.drawFastVLine(x, 0, matrix.height -1, color);
+        # colors of all columns in one table lookup pass, 8.8 fixed point wheel positions
+        colors = ledmatrix.gradient(ledmatrix.PALETTE_Wheel, len(columns), (wheelPos + 4) * 256, 4 * 256)
+        matrix.drawVLines(columns, 0, matrix.height -1, colors)
         
-        scroller0.setScrollColor(color)
+        scroller0.setScrollColor(rgb24(*colors[-3:]))
 
         # swap buffers and vsync
         matrix.waitForVSync()
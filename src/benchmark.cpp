@@ -0,0 +1,251 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "pixelformat.h"
+#include "framecompress.h"
+#include "colorpipeline.h"
+#include "benchmark.h"
+
+
+#define BENCHMARK_WIDTH			128
+#define BENCHMARK_HEIGHT		64
+#define BENCHMARK_ITERATIONS	200
+#define BENCHMARK_COLOR_PIXELS	(1024 * 1024)	// one megapixel per color pipeline pass
+#define BENCHMARK_COLOR_PASSES	8
+
+
+// sample patterns, the kind of frames direct framebuffer loops produce
+static void patternColumns(FrameBuffer &frame)
+{
+	rgb24 color;
+
+	// example_DirectFBWrite's moving colorwheel columns with a white border
+	for(int16_t x=0; x<frame.width(); x++)
+	{
+		colorWheel(color, (uint8_t)(x * 4));
+		frame.drawFastVLine(x, 0, frame.height() -1, color);
+	}
+	frame.drawRectangle(0, 0, frame.width() -1, frame.height() -1, rgb24(255, 255, 255));
+}
+
+static void patternSolid(FrameBuffer &frame)
+{
+	frame.fillScreen(rgb24(0, 0, 0));
+}
+
+static void patternBars(FrameBuffer &frame)
+{
+	for(int16_t x=0; x<frame.width(); x+=8)
+		frame.fillRectangle(x, 0, x +7, frame.height() -1, rgb24(x * 2, 255 - (x * 2), 64), rgb24(x * 2, 255 - (x * 2), 64));
+}
+
+static void patternText(FrameBuffer &frame)
+{
+	frame.fillScreen(rgb24(0, 0, 0));
+	frame.setFont(font6x10);
+	for(int16_t y=0; y<frame.height(); y+=12)
+		frame.drawString(2, y, rgb24(255, 200, 0), rgb24(0, 0, 0), "12:34:56 Ticker");
+}
+
+static void patternNoise(FrameBuffer &frame)
+{
+	uint32_t seed = 12345;
+
+	for(size_t i=0; i<frame.size(); i++)
+	{
+		seed = (seed * 1103515245) + 12345;
+		frame.pixels()[i] = rgb24(seed >> 24, seed >> 16, seed >> 8);
+	}
+}
+
+/**
+ * Packetize a whole frame the way delta streaming does when every segment
+ * changed, compressed where it saves packets.
+ *
+ * @return	Packets needed, 0 if decoding didn't reproduce the frame.
+ */
+static size_t compressFrame(const std::vector<uint8_t> &data, size_t stride, std::vector<uint8_t> *check, size_t &payload)
+{
+	const size_t	count   = (data.size() + RPCFB_SEGMENT_SIZE -1) / RPCFB_SEGMENT_SIZE;
+	size_t			packets = 0;
+	uint8_t			tokens[RPCFB_COMPRESSED_SIZE];
+
+
+	payload = 0;
+	for(size_t i=0, covered; i<count; i+=covered, packets++)
+	{
+		size_t written;
+
+		covered = frameCompress(data.data(), data.size(), stride, i, std::min<size_t>(count - i, 0xFF), tokens, written);
+		if(covered > 1)
+		{
+			payload += sizeof(tRPCFrameCompressed) + written;
+			if(check && !frameDecompress(check->data(), check->size(), i, covered, tokens, written))
+				return 0;
+			continue;
+		}
+
+		covered = 1;
+		payload += sizeof(tRPCFrameSegment) + std::min<size_t>(data.size() - (i * RPCFB_SEGMENT_SIZE), RPCFB_SEGMENT_SIZE);
+		if(check)
+			memcpy(&(*check)[i * RPCFB_SEGMENT_SIZE], &data[i * RPCFB_SEGMENT_SIZE],
+				   std::min<size_t>(data.size() - (i * RPCFB_SEGMENT_SIZE), RPCFB_SEGMENT_SIZE));
+	}
+
+	if(check && (*check != data))
+		return 0;
+
+	return packets;
+}
+
+// time passes of a color pipeline over the noise frame tiled to a megapixel, ns per pass
+static int64_t timePipeline(const ColorPipeline &pipeline, const std::vector<rgb24> &src, std::vector<rgb24> &dest)
+{
+	const int64_t start = clock_getnstime(CLOCK_MONOTONIC);
+
+	for(size_t i=0; i<BENCHMARK_COLOR_PASSES; i++)
+		pipeline.apply(src.data(), dest.data(), src.size());
+
+	return (clock_getnstime(CLOCK_MONOTONIC) - start) / BENCHMARK_COLOR_PASSES;
+}
+
+/**
+ * Report the cost per megapixel of each color pipeline stage with the vector
+ * kernels against the scalar reference loops, checking both agree.
+ */
+static int benchmarkColorPipeline(const FrameBuffer &noise)
+{
+	static const struct
+	{
+		const char		*name;
+		float			gamma;
+		uint8_t			brightness;
+		float			saturation;
+		colorOrder		order;
+	} stages[] =
+	{
+		{ "saturate",	1.0f, 255, 1.5f, colorOrder::RGB },
+		{ "bright",		1.0f, 128, 1.0f, colorOrder::RGB },
+		{ "reorder",	1.0f, 255, 1.0f, colorOrder::GRB },
+		{ "gamma",		2.2f, 255, 1.0f, colorOrder::RGB },
+		{ "all",		2.2f, 128, 1.5f, colorOrder::GRB },
+	};
+
+	std::vector<rgb24>	src(BENCHMARK_COLOR_PIXELS), scalar(src.size()), vector(src.size());
+	int					result = 0;
+
+
+	for(size_t i=0; i<src.size(); i++)
+		src[i] = noise.pixels()[i % noise.size()];
+
+	printf("\nColor pipeline, %s kernels\n", colorPipelineKernels());
+	printf("%-8s %14s %14s %8s\n", "stage", "scalar ns/Mpx", "vector ns/Mpx", "speedup");
+
+	for(size_t s=0; s<ARRAYSIZE(stages); s++)
+	{
+		ColorPipeline pipeline;
+
+		pipeline.setGamma(stages[s].gamma);
+		pipeline.setBrightness(stages[s].brightness);
+		pipeline.setSaturation(stages[s].saturation);
+		pipeline.setColorOrder(stages[s].order);
+
+		pipeline.setReference(true);
+		const int64_t reference = timePipeline(pipeline, src, scalar);
+		pipeline.setReference(false);
+		const int64_t vectored  = timePipeline(pipeline, src, vector);
+
+		if(memcmp(scalar.data(), vector.data(), src.size() * sizeof(rgb24)))
+		{
+			printf("%-8s vector kernels differ from the scalar reference\n", stages[s].name);
+			result = -1;
+			continue;
+		}
+
+		printf("%-8s %14lld %14lld %7.2fx\n", stages[s].name, (long long)reference, (long long)vectored,
+			   (double)reference / std::max<int64_t>(vectored, 1));
+	}
+
+	return result;
+}
+
+/**
+ * Report compression ratio, packets and encode time per frame of the
+ * compressed segment transport for the sample patterns and wire formats,
+ * followed by the color pipeline stage costs.
+ */
+int runBenchmark()
+{
+	static const struct
+	{
+		const char		*name;
+		void			(*draw)(FrameBuffer &frame);
+	} patterns[] =
+	{
+		{ "columns",	patternColumns },
+		{ "solid",		patternSolid },
+		{ "bars",		patternBars },
+		{ "text",		patternText },
+		{ "noise",		patternNoise },
+	};
+	static const struct
+	{
+		const char		*name;
+		rpcFrameFormat	format;
+	} formats[] =
+	{
+		{ "RGB888",		rpcFrameFormat::RGB888 },
+		{ "RGB565",		rpcFrameFormat::RGB565 },
+		{ "RGB332",		rpcFrameFormat::RGB332 },
+	};
+
+	FrameBuffer				frame(BENCHMARK_WIDTH, BENCHMARK_HEIGHT);
+	std::vector<uint8_t>	data, check;
+	int						result = 0;
+
+
+	printf("Frame transport benchmark, %dx%d pixels, %s pixel format kernels\n",
+		   BENCHMARK_WIDTH, BENCHMARK_HEIGHT, pixelFormatKernels());
+	printf("%-8s %-7s %7s %8s %8s %7s %10s\n", "pattern", "format", "bytes", "raw pkt", "lz pkt", "ratio", "encode ns");
+
+	for(size_t p=0; p<ARRAYSIZE(patterns); p++)
+	{
+		frame.fillScreen(rgb24(0, 0, 0));
+		patterns[p].draw(frame);
+
+		for(size_t f=0; f<ARRAYSIZE(formats); f++)
+		{
+			const size_t stride = pixelFormatSize(formats[f].format, frame.width());
+			size_t       payload, packets;
+
+			data.resize(pixelFormatSize(formats[f].format, frame.size()));
+			pixelFormatConvert(formats[f].format, frame.pixels(), frame.size(), data.data());
+
+			check.assign(data.size(), 0);
+			if(!compressFrame(data, stride, &check, payload))
+			{
+				printf("%-8s %-7s decoded frame differs\n", patterns[p].name, formats[f].name);
+				result = -1;
+				continue;
+			}
+
+			const int64_t start = clock_getnstime(CLOCK_MONOTONIC);
+			for(size_t i=0; i<BENCHMARK_ITERATIONS; i++)
+				packets = compressFrame(data, stride, NULL, payload);
+			const int64_t elapsed = clock_getnstime(CLOCK_MONOTONIC) - start;
+
+			const size_t raw = (data.size() + RPCFB_SEGMENT_SIZE -1) / RPCFB_SEGMENT_SIZE;
+			printf("%-8s %-7s %7zu %8zu %8zu %6.2fx %10lld\n", patterns[p].name, formats[f].name, data.size(), raw, packets,
+				   (double)data.size() / payload, (long long)(elapsed / BENCHMARK_ITERATIONS));
+		}
+	}
+
+	// the noise pattern covers every color
+	frame.fillScreen(rgb24(0, 0, 0));
+	patternNoise(frame);
+	if(benchmarkColorPipeline(frame))
+		result = -1;
+
+	return result;
+}
@@ -0,0 +1,10 @@
+#ifndef XPM_BENCHMARK_H_
+#define XPM_BENCHMARK_H_
+
+
+// Host side frame transport and color pipeline benchmarks on sample patterns, runs without a
+// display panel
+int runBenchmark();
+
+
+#endif // XPM_BENCHMARK_H_
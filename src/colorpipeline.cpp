@@ -0,0 +1,567 @@
+#include <xpmcommon.h>
+#include <cmath>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "colorpipeline.h"
+#include "simd.h"
+
+#if defined(XPM_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+
+// Vector kernels process whole blocks in place and return how many pixels, or for scale how
+// many bytes, they covered, the scalar kernels finish the rest
+typedef size_t (*tSaturateKernel)(uint8_t *pixels, size_t count, int16_t saturation);
+typedef size_t (*tScaleKernel)(uint8_t *bytes, size_t size, uint8_t scale);
+typedef size_t (*tReorderKernel)(uint8_t *pixels, size_t count, const uint8_t map[3]);
+
+struct tColorKernels
+{
+	const char		*name;
+	tSaturateKernel	saturate;
+	tScaleKernel	scale;
+	tReorderKernel	reorder;
+};
+
+// Rec. 601 luma weights in 1/256
+#define LUMA_R		77
+#define LUMA_G		150
+#define LUMA_B		29
+
+
+//-----------------------------------------------------------------------------
+// Scalar reference kernels
+//-----------------------------------------------------------------------------
+// exact rounded x / 255 for x up to 255 * 255
+static inline uint8_t div255(uint32_t x)
+{
+	x += 128;
+	return (uint8_t)((x + (x >> 8)) >> 8);
+}
+
+/**
+ * Move each channel away from or towards the pixel's luma. The difference is
+ * scaled as (d * 16 * s) >> 16 with a flooring shift, which is what the 16 bit
+ * multiply high instructions of the vector kernels compute.
+ */
+static size_t scalarSaturate(uint8_t *pixels, size_t count, int16_t saturation)
+{
+	for(size_t i=0; i<count; i++, pixels += 3)
+	{
+		const int y = ((LUMA_R * pixels[0]) + (LUMA_G * pixels[1]) + (LUMA_B * pixels[2]) + 128) >> 8;
+
+		for(int c=0; c<3; c++)
+		{
+			const int v = y + (((pixels[c] - y) * 16 * saturation) >> 16);
+			pixels[c] = (uint8_t)std::min(std::max(v, 0), 255);
+		}
+	}
+
+	return count;
+}
+
+static size_t scalarScale(uint8_t *bytes, size_t size, uint8_t scale)
+{
+	for(size_t i=0; i<size; i++)
+		bytes[i] = div255((uint32_t)bytes[i] * scale);
+
+	return size;
+}
+
+static size_t scalarReorder(uint8_t *pixels, size_t count, const uint8_t map[3])
+{
+	for(size_t i=0; i<count; i++, pixels += 3)
+	{
+		const uint8_t v[3] = { pixels[0], pixels[1], pixels[2] };
+
+		pixels[0] = v[map[0]];
+		pixels[1] = v[map[1]];
+		pixels[2] = v[map[2]];
+	}
+
+	return count;
+}
+
+// table lookups don't vectorize on these CPUs, brightness and reorder are folded in instead
+static void scalarLUT(uint8_t *pixels, size_t count, const uint8_t lut[3][256], const uint8_t map[3])
+{
+	for(size_t i=0; i<count; i++, pixels += 3)
+	{
+		const uint8_t v[3] = { lut[0][pixels[0]], lut[1][pixels[1]], lut[2][pixels[2]] };
+
+		pixels[0] = v[map[0]];
+		pixels[1] = v[map[1]];
+		pixels[2] = v[map[2]];
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+// NEON kernels
+//-----------------------------------------------------------------------------
+#if defined(XPM_SIMD_NEON)
+
+static size_t neonSaturate(uint8_t *pixels, size_t count, int16_t saturation)
+{
+	const int16x8_t	s = vdupq_n_s16(saturation);
+	size_t			i = 0;
+
+	for(; (i + 16) <= count; i += 16, pixels += 48)
+	{
+		uint8x16x3_t px = vld3q_u8(pixels);
+
+		for(int half=0; half<2; half++)
+		{
+			const uint8x8_t r = (half)? vget_high_u8(px.val[0]) : vget_low_u8(px.val[0]);
+			const uint8x8_t g = (half)? vget_high_u8(px.val[1]) : vget_low_u8(px.val[1]);
+			const uint8x8_t b = (half)? vget_high_u8(px.val[2]) : vget_low_u8(px.val[2]);
+			const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vrshrn_n_u16(
+				vmlal_u8(vmlal_u8(vmull_u8(r, vdup_n_u8(LUMA_R)), g, vdup_n_u8(LUMA_G)), b, vdup_n_u8(LUMA_B)), 8)));
+			const uint8x8_t	c[3] = { r, g, b };
+			uint8x8_t		out[3];
+
+			// doubling multiply high of d * 8 is (d * 16 * s) >> 16
+			for(int k=0; k<3; k++)
+			{
+				int16x8_t d = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(c[k])), y);
+				out[k] = vqmovun_s16(vaddq_s16(y, vqdmulhq_s16(vshlq_n_s16(d, 3), s)));
+			}
+
+			for(int k=0; k<3; k++)
+				px.val[k] = (half)? vcombine_u8(vget_low_u8(px.val[k]), out[k]) : vcombine_u8(out[k], vget_high_u8(px.val[k]));
+		}
+
+		vst3q_u8(pixels, px);
+	}
+
+	return i;
+}
+
+static size_t neonScale(uint8_t *bytes, size_t size, uint8_t scale)
+{
+	const uint8x8_t	s = vdup_n_u8(scale);
+	size_t			i = 0;
+
+	for(; (i + 16) <= size; i += 16)
+	{
+		uint8x16_t v  = vld1q_u8(bytes + i);
+		uint16x8_t xl = vmull_u8(vget_low_u8(v), s);
+		uint16x8_t xh = vmull_u8(vget_high_u8(v), s);
+
+		// x / 255 as (x + ((x + 128) >> 8) + 128) >> 8
+		vst1q_u8(bytes + i, vcombine_u8(vrshrn_n_u16(vrsraq_n_u16(xl, xl, 8), 8),
+										vrshrn_n_u16(vrsraq_n_u16(xh, xh, 8), 8)));
+	}
+
+	return i;
+}
+
+static size_t neonReorder(uint8_t *pixels, size_t count, const uint8_t map[3])
+{
+	size_t i = 0;
+
+	for(; (i + 16) <= count; i += 16, pixels += 48)
+	{
+		const uint8x16x3_t	px = vld3q_u8(pixels);
+		uint8x16x3_t		out;
+
+		out.val[0] = px.val[map[0]];
+		out.val[1] = px.val[map[1]];
+		out.val[2] = px.val[map[2]];
+		vst3q_u8(pixels, out);
+	}
+
+	return i;
+}
+
+static const tColorKernels sNEON = { "NEON", neonSaturate, neonScale, neonReorder };
+
+#endif // XPM_SIMD_NEON
+
+
+//-----------------------------------------------------------------------------
+// SSE2, SSSE3 and AVX2 kernels, the latter two picked at runtime
+//-----------------------------------------------------------------------------
+#if defined(XPM_SIMD_SSE2)
+
+// pshufb masks splitting 16 pixels from three 16 byte loads into channels and merging them back
+struct tChannelMasks
+{
+	__m128i			split[3][3];	// [channel][load]
+	__m128i			merge[3][3];	// [store][channel]
+
+	tChannelMasks()
+	{
+		uint8_t s[3][3][16], m[3][3][16];
+
+		memset(s, 0x80, sizeof(s));
+		memset(m, 0x80, sizeof(m));
+		for(int c=0; c<3; c++)
+		{
+			for(int p=0; p<16; p++)
+			{
+				const int k = (p * 3) + c;
+
+				s[c][k / 16][p] = k % 16;
+				m[k / 16][c][k % 16] = p;
+			}
+		}
+
+		for(int i=0; i<3; i++)
+		{
+			for(int j=0; j<3; j++)
+			{
+				split[i][j] = _mm_loadu_si128((const __m128i *)s[i][j]);
+				merge[i][j] = _mm_loadu_si128((const __m128i *)m[i][j]);
+			}
+		}
+	}
+};
+static const tChannelMasks sChannelMasks;
+
+__attribute__((target("ssse3")))
+static inline void splitChannels(const uint8_t *src, __m128i c[3])
+{
+	const __m128i in[3] =
+	{
+		_mm_loadu_si128((const __m128i *)src),
+		_mm_loadu_si128((const __m128i *)(src + 16)),
+		_mm_loadu_si128((const __m128i *)(src + 32)),
+	};
+
+	for(int k=0; k<3; k++)
+	{
+		c[k] = _mm_or_si128(_mm_or_si128(
+			_mm_shuffle_epi8(in[0], sChannelMasks.split[k][0]),
+			_mm_shuffle_epi8(in[1], sChannelMasks.split[k][1])),
+			_mm_shuffle_epi8(in[2], sChannelMasks.split[k][2]));
+	}
+}
+
+__attribute__((target("ssse3")))
+static inline void mergeChannels(uint8_t *dest, const __m128i c[3])
+{
+	for(int l=0; l<3; l++)
+	{
+		_mm_storeu_si128((__m128i *)(dest + (l * 16)), _mm_or_si128(_mm_or_si128(
+			_mm_shuffle_epi8(c[0], sChannelMasks.merge[l][0]),
+			_mm_shuffle_epi8(c[1], sChannelMasks.merge[l][1])),
+			_mm_shuffle_epi8(c[2], sChannelMasks.merge[l][2])));
+	}
+}
+
+static size_t sse2Scale(uint8_t *bytes, size_t size, uint8_t scale)
+{
+	const __m128i	zero  = _mm_setzero_si128();
+	const __m128i	s     = _mm_set1_epi16(scale);
+	const __m128i	round = _mm_set1_epi16(128);
+	size_t			i = 0;
+
+	for(; (i + 16) <= size; i += 16)
+	{
+		__m128i v  = _mm_loadu_si128((const __m128i *)(bytes + i));
+		__m128i xl = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), s), round);
+		__m128i xh = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), s), round);
+
+		xl = _mm_srli_epi16(_mm_add_epi16(xl, _mm_srli_epi16(xl, 8)), 8);
+		xh = _mm_srli_epi16(_mm_add_epi16(xh, _mm_srli_epi16(xh, 8)), 8);
+		_mm_storeu_si128((__m128i *)(bytes + i), _mm_packus_epi16(xl, xh));
+	}
+
+	return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t ssse3Saturate(uint8_t *pixels, size_t count, int16_t saturation)
+{
+	const __m128i	zero  = _mm_setzero_si128();
+	const __m128i	s     = _mm_set1_epi16(saturation);
+	const __m128i	wr    = _mm_set1_epi16(LUMA_R);
+	const __m128i	wg    = _mm_set1_epi16(LUMA_G);
+	const __m128i	wb    = _mm_set1_epi16(LUMA_B);
+	const __m128i	round = _mm_set1_epi16(128);
+	size_t			i = 0;
+
+	for(; (i + 16) <= count; i += 16, pixels += 48)
+	{
+		__m128i c[3], out[3][2];
+
+		splitChannels(pixels, c);
+		for(int half=0; half<2; half++)
+		{
+			__m128i c16[3];
+
+			for(int k=0; k<3; k++)
+				c16[k] = (half)? _mm_unpackhi_epi8(c[k], zero) : _mm_unpacklo_epi8(c[k], zero);
+
+			// luma sums stay below 65536, logical shifts do
+			const __m128i y = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_add_epi16(
+				_mm_mullo_epi16(c16[0], wr), _mm_mullo_epi16(c16[1], wg)), _mm_mullo_epi16(c16[2], wb)), round), 8);
+
+			for(int k=0; k<3; k++)
+				out[k][half] = _mm_add_epi16(y, _mm_mulhi_epi16(_mm_slli_epi16(_mm_sub_epi16(c16[k], y), 4), s));
+		}
+
+		for(int k=0; k<3; k++)
+			c[k] = _mm_packus_epi16(out[k][0], out[k][1]);
+		mergeChannels(pixels, c);
+	}
+
+	return i;
+}
+
+// five pixels per 16 byte load, the 16th byte is stored back unchanged and reloaded next
+__attribute__((target("ssse3")))
+static size_t ssse3Reorder(uint8_t *pixels, size_t count, const uint8_t map[3])
+{
+	const size_t	size = count * 3;
+	uint8_t			m[16];
+	size_t			i = 0;
+
+
+	for(int j=0; j<15; j++)
+		m[j] = ((j / 3) * 3) + map[j % 3];
+	m[15] = 15;
+
+	const __m128i mask = _mm_loadu_si128((const __m128i *)m);
+	for(; (i + 16) <= size; i += 15)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i *)(pixels + i));
+		_mm_storeu_si128((__m128i *)(pixels + i), _mm_shuffle_epi8(v, mask));
+	}
+
+	return i / 3;
+}
+
+__attribute__((target("avx2")))
+static size_t avx2Saturate(uint8_t *pixels, size_t count, int16_t saturation)
+{
+	const __m256i	s     = _mm256_set1_epi16(saturation);
+	const __m256i	wr    = _mm256_set1_epi16(LUMA_R);
+	const __m256i	wg    = _mm256_set1_epi16(LUMA_G);
+	const __m256i	wb    = _mm256_set1_epi16(LUMA_B);
+	const __m256i	round = _mm256_set1_epi16(128);
+	size_t			i = 0;
+
+	for(; (i + 16) <= count; i += 16, pixels += 48)
+	{
+		__m128i c[3];
+		__m256i c16[3];
+
+		splitChannels(pixels, c);
+		for(int k=0; k<3; k++)
+			c16[k] = _mm256_cvtepu8_epi16(c[k]);
+
+		const __m256i y = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(_mm256_add_epi16(
+			_mm256_mullo_epi16(c16[0], wr), _mm256_mullo_epi16(c16[1], wg)), _mm256_mullo_epi16(c16[2], wb)), round), 8);
+
+		for(int k=0; k<3; k++)
+		{
+			const __m256i v = _mm256_add_epi16(y, _mm256_mulhi_epi16(_mm256_slli_epi16(_mm256_sub_epi16(c16[k], y), 4), s));
+			c[k] = _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+		}
+		mergeChannels(pixels, c);
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t avx2Scale(uint8_t *bytes, size_t size, uint8_t scale)
+{
+	const __m256i	zero  = _mm256_setzero_si256();
+	const __m256i	s     = _mm256_set1_epi16(scale);
+	const __m256i	round = _mm256_set1_epi16(128);
+	size_t			i = 0;
+
+	// unpack and packus both work per 128 bit lane, the byte order comes out unchanged
+	for(; (i + 32) <= size; i += 32)
+	{
+		__m256i v  = _mm256_loadu_si256((const __m256i *)(bytes + i));
+		__m256i xl = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(v, zero), s), round);
+		__m256i xh = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(v, zero), s), round);
+
+		xl = _mm256_srli_epi16(_mm256_add_epi16(xl, _mm256_srli_epi16(xl, 8)), 8);
+		xh = _mm256_srli_epi16(_mm256_add_epi16(xh, _mm256_srli_epi16(xh, 8)), 8);
+		_mm256_storeu_si256((__m256i *)(bytes + i), _mm256_packus_epi16(xl, xh));
+	}
+
+	return i;
+}
+
+static const tColorKernels sSSE2  = { "SSE2",  NULL,          sse2Scale, NULL };
+static const tColorKernels sSSSE3 = { "SSSE3", ssse3Saturate, sse2Scale, ssse3Reorder };
+static const tColorKernels sAVX2  = { "AVX2",  avx2Saturate,  avx2Scale, ssse3Reorder };
+
+#endif // XPM_SIMD_SSE2
+
+
+static const tColorKernels sScalar = { "scalar", NULL, NULL, NULL };
+
+static const tColorKernels& kernels()
+{
+#if defined(XPM_SIMD_NEON)
+	return sNEON;
+#elif defined(XPM_SIMD_SSE2)
+	static const tColorKernels &picked =
+		(__builtin_cpu_supports("avx2"))?	sAVX2 :
+		(__builtin_cpu_supports("ssse3"))?	sSSSE3 : sSSE2;
+
+	return picked;
+#else
+	return sScalar;
+#endif
+}
+
+const char* colorPipelineKernels()
+{
+	return kernels().name;
+}
+
+
+//=============================================================================
+// Color correction pipeline class
+//=============================================================================
+ColorPipeline::ColorPipeline()
+:	mGamma(1.0f),
+	mWhite(255, 255, 255),
+	mBrightness(255),
+	mSaturation(4096),
+	mOrder(colorOrder::RGB),
+	mLUTActive(false),
+	mReference(false)
+{
+	update();
+}
+ColorPipeline::~ColorPipeline()
+{
+}
+
+void ColorPipeline::setGamma(float gamma)
+{
+	mGamma = std::max(gamma, 0.1f);
+	update();
+}
+
+void ColorPipeline::setWhiteBalance(const rgb24 &white)
+{
+	mWhite = white;
+	update();
+}
+
+void ColorPipeline::setBrightness(uint8_t brightness)
+{
+	mBrightness = brightness;
+	update();
+}
+
+void ColorPipeline::setSaturation(float saturation)
+{
+	mSaturation = (int16_t)((std::min(std::max(saturation, 0.0f), 4.0f) * 4096.0f) + 0.5f);
+}
+
+void ColorPipeline::setColorOrder(colorOrder order)
+{
+	mOrder = order;
+	update();
+}
+
+bool ColorPipeline::identity() const
+{
+	return (mSaturation == 4096) && !mLUTActive && (mBrightness == 255) && (mOrder == colorOrder::RGB);
+}
+
+// rebuild the channel map and the LUT, brightness is applied ahead of the gamma curve
+void ColorPipeline::update()
+{
+	static const uint8_t maps[][3] =
+	{
+		{ 0, 1, 2 },	// RGB
+		{ 0, 2, 1 },	// RBG
+		{ 1, 0, 2 },	// GRB
+		{ 1, 2, 0 },	// GBR
+		{ 2, 0, 1 },	// BRG
+		{ 2, 1, 0 },	// BGR
+	};
+	const uint8_t white[3] = { mWhite.red, mWhite.green, mWhite.blue };
+
+
+	memcpy(mMap, maps[(size_t)mOrder < ARRAYSIZE(maps)? (size_t)mOrder : 0], sizeof(mMap));
+
+	mLUTActive = (mGamma != 1.0f) || (mWhite != rgb24(255, 255, 255));
+	if(!mLUTActive)
+		return;
+
+	for(int v=0; v<256; v++)
+	{
+		const float level = std::pow(div255(v * mBrightness) / 255.0f, mGamma);
+
+		for(int c=0; c<3; c++)
+			mLUT[c][v] = (uint8_t)((level * white[c]) + 0.5f);
+	}
+}
+
+void ColorPipeline::run(uint8_t *pixels, size_t count) const
+{
+	const tColorKernels	&k = mReference? sScalar : kernels();
+	size_t				 i;
+
+
+	if(mSaturation != 4096)
+	{
+		i = k.saturate? k.saturate(pixels, count, mSaturation) : 0;
+		scalarSaturate(pixels + (i * 3), count - i, mSaturation);
+	}
+
+	if(mLUTActive)
+	{
+		scalarLUT(pixels, count, mLUT, mMap);
+		return;
+	}
+
+	if(mBrightness != 255)
+	{
+		i = k.scale? k.scale(pixels, count * 3, mBrightness) : 0;
+		scalarScale(pixels + i, (count * 3) - i, mBrightness);
+	}
+
+	if(mOrder != colorOrder::RGB)
+	{
+		i = k.reorder? k.reorder(pixels, count, mMap) : 0;
+		scalarReorder(pixels + (i * 3), count - i, mMap);
+	}
+}
+
+/**
+ * Run count pixels through the enabled stages. Pixels go through all stages
+ * COLORPIPE_CHUNK at a time so they're read from memory once.
+ *
+ * @param src	Pixels to correct.
+ * @param dest	Corrected pixels, may be src.
+ * @param count	Pixels.
+ */
+void ColorPipeline::apply(const rgb24 *src, rgb24 *dest, size_t count) const
+{
+	if(identity())
+	{
+		if(src != dest)
+			memcpy((uint8_t *)dest, (const uint8_t *)src, count * sizeof(rgb24));
+		return;
+	}
+
+	for(size_t offset = 0; offset < count; offset += COLORPIPE_CHUNK)
+	{
+		const size_t n = std::min<size_t>(COLORPIPE_CHUNK, count - offset);
+
+		if(src != dest)
+			memcpy((uint8_t *)(dest + offset), (const uint8_t *)(src + offset), n * sizeof(rgb24));
+		run((uint8_t *)(dest + offset), n);
+	}
+}
+
+void ColorPipeline::apply(FrameBuffer &frame) const
+{
+	apply(frame.pixels(), frame.size());
+}
@@ -0,0 +1,76 @@
+#ifndef XPM_COLORPIPELINE_H_
+#define XPM_COLORPIPELINE_H_
+
+
+#define COLORPIPE_CHUNK			512		// pixels run through all stages at a time, stays in L1
+
+
+// Channel order the panel's LEDs expect, bytes are sent in this order
+enum class colorOrder
+{
+	RGB = 0,
+	RBG,
+	GRB,
+	GBR,
+	BRG,
+	BGR,
+};
+
+
+// Host side color correction of frames before encoding, stages run in this order:
+// saturation, brightness, per channel gamma and white balance LUT, channel reorder
+class ColorPipeline
+{
+private:
+	float				mGamma;
+	rgb24				mWhite;			// channel maximums of full white
+	uint8_t				mBrightness;
+	int16_t				mSaturation;	// 4.12 fixed point, 4096 leaves colors unchanged
+	colorOrder			mOrder;
+	uint8_t				mMap[3];		// source channel of each output channel
+	uint8_t				mLUT[3][256];	// gamma and white balance with brightness folded in
+	bool				mLUTActive;
+	bool				mReference;
+
+
+	void update();
+	void run(uint8_t *pixels, size_t count) const;
+
+
+public:
+	ColorPipeline();
+	~ColorPipeline();
+
+	// 1.0 is linear, LED panels usually want around 2.2
+	void setGamma(float gamma);
+	float getGamma() const							{ return mGamma; }
+	// output of full white per channel
+	void setWhiteBalance(const rgb24 &white);
+	const rgb24& getWhiteBalance() const			{ return mWhite; }
+	// 255 is full brightness
+	void setBrightness(uint8_t brightness);
+	uint8_t getBrightness() const					{ return mBrightness; }
+	// 0 is grayscale, 1.0 unchanged, up to 4.0
+	void setSaturation(float saturation);
+	float getSaturation() const						{ return mSaturation / 4096.0f; }
+	void setColorOrder(colorOrder order);
+	colorOrder getColorOrder() const				{ return mOrder; }
+
+	// every stage leaves colors unchanged
+	bool identity() const;
+
+	// scalar reference kernels instead of the vector ones, same results, for tests and benchmarks
+	void setReference(bool reference)				{ mReference = reference; }
+
+	// src and dest may be the same
+	void apply(const rgb24 *src, rgb24 *dest, size_t count) const;
+	void apply(rgb24 *pixels, size_t count) const	{ apply(pixels, pixels, count); }
+	void apply(FrameBuffer &frame) const;
+};
+
+
+// vector kernels picked for the host CPU, for information
+const char* colorPipelineKernels();
+
+
+#endif // XPM_COLORPIPELINE_H_
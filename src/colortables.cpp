@@ -0,0 +1,217 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "colortables.h"
+
+
+//-----------------------------------------------------------------------------
+// Palette tables, generated at compile time
+//-----------------------------------------------------------------------------
+struct tColorEntry
+{
+	uint8_t			red, green, blue;
+};
+
+struct tColorTable
+{
+	tColorEntry		entry[COLORTABLE_SIZE];
+};
+
+static_assert(sizeof(tColorEntry) == sizeof(rgb24), "color table entries must be rgb24 layout");
+
+
+// colorWheel() thirds, 3 steps per entry
+static constexpr tColorEntry wheelEntry(size_t i)
+{
+	return (i <  85)? tColorEntry{ uint8_t(i * 3), uint8_t(255 - (i * 3)), 0 } :
+		   (i < 170)? tColorEntry{ uint8_t(255 - ((i - 85) * 3)), 0, uint8_t((i - 85) * 3) } :
+					  tColorEntry{ 0, uint8_t((i - 170) * 3), uint8_t(255 - ((i - 170) * 3)) };
+}
+
+// six hue sectors, one channel ramps while the other two are at full or off
+static constexpr tColorEntry hueSector(size_t sector, uint8_t f)
+{
+	return (sector == 0)? tColorEntry{ 255, f, 0 } :
+		   (sector == 1)? tColorEntry{ uint8_t(255 - f), 255, 0 } :
+		   (sector == 2)? tColorEntry{ 0, 255, f } :
+		   (sector == 3)? tColorEntry{ 0, uint8_t(255 - f), 255 } :
+		   (sector == 4)? tColorEntry{ f, 0, 255 } :
+						  tColorEntry{ 255, 0, uint8_t(255 - f) };
+}
+
+static constexpr tColorEntry hueEntry(size_t i)
+{
+	return hueSector((i * 6) / COLORTABLE_SIZE, uint8_t((i * 6) % COLORTABLE_SIZE));
+}
+
+// a + (b - a) * f / 255, rounded
+static constexpr uint8_t stopLerp(uint8_t a, uint8_t b, size_t f)
+{
+	return uint8_t(((a * (255 - f)) + (b * f) + 127) / 255);
+}
+
+static constexpr tColorEntry stopBlend(const tColorEntry &a, const tColorEntry &b, size_t f)
+{
+	return tColorEntry{ stopLerp(a.red, b.red, f), stopLerp(a.green, b.green, f), stopLerp(a.blue, b.blue, f) };
+}
+
+static constexpr tColorEntry stopAt(const tColorEntry *stops, size_t segment, size_t pos)
+{
+	return stopBlend(stops[segment], stops[segment +1], pos - (segment * 255));
+}
+
+// entry i of count stops spread evenly over the table, pos is i in 255ths of a segment
+static constexpr tColorEntry stopEntry(const tColorEntry *stops, size_t count, size_t i)
+{
+	return stopAt(stops, ((i * (count -1)) / 255 < (count -1))? (i * (count -1)) / 255 : count -2, i * (count -1));
+}
+
+template<size_t... I>
+static constexpr tColorTable wheelTable(tIndices<I...>)
+{
+	return tColorTable{ { wheelEntry(I)... } };
+}
+
+template<size_t... I>
+static constexpr tColorTable hueTable(tIndices<I...>)
+{
+	return tColorTable{ { hueEntry(I)... } };
+}
+
+template<size_t... I>
+static constexpr tColorTable stopTable(const tColorEntry *stops, size_t count, tIndices<I...>)
+{
+	return tColorTable{ { stopEntry(stops, count, I)... } };
+}
+
+static constexpr bool entryEqual(const tColorEntry &e, uint8_t red, uint8_t green, uint8_t blue)
+{
+	return (e.red == red) && (e.green == green) && (e.blue == blue);
+}
+
+// every entry of a gray ramp equals its index
+static constexpr bool grayRamp(const tColorTable &table, size_t i = 0)
+{
+	return (i >= COLORTABLE_SIZE) || (entryEqual(table.entry[i], i, i, i) && grayRamp(table, i +1));
+}
+
+
+static constexpr tColorEntry sHeatStops[]   = { {0, 0, 0}, {255, 0, 0}, {255, 255, 0}, {255, 255, 255} };
+static constexpr tColorEntry sOceanStops[]  = { {0, 0, 32}, {0, 64, 192}, {0, 192, 255}, {255, 255, 255} };
+static constexpr tColorEntry sLavaStops[]   = { {0, 0, 0}, {128, 0, 0}, {255, 64, 0}, {255, 160, 0}, {255, 255, 160} };
+static constexpr tColorEntry sForestStops[] = { {0, 32, 0}, {16, 96, 16}, {96, 160, 32}, {200, 220, 120} };
+static constexpr tColorEntry sGrayStops[]   = { {0, 0, 0}, {255, 255, 255} };
+
+#define COLOR_STOPTABLE(_name) \
+	stopTable(s##_name##Stops, ARRAYSIZE(s##_name##Stops), tMakeIndices<COLORTABLE_SIZE>::type())
+
+static constexpr tColorTable sWheelTable  = wheelTable(tMakeIndices<COLORTABLE_SIZE>::type());
+static constexpr tColorTable sHueTable    = hueTable(tMakeIndices<COLORTABLE_SIZE>::type());
+static constexpr tColorTable sHeatTable   = COLOR_STOPTABLE(Heat);
+static constexpr tColorTable sOceanTable  = COLOR_STOPTABLE(Ocean);
+static constexpr tColorTable sLavaTable   = COLOR_STOPTABLE(Lava);
+static constexpr tColorTable sForestTable = COLOR_STOPTABLE(Forest);
+static constexpr tColorTable sGrayTable   = COLOR_STOPTABLE(Gray);
+
+static_assert(entryEqual(sWheelTable.entry[0], 0, 255, 0) && entryEqual(sWheelTable.entry[85], 255, 0, 0) &&
+			  entryEqual(sWheelTable.entry[170], 0, 0, 255) && entryEqual(sWheelTable.entry[255], 0, 255, 0), "wheel table");
+static_assert(entryEqual(sHueTable.entry[0], 255, 0, 0) && entryEqual(sHueTable.entry[255], 255, 0, 5), "hue table");
+static_assert(entryEqual(sHeatTable.entry[0], 0, 0, 0) && entryEqual(sHeatTable.entry[255], 255, 255, 255), "heat table");
+static_assert(grayRamp(sGrayTable), "gray table");
+
+// indexed by colorPalette
+static const tColorTable *const sTables[] =
+{
+	&sWheelTable,
+	&sHueTable,
+	&sHeatTable,
+	&sOceanTable,
+	&sLavaTable,
+	&sForestTable,
+	&sGrayTable,
+};
+
+static_assert(ARRAYSIZE(sTables) == (size_t)colorPalette::_Count, "color table per palette");
+
+
+
+//=============================================================================
+// Color tables and gradient generators
+//=============================================================================
+const rgb24* colorTable(colorPalette palette)
+{
+	if((size_t)palette >= ARRAYSIZE(sTables))
+		return NULL;
+
+	return (const rgb24 *)sTables[(size_t)palette]->entry;
+}
+
+// x / 255 rounded, exact for 16 bit products
+static inline uint8_t div255(uint32_t x)
+{
+	x += 128;
+	return (uint8_t)((x + (x >> 8)) >> 8);
+}
+
+rgb24 colorHSV(uint8_t hue, uint8_t saturation, uint8_t value)
+{
+	const tColorEntry &e = sHueTable.entry[hue];
+
+	return rgb24(div255((255 - div255(saturation * (255 - e.red)))   * value),
+				 div255((255 - div255(saturation * (255 - e.green))) * value),
+				 div255((255 - div255(saturation * (255 - e.blue)))  * value));
+}
+
+void colorTableFromStops(rgb24 *dest, const rgb24 *colors, size_t count)
+{
+	const tColorEntry *stops = (const tColorEntry *)colors;
+
+	if(count < 2)
+	{
+		std::fill(dest, dest + COLORTABLE_SIZE, count? colors[0] : rgb24());
+		return;
+	}
+
+	// same interpolation as the built-in tables
+	for(size_t i=0; i<COLORTABLE_SIZE; i++)
+	{
+		const tColorEntry e = stopEntry(stops, count, i);
+		dest[i] = rgb24(e.red, e.green, e.blue);
+	}
+}
+
+void gradientRow(rgb24 *dest, size_t count, const rgb24 *table, uint16_t start, int16_t step)
+{
+	if(!step)
+	{
+		std::fill(dest, dest + count, table[start >> 8]);
+		return;
+	}
+
+	for(size_t i=0; i<count; i++, start += step)
+		dest[i] = table[start >> 8];
+}
+
+/**
+ * Fill a framebuffer with a two dimensional gradient, rows without vertical
+ * change are copied from the first one instead of looked up again.
+ *
+ * @param dest	Framebuffer to fill completely.
+ * @param table	COLORTABLE_SIZE palette entries.
+ * @param start	Palette position of the top left pixel, 8.8 fixed point.
+ * @param stepX	Position change per pixel to the right.
+ * @param stepY	Position change per row down.
+ */
+void gradientFill(FrameBuffer &dest, const rgb24 *table, uint16_t start, int16_t stepX, int16_t stepY)
+{
+	const size_t width = dest.width();
+
+	for(int16_t y=0; y<dest.height(); y++, start += stepY)
+	{
+		if(y && !stepY)
+			memcpy((uint8_t *)dest.row(y), (const uint8_t *)dest.row(0), width * sizeof(rgb24));
+		else
+			gradientRow(dest.row(y), width, table, start, stepX);
+	}
+}
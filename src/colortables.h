@@ -0,0 +1,40 @@
+#ifndef XPM_COLORTABLES_H_
+#define XPM_COLORTABLES_H_
+
+
+#define COLORTABLE_SIZE			256		// entries of every palette
+
+
+// Built-in palettes, generated at compile time
+enum class colorPalette
+{
+	Wheel = 0,		// colorWheel(), red to green to blue
+	Hue,			// fully saturated HSV hue circle
+	Heat,			// black, red, yellow, white
+	Ocean,
+	Lava,
+	Forest,
+	Gray,
+
+	_Count
+};
+
+
+// COLORTABLE_SIZE entries of a built-in palette, NULL if palette is unknown
+const rgb24* colorTable(colorPalette palette);
+
+// HSV to RGB from the hue table, saturation fades towards white and value towards black
+rgb24 colorHSV(uint8_t hue, uint8_t saturation, uint8_t value);
+
+// COLORTABLE_SIZE entries evenly interpolated between count >= 2 colors, e.g. for custom gradients
+void colorTableFromStops(rgb24 *dest, const rgb24 *colors, size_t count);
+
+/**
+ * Gradient generators, palette positions are 8.8 fixed point and wrap around
+ * the table, e.g. step 256 advances one entry per pixel.
+ */
+void gradientRow(rgb24 *dest, size_t count, const rgb24 *table, uint16_t start, int16_t step);
+void gradientFill(FrameBuffer &dest, const rgb24 *table, uint16_t start, int16_t stepX, int16_t stepY);
+
+
+#endif // XPM_COLORTABLES_H_
@@ -0,0 +1,405 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "framepalette.h"
+#include "framestream.h"
+#include "compositor.h"
+#include "simd.h"
+
+
+//-----------------------------------------------------------------------------
+// Blending helpers
+//-----------------------------------------------------------------------------
+// exact rounded x / 255 for x up to 255 * 255
+static inline uint8_t div255(uint32_t x)
+{
+	x += 128;
+	return (uint8_t)((x + (x >> 8)) >> 8);
+}
+
+/**
+ * Blend source bytes over destination bytes with a per byte alpha, runs of
+ * fully transparent or opaque alpha are skipped or copied 16 bytes at a time.
+ */
+static void blendBytes(uint8_t *dest, const uint8_t *src, const uint8_t *alpha, size_t size)
+{
+	size_t i = 0;
+
+#if defined(XPM_SIMD_NEON)
+	for(; (i + 16) <= size; i += 16)
+	{
+		uint8x16_t a  = vld1q_u8(alpha + i);
+		uint64_t   lo = vgetq_lane_u64(vreinterpretq_u64_u8(a), 0);
+		uint64_t   hi = vgetq_lane_u64(vreinterpretq_u64_u8(a), 1);
+
+		if(!(lo | hi))
+			continue;
+
+		uint8x16_t s = vld1q_u8(src + i);
+		if((lo & hi) == ~0ULL)
+		{
+			vst1q_u8(dest + i, s);
+			continue;
+		}
+
+		uint8x16_t d  = vld1q_u8(dest + i);
+		uint8x16_t ia = vmvnq_u8(a);
+		uint16x8_t xl = vmlal_u8(vmull_u8(vget_low_u8(s), vget_low_u8(a)), vget_low_u8(d), vget_low_u8(ia));
+		uint16x8_t xh = vmlal_u8(vmull_u8(vget_high_u8(s), vget_high_u8(a)), vget_high_u8(d), vget_high_u8(ia));
+
+		// x / 255 as (x + ((x + 128) >> 8) + 128) >> 8
+		vst1q_u8(dest + i, vcombine_u8(vrshrn_n_u16(vrsraq_n_u16(xl, xl, 8), 8),
+									   vrshrn_n_u16(vrsraq_n_u16(xh, xh, 8), 8)));
+	}
+#elif defined(XPM_SIMD_SSE2)
+	const __m128i zero  = _mm_setzero_si128();
+	const __m128i ones  = _mm_set1_epi8((char)0xFF);
+	const __m128i round = _mm_set1_epi16(128);
+
+	for(; (i + 16) <= size; i += 16)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i *)(alpha + i));
+
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(a, zero)) == 0xFFFF)
+			continue;
+
+		__m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(a, ones)) == 0xFFFF)
+		{
+			_mm_storeu_si128((__m128i *)(dest + i), s);
+			continue;
+		}
+
+		__m128i d  = _mm_loadu_si128((const __m128i *)(dest + i));
+		__m128i ia = _mm_xor_si128(a, ones);
+		__m128i xl = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(a, zero)),
+								   _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(ia, zero)));
+		__m128i xh = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(a, zero)),
+								   _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(ia, zero)));
+
+		xl = _mm_add_epi16(xl, round);
+		xh = _mm_add_epi16(xh, round);
+		xl = _mm_srli_epi16(_mm_add_epi16(xl, _mm_srli_epi16(xl, 8)), 8);
+		xh = _mm_srli_epi16(_mm_add_epi16(xh, _mm_srli_epi16(xh, 8)), 8);
+
+		_mm_storeu_si128((__m128i *)(dest + i), _mm_packus_epi16(xl, xh));
+	}
+#endif
+
+	for(; i < size; i++)
+		dest[i] = div255((uint32_t)src[i] * alpha[i] + (uint32_t)dest[i] * (255 - alpha[i]));
+}
+
+static inline bool dirtyTouch(const tDirtyRect &a, const tDirtyRect &b)
+{
+	return (a.x0 <= (b.x1 +1)) && (b.x0 <= (a.x1 +1)) &&
+		   (a.y0 <= (b.y1 +1)) && (b.y0 <= (a.y1 +1));
+}
+
+/**
+ * Add a rectangle to a dirty list. Overlapping or adjacent rectangles are
+ * merged into their bounds, and once the list grows beyond
+ * COMPOSITOR_DIRTY_MAX everything collapses into one bounding rectangle.
+ */
+void dirtyAdd(std::vector<tDirtyRect> &list, const tDirtyRect &rect)
+{
+	tDirtyRect merged = rect;
+
+
+	// a merge can make the result touch rectangles it didn't before
+	for(size_t i=0; i<list.size();)
+	{
+		if(!dirtyTouch(list[i], merged))
+		{
+			i++;
+			continue;
+		}
+
+		merged.x0 = std::min(merged.x0, list[i].x0);
+		merged.y0 = std::min(merged.y0, list[i].y0);
+		merged.x1 = std::max(merged.x1, list[i].x1);
+		merged.y1 = std::max(merged.y1, list[i].y1);
+
+		list[i] = list.back();
+		list.pop_back();
+		i = 0;
+	}
+
+	list.push_back(merged);
+	if(list.size() <= COMPOSITOR_DIRTY_MAX)
+		return;
+
+	for(size_t i=1; i<list.size(); i++)
+	{
+		list[0].x0 = std::min(list[0].x0, list[i].x0);
+		list[0].y0 = std::min(list[0].y0, list[i].y0);
+		list[0].x1 = std::max(list[0].x1, list[i].x1);
+		list[0].y1 = std::max(list[0].y1, list[i].y1);
+	}
+	list.resize(1);
+}
+
+
+
+//=============================================================================
+// Compositor layer class
+//=============================================================================
+Layer::Layer(int16_t width, int16_t height)
+:	mOpacity(255),
+	mVisible(true)
+{
+	resize(width, height);
+}
+Layer::~Layer()
+{
+}
+
+void Layer::resize(int16_t width, int16_t height)
+{
+	mSurface.resize(width, height);
+	mAlpha.assign(mSurface.size(), 0);
+	mDirty.clear();
+}
+
+void Layer::invalidate(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+	tDirtyRect rect;
+
+
+	if(x0 > x1) std::swap(x0, x1);
+	if(y0 > y1) std::swap(y0, y1);
+
+	rect.x0 = std::max<int16_t>(x0, 0);
+	rect.y0 = std::max<int16_t>(y0, 0);
+	rect.x1 = std::min<int16_t>(x1, width() -1);
+	rect.y1 = std::min<int16_t>(y1, height() -1);
+
+	if((rect.x0 <= rect.x1) && (rect.y0 <= rect.y1))
+		dirtyAdd(mDirty, rect);
+}
+
+void Layer::setAlpha(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t alpha)
+{
+	if(x0 > x1) std::swap(x0, x1);
+	if(y0 > y1) std::swap(y0, y1);
+
+	x0 = std::max<int16_t>(x0, 0);
+	y0 = std::max<int16_t>(y0, 0);
+	x1 = std::min<int16_t>(x1, width() -1);
+	y1 = std::min<int16_t>(y1, height() -1);
+	if((x0 > x1) || (y0 > y1))
+		return;
+
+	for(int y=y0; y<=y1; y++)
+		memset(&mAlpha[(y * width()) + x0], alpha, x1 - x0 +1);
+
+	invalidate(x0, y0, x1, y1);
+}
+
+void Layer::keyAlpha(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24 &key)
+{
+	if(x0 > x1) std::swap(x0, x1);
+	if(y0 > y1) std::swap(y0, y1);
+
+	x0 = std::max<int16_t>(x0, 0);
+	y0 = std::max<int16_t>(y0, 0);
+	x1 = std::min<int16_t>(x1, width() -1);
+	y1 = std::min<int16_t>(y1, height() -1);
+	if((x0 > x1) || (y0 > y1))
+		return;
+
+	for(int y=y0; y<=y1; y++)
+	{
+		const rgb24 *pixels = mSurface.row(y);
+		uint8_t     *alpha  = &mAlpha[y * width()];
+
+		for(int x=x0; x<=x1; x++)
+			alpha[x] = (pixels[x] == key)? 0 : 255;
+	}
+
+	invalidate(x0, y0, x1, y1);
+}
+
+void Layer::setOpacity(uint8_t opacity)
+{
+	if(opacity == mOpacity)
+		return;
+
+	mOpacity = opacity;
+	invalidate();
+}
+
+void Layer::setVisible(bool visible)
+{
+	if(visible == mVisible)
+		return;
+
+	mVisible = visible;
+	invalidate();
+}
+
+
+
+//=============================================================================
+// Layer compositor class
+//=============================================================================
+Compositor::Compositor(int16_t width, int16_t height)
+:	mBackground(0, 0, 0)
+{
+	resize(width, height);
+}
+Compositor::~Compositor()
+{
+	for(size_t i=0; i<mLayers.size(); i++)
+		delete mLayers[i];
+}
+
+/**
+ * Resize the frame and every layer, layer contents are lost.
+ */
+void Compositor::resize(int16_t width, int16_t height)
+{
+	mFrame.resize(width, height);
+	mAlphaRow.resize((size_t)std::max<int16_t>(width, 0) * sizeof(rgb24));
+
+	for(size_t i=0; i<mLayers.size(); i++)
+		mLayers[i]->resize(width, height);
+
+	invalidate();
+}
+
+void Compositor::invalidate()
+{
+	tDirtyRect rect = { 0, 0, (int16_t)(mFrame.width() -1), (int16_t)(mFrame.height() -1) };
+
+
+	mDirty.clear();
+	if(mFrame.size())
+		mDirty.push_back(rect);
+}
+
+void Compositor::setBackground(const rgb24 &color)
+{
+	if(color == mBackground)
+		return;
+
+	mBackground = color;
+	invalidate();
+}
+
+Layer* Compositor::addLayer()
+{
+	Layer *layer = new Layer(mFrame.width(), mFrame.height());
+
+
+	mLayers.push_back(layer);
+	return layer;
+}
+
+void Compositor::removeLayer(Layer *layer)
+{
+	std::vector<Layer *>::iterator it = std::find(mLayers.begin(), mLayers.end(), layer);
+
+
+	if(it == mLayers.end())
+		return;
+
+	// uncover what it showed
+	if(layer->mVisible)
+	{
+		layer->invalidate();
+		for(size_t i=0; i<layer->mDirty.size(); i++)
+			dirtyAdd(mDirty, layer->mDirty[i]);
+	}
+
+	mLayers.erase(it);
+	delete layer;
+}
+
+void Compositor::moveLayer(Layer *layer, size_t index)
+{
+	std::vector<Layer *>::iterator it = std::find(mLayers.begin(), mLayers.end(), layer);
+
+
+	if(it == mLayers.end())
+		return;
+
+	mLayers.erase(it);
+	mLayers.insert(mLayers.begin() + std::min(index, mLayers.size()), layer);
+	layer->invalidate();
+}
+
+/**
+ * Blend a layer into an area of the frame. The alpha row is expanded to one
+ * alpha byte per color byte with the layer opacity applied, so the blend
+ * itself doesn't need to know about pixels.
+ */
+void Compositor::blend(const Layer &layer, const tDirtyRect &rect)
+{
+	const size_t width = rect.x1 - rect.x0 +1;
+	uint8_t      *expanded = mAlphaRow.data();
+
+
+	for(int y=rect.y0; y<=rect.y1; y++)
+	{
+		const uint8_t *alpha = &layer.mAlpha[(y * mFrame.width()) + rect.x0];
+
+		for(size_t x=0; x<width; x++)
+		{
+			const uint8_t a = (layer.mOpacity == 255)? alpha[x] : div255((uint32_t)alpha[x] * layer.mOpacity);
+
+			expanded[(x * 3) +0] = a;
+			expanded[(x * 3) +1] = a;
+			expanded[(x * 3) +2] = a;
+		}
+
+		blendBytes((uint8_t *)(mFrame.row(y) + rect.x0), (const uint8_t *)(layer.mSurface.row(y) + rect.x0),
+				   expanded, width * sizeof(rgb24));
+	}
+}
+
+/**
+ * Recomposite the areas changed since the previous call, bottom layer first
+ * over the background color. Unchanged areas keep the previous result, so
+ * the cost follows the amount of change rather than the number of layers.
+ *
+ * @return	The flattened frame.
+ */
+const FrameBuffer& Compositor::compose()
+{
+	mComposed.swap(mDirty);
+	mDirty.clear();
+
+	for(size_t i=0; i<mLayers.size(); i++)
+	{
+		for(size_t r=0; r<mLayers[i]->mDirty.size(); r++)
+			dirtyAdd(mComposed, mLayers[i]->mDirty[r]);
+		mLayers[i]->mDirty.clear();
+	}
+
+	for(size_t r=0; r<mComposed.size(); r++)
+	{
+		const tDirtyRect &rect = mComposed[r];
+
+		for(int y=rect.y0; y<=rect.y1; y++)
+			fillPixels(mFrame.row(y) + rect.x0, rect.x1 - rect.x0 +1, mBackground);
+
+		for(size_t i=0; i<mLayers.size(); i++)
+		{
+			if(mLayers[i]->mVisible && mLayers[i]->mOpacity)
+				blend(*mLayers[i], rect);
+		}
+	}
+
+	return mFrame;
+}
+
+bool Compositor::send(FrameStream &stream)
+{
+	compose();
+	if(mComposed.empty() && stream.valid())
+		return true;
+
+	return stream.send(mFrame);
+}
@@ -0,0 +1,103 @@
+#ifndef XPM_COMPOSITOR_H_
+#define XPM_COMPOSITOR_H_
+
+
+#define COMPOSITOR_DIRTY_MAX	8		// dirty rectangles tracked before merging into their bounds
+
+
+// Inclusive pixel rectangle
+struct tDirtyRect
+{
+	int16_t				x0, y0;
+	int16_t				x1, y1;
+};
+
+
+// Compositor layer, colors drawn into surface() with a per pixel alpha plane and layer opacity
+class Layer
+{
+private:
+	friend class Compositor;
+	FrameBuffer				mSurface;
+	std::vector<uint8_t>	mAlpha;			// per pixel coverage, 0 transparent - 255 opaque
+	std::vector<tDirtyRect>	mDirty;			// changed since the last composition
+	uint8_t					mOpacity;
+	bool					mVisible;
+
+
+	Layer(int16_t width, int16_t height);
+	~Layer();
+
+	void resize(int16_t width, int16_t height);
+
+
+public:
+	// colors, drawing into it needs invalidate() or one of the alpha functions below
+	FrameBuffer& surface()							{ return mSurface; }
+	uint8_t* alpha()								{ return mAlpha.data(); }
+	int16_t width() const							{ return mSurface.width(); }
+	int16_t height() const							{ return mSurface.height(); }
+
+	// mark an area changed, recomposited with the next frame
+	void invalidate(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+	void invalidate()								{ invalidate(0, 0, width() -1, height() -1); }
+
+	// set the alpha of an area, clear() makes it transparent
+	void setAlpha(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t alpha);
+	void clear(int16_t x0, int16_t y0, int16_t x1, int16_t y1)	{ setAlpha(x0, y0, x1, y1, 0); }
+	void clear()									{ clear(0, 0, width() -1, height() -1); }
+	// pixels of the key color become transparent, all others opaque, e.g. after drawing onto a key filled area
+	void keyAlpha(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24 &key);
+
+	void setOpacity(uint8_t opacity);
+	uint8_t getOpacity() const						{ return mOpacity; }
+	void setVisible(bool visible);
+	bool getVisible() const							{ return mVisible; }
+};
+
+
+// Flattens layers over a background color into one frame, recompositing only what changed
+class Compositor
+{
+private:
+	std::vector<Layer *>	mLayers;		// bottom to top
+	FrameBuffer				mFrame;
+	rgb24					mBackground;
+	std::vector<tDirtyRect>	mDirty;			// changed by restacking, removal or the background
+	std::vector<tDirtyRect>	mComposed;		// areas recomposited by the last compose()
+	std::vector<uint8_t>	mAlphaRow;		// per byte alpha of the row being blended
+
+
+	void blend(const Layer &layer, const tDirtyRect &rect);
+
+
+public:
+	Compositor(int16_t width = 0, int16_t height = 0);
+	~Compositor();
+
+	void resize(int16_t width, int16_t height);
+	void invalidate();
+	void setBackground(const rgb24 &color);
+
+	// layers are owned by the compositor, added on top
+	Layer* addLayer();
+	void   removeLayer(Layer *layer);
+	// restack, index 0 is the bottom layer
+	void   moveLayer(Layer *layer, size_t index);
+	size_t layers() const							{ return mLayers.size(); }
+
+	// recomposite the changed areas, returns the flattened frame
+	const FrameBuffer& compose();
+	const FrameBuffer& frame() const				{ return mFrame; }
+	const std::vector<tDirtyRect>& composed() const	{ return mComposed; }
+
+	// compose and stream the frame, as delta segments when supported, nothing is sent when nothing changed
+	bool send(FrameStream &stream);
+};
+
+
+// add a rectangle to a dirty list, merging overlapping ones and everything when the list is full
+extern void dirtyAdd(std::vector<tDirtyRect> &list, const tDirtyRect &rect);
+
+
+#endif // XPM_COMPOSITOR_H_
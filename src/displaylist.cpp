@@ -0,0 +1,134 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "displaylist.h"
+
+
+//=============================================================================
+// Display list class
+//=============================================================================
+DisplayList::DisplayList()
+:	mHandle(0)
+{
+}
+DisplayList::~DisplayList()
+{
+	release();
+}
+
+/**
+ * Convert recorded packets into panel side list data, see rpcDisplayListOp.
+ *
+ * @param data	Receives Packed drawing command payload.
+ * @return	false when the list holds commands the panel can't store.
+ */
+bool DisplayList::encode(std::vector<uint8_t> &data) const
+{
+	std::string text;	// DRAWSTRING_SLOT contents
+
+
+	data.clear();
+	for(size_t offset = 0; (offset + RPCDATA_SIZE) <= mPackets.size(); offset += RPCDATA_SIZE)
+	{
+		const uint8_t *packet = &mPackets[offset];
+		const uint8_t *params = &packet[RPCC_SIZE];
+
+
+		// strings go inline with their DrawString entry
+		if((packet[0] == (uint8_t)rpcType::IO) && (packet[1] == (uint8_t)rpcIO::XferRecv))
+		{
+			tRPCXfer xfer;
+
+			memcpy(&xfer, params, sizeof(xfer));
+			if((xfer.index & RPCXFER_MASK_SLOT) != DRAWSTRING_SLOT)
+				return false;
+
+			if(!(xfer.index & RPCXFER_APPEND))
+				text.clear();
+			text.append((const char *)&params[sizeof(xfer)], xfer.size);
+			continue;
+		}
+
+		if(packet[0] != (uint8_t)rpcType::Drawing)
+			return false;
+
+		const rpcDrawing cmd  = (rpcDrawing)packet[1];
+		const uint8_t	 size = XpmRPC::packedSize(rpcType::Drawing, packet[1]);
+		if((size == 0xFF) || (cmd == rpcDrawing::GIFAnimation) || (cmd == rpcDrawing::DisplayList) ||
+			(cmd == rpcDrawing::DrawMonoBitmap) || (cmd < rpcDrawing::DrawPixel))
+			return false;
+
+		data.push_back(packet[1]);
+		data.insert(data.end(), params, params + size);
+
+		if(cmd == rpcDrawing::DrawString)
+		{
+			data.push_back((uint8_t)text.size());
+			data.insert(data.end(), text.begin(), text.end());
+		}
+
+		if(data.size() > RPCDL_MAXSIZE)
+			return false;
+	}
+
+	return true;
+}
+
+bool DisplayList::upload(uint8_t handle)
+{
+	std::vector<uint8_t>	data;
+	tRPCDisplayList			p = { (uint8_t)rpcDisplayListOp::Store, handle, DRAWSTRING_SLOT };
+
+
+	release();
+
+	if(!rpc.hasCapability(RPCCAP_DISPLAYLIST) || !handle || (handle > RPCDL_HANDLES) || !encode(data))
+		return false;
+
+	// list data through the transfer slot, one slot worth at a time
+	for(size_t offset = 0, chunk; offset < data.size(); offset += chunk)
+	{
+		chunk = std::min<size_t>(data.size() - offset, gm_IOBuffers[DRAWSTRING_SLOT].size);
+
+		if(!rpc.transfer(DRAWSTRING_SLOT, &data[offset], chunk) ||
+			!rpc.send(rpcType::Drawing, rpcDrawing::DisplayList, &p, sizeof(p)))
+			return false;
+
+		p.op = (uint8_t)rpcDisplayListOp::Append;
+	}
+
+	mHandle = handle;
+	return true;
+}
+
+void DisplayList::release()
+{
+	if(!mHandle)
+		return;
+
+	tRPCDisplayList p = { (uint8_t)rpcDisplayListOp::Free, mHandle, 0 };
+	rpc.send(rpcType::Drawing, rpcDrawing::DisplayList, &p, sizeof(p));
+
+	mHandle = 0;
+}
+
+bool DisplayList::call()
+{
+	if(mHandle)
+	{
+		tRPCDisplayList p = { (uint8_t)rpcDisplayListOp::Call, mHandle, 0 };
+		return rpc.send(rpcType::Drawing, rpcDrawing::DisplayList, &p, sizeof(p));
+	}
+
+	// older firmware, replay as Packed commands
+	const bool batch = rpc.batching();
+	if(!batch)
+		rpc.batchBegin();
+
+	bool result = rpc.replay(mPackets);
+
+	if(!batch)
+		rpc.batchEnd();
+
+	return result;
+}
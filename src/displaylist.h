@@ -0,0 +1,33 @@
+#ifndef XPM_DISPLAYLIST_H_
+#define XPM_DISPLAYLIST_H_
+
+
+// Recorded drawing commands replayed by handle, stored on the display panel when supported
+class DisplayList
+{
+private:
+	std::vector<uint8_t>	mPackets;		// recorded command packets
+	uint8_t					mHandle;		// panel side handle, 0 when replayed from the host
+
+
+	bool encode(std::vector<uint8_t> &data) const;
+
+
+public:
+	DisplayList();
+	~DisplayList();
+
+	std::vector<uint8_t>& packets()					{ return mPackets; }
+	const std::vector<uint8_t>& packets() const		{ return mPackets; }
+	bool stored() const								{ return mHandle != 0; }
+
+	// store recorded commands on the panel, false if it has to be replayed from the host
+	bool upload(uint8_t handle);
+	void release();
+
+	// draw the list, by handle when stored on the panel, else as batched commands
+	bool call();
+};
+
+
+#endif // XPM_DISPLAYLIST_H_
@@ -0,0 +1,624 @@
+#ifndef XPM_FONTDATA_H_
+#define XPM_FONTDATA_H_
+
+/*
+ * Glyph bitmaps of the display panel's built-in fonts, printable ASCII 0x20 - 0x7E.
+ * Stand-ins of the firmware's fonts, regenerate with scripts/fontdata.py from the
+ * firmware's font sources.
+ * 
+ * Each glyph is one byte per row, top row first, most significant bit is the
+ * left most pixel. Only include from fonts.cpp.
+ */
+
+
+// glyphs only resemble the firmware's, text the panel renders looks different
+#define FONTDATA_FIRMWARE	0
+
+
+// apple3x5, 4x6 pixel cell
+static constexpr uint8_t fontBitmap_apple3x5[] =
+{
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// ' '
+	0x40, 0x40, 0x40, 0x00, 0x40, 0x00,	// '!'
+	0xa0, 0xa0, 0x00, 0x00, 0x00, 0x00,	// '"'
+	0xa0, 0xe0, 0xa0, 0xe0, 0xa0, 0x00,	// '#'
+	0x60, 0xc0, 0x40, 0x60, 0xc0, 0x00,	// '$'
+	0x80, 0x20, 0x40, 0x80, 0x20, 0x00,	// '%'
+	0xc0, 0xc0, 0xe0, 0xa0, 0x60, 0x00,	// '&'
+	0x40, 0x40, 0x00, 0x00, 0x00, 0x00,	// '\''
+	0x20, 0x40, 0x40, 0x40, 0x20, 0x00,	// '('
+	0x80, 0x40, 0x40, 0x40, 0x80, 0x00,	// ')'
+	0xa0, 0x40, 0xa0, 0x00, 0x00, 0x00,	// '*'
+	0x00, 0x40, 0xe0, 0x40, 0x00, 0x00,	// '+'
+	0x00, 0x00, 0x00, 0x40, 0x80, 0x00,	// ','
+	0x00, 0x00, 0xe0, 0x00, 0x00, 0x00,	// '-'
+	0x00, 0x00, 0x00, 0x00, 0x40, 0x00,	// '.'
+	0x20, 0x20, 0x40, 0x80, 0x80, 0x00,	// '/'
+	0x60, 0xa0, 0xa0, 0xa0, 0xc0, 0x00,	// '0'
+	0x40, 0xc0, 0x40, 0x40, 0x40, 0x00,	// '1'
+	0xc0, 0x20, 0x40, 0x80, 0xe0, 0x00,	// '2'
+	0xc0, 0x20, 0x40, 0x20, 0xc0, 0x00,	// '3'
+	0xa0, 0xa0, 0xe0, 0x20, 0x20, 0x00,	// '4'
+	0xe0, 0x80, 0xc0, 0x20, 0xc0, 0x00,	// '5'
+	0x60, 0x80, 0xe0, 0xa0, 0xe0, 0x00,	// '6'
+	0xe0, 0x20, 0x40, 0x80, 0x80, 0x00,	// '7'
+	0xe0, 0xa0, 0xe0, 0xa0, 0xe0, 0x00,	// '8'
+	0xe0, 0xa0, 0xe0, 0x20, 0xc0, 0x00,	// '9'
+	0x00, 0x40, 0x00, 0x40, 0x00, 0x00,	// ':'
+	0x00, 0x40, 0x00, 0x40, 0x80, 0x00,	// ';'
+	0x20, 0x40, 0x80, 0x40, 0x20, 0x00,	// '<'
+	0x00, 0xe0, 0x00, 0xe0, 0x00, 0x00,	// '='
+	0x80, 0x40, 0x20, 0x40, 0x80, 0x00,	// '>'
+	0xe0, 0x20, 0x40, 0x00, 0x40, 0x00,	// '?'
+	0x40, 0xa0, 0xe0, 0x80, 0x60, 0x00,	// '@'
+	0x40, 0xa0, 0xe0, 0xa0, 0xa0, 0x00,	// 'A'
+	0xc0, 0xa0, 0xc0, 0xa0, 0xc0, 0x00,	// 'B'
+	0x60, 0x80, 0x80, 0x80, 0x60, 0x00,	// 'C'
+	0xc0, 0xa0, 0xa0, 0xa0, 0xc0, 0x00,	// 'D'
+	0xe0, 0x80, 0xe0, 0x80, 0xe0, 0x00,	// 'E'
+	0xe0, 0x80, 0xe0, 0x80, 0x80, 0x00,	// 'F'
+	0x60, 0x80, 0xe0, 0xa0, 0x60, 0x00,	// 'G'
+	0xa0, 0xa0, 0xe0, 0xa0, 0xa0, 0x00,	// 'H'
+	0xe0, 0x40, 0x40, 0x40, 0xe0, 0x00,	// 'I'
+	0x20, 0x20, 0x20, 0xa0, 0x40, 0x00,	// 'J'
+	0xa0, 0xa0, 0xc0, 0xa0, 0xa0, 0x00,	// 'K'
+	0x80, 0x80, 0x80, 0x80, 0xe0, 0x00,	// 'L'
+	0xa0, 0xe0, 0xe0, 0xa0, 0xa0, 0x00,	// 'M'
+	0xa0, 0xe0, 0xe0, 0xe0, 0xa0, 0x00,	// 'N'
+	0x40, 0xa0, 0xa0, 0xa0, 0x40, 0x00,	// 'O'
+	0xc0, 0xa0, 0xc0, 0x80, 0x80, 0x00,	// 'P'
+	0x40, 0xa0, 0xa0, 0xe0, 0x60, 0x00,	// 'Q'
+	0xc0, 0xa0, 0xe0, 0xc0, 0xa0, 0x00,	// 'R'
+	0x60, 0x80, 0x40, 0x20, 0xc0, 0x00,	// 'S'
+	0xe0, 0x40, 0x40, 0x40, 0x40, 0x00,	// 'T'
+	0xa0, 0xa0, 0xa0, 0xa0, 0x60, 0x00,	// 'U'
+	0xa0, 0xa0, 0xa0, 0x40, 0x40, 0x00,	// 'V'
+	0xa0, 0xa0, 0xe0, 0xe0, 0xa0, 0x00,	// 'W'
+	0xa0, 0xa0, 0x40, 0xa0, 0xa0, 0x00,	// 'X'
+	0xa0, 0xa0, 0x40, 0x40, 0x40, 0x00,	// 'Y'
+	0xe0, 0x20, 0x40, 0x80, 0xe0, 0x00,	// 'Z'
+	0xe0, 0x80, 0x80, 0x80, 0xe0, 0x00,	// '['
+	0x00, 0x80, 0x40, 0x20, 0x00, 0x00,	// '\\'
+	0xe0, 0x20, 0x20, 0x20, 0xe0, 0x00,	// ']'
+	0x40, 0xa0, 0x00, 0x00, 0x00, 0x00,	// '^'
+	0x00, 0x00, 0x00, 0x00, 0xe0, 0x00,	// '_'
+	0x80, 0x40, 0x00, 0x00, 0x00, 0x00,	// '`'
+	0x00, 0xc0, 0x60, 0xa0, 0xe0, 0x00,	// 'a'
+	0x80, 0xc0, 0xa0, 0xa0, 0xc0, 0x00,	// 'b'
+	0x00, 0x60, 0x80, 0x80, 0x60, 0x00,	// 'c'
+	0x20, 0x60, 0xa0, 0xa0, 0x60, 0x00,	// 'd'
+	0x00, 0x60, 0xa0, 0xc0, 0x60, 0x00,	// 'e'
+	0x20, 0x40, 0xe0, 0x40, 0x40, 0x00,	// 'f'
+	0x00, 0x60, 0xa0, 0x60, 0x20, 0xc0,	// 'g'
+	0x80, 0xc0, 0xa0, 0xa0, 0xa0, 0x00,	// 'h'
+	0x40, 0x00, 0x40, 0x40, 0x40, 0x00,	// 'i'
+	0x20, 0x00, 0x20, 0x20, 0xa0, 0x40,	// 'j'
+	0x80, 0xa0, 0xc0, 0xc0, 0xa0, 0x00,	// 'k'
+	0xc0, 0x40, 0x40, 0x40, 0xe0, 0x00,	// 'l'
+	0x00, 0xe0, 0xe0, 0xe0, 0xa0, 0x00,	// 'm'
+	0x00, 0xc0, 0xa0, 0xa0, 0xa0, 0x00,	// 'n'
+	0x00, 0x40, 0xa0, 0xa0, 0x40, 0x00,	// 'o'
+	0x00, 0xc0, 0xa0, 0xa0, 0xc0, 0x80,	// 'p'
+	0x00, 0x60, 0xa0, 0xa0, 0x60, 0x20,	// 'q'
+	0x00, 0x60, 0x80, 0x80, 0x80, 0x00,	// 'r'
+	0x00, 0x60, 0xc0, 0x60, 0xc0, 0x00,	// 's'
+	0x40, 0xe0, 0x40, 0x40, 0x60, 0x00,	// 't'
+	0x00, 0xa0, 0xa0, 0xa0, 0x60, 0x00,	// 'u'
+	0x00, 0xa0, 0xa0, 0xe0, 0x40, 0x00,	// 'v'
+	0x00, 0xa0, 0xe0, 0xe0, 0xe0, 0x00,	// 'w'
+	0x00, 0xa0, 0x40, 0x40, 0xa0, 0x00,	// 'x'
+	0x00, 0xa0, 0xa0, 0x60, 0x20, 0xc0,	// 'y'
+	0x00, 0xe0, 0x60, 0xc0, 0xe0, 0x00,	// 'z'
+	0x60, 0x40, 0xc0, 0x40, 0x60, 0x00,	// '{'
+	0x40, 0x40, 0x00, 0x40, 0x40, 0x00,	// '|'
+	0xc0, 0x40, 0x60, 0x40, 0xc0, 0x00,	// '}'
+	0x60, 0xc0, 0x00, 0x00, 0x00, 0x00,	// '~'
+};
+
+
+// apple5x7, 5x7 pixel cell
+static constexpr uint8_t fontBitmap_apple5x7[] =
+{
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// ' '
+	0x40, 0x40, 0x40, 0x40, 0x00, 0x40, 0x00,	// '!'
+	0xa0, 0xa0, 0xa0, 0x00, 0x00, 0x00, 0x00,	// '"'
+	0x50, 0xf0, 0x50, 0x50, 0xf0, 0x50, 0x00,	// '#'
+	0x70, 0xa0, 0x60, 0x30, 0xe0, 0x40, 0x00,	// '$'
+	0x80, 0x90, 0x20, 0x40, 0x90, 0x10, 0x00,	// '%'
+	0x40, 0xa0, 0x40, 0xa0, 0x90, 0x60, 0x00,	// '&'
+	0x40, 0x40, 0x40, 0x00, 0x00, 0x00, 0x00,	// '\''
+	0x20, 0x40, 0x40, 0x40, 0x40, 0x20, 0x00,	// '('
+	0x40, 0x20, 0x20, 0x20, 0x20, 0x40, 0x00,	// ')'
+	0x00, 0x90, 0x60, 0xf0, 0x60, 0x90, 0x00,	// '*'
+	0x00, 0x40, 0x40, 0xe0, 0x40, 0x40, 0x00,	// '+'
+	0x00, 0x00, 0x00, 0x00, 0x60, 0x40, 0x80,	// ','
+	0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00,	// '-'
+	0x00, 0x00, 0x00, 0x00, 0x60, 0x60, 0x00,	// '.'
+	0x00, 0x10, 0x20, 0x40, 0x80, 0x00, 0x00,	// '/'
+	0x40, 0xa0, 0xa0, 0xa0, 0xa0, 0x40, 0x00,	// '0'
+	0x40, 0xc0, 0x40, 0x40, 0x40, 0xe0, 0x00,	// '1'
+	0x60, 0x90, 0x10, 0x20, 0x40, 0xf0, 0x00,	// '2'
+	0xf0, 0x20, 0x60, 0x10, 0x90, 0x60, 0x00,	// '3'
+	0x20, 0x60, 0xa0, 0xf0, 0x20, 0x20, 0x00,	// '4'
+	0xf0, 0x80, 0xe0, 0x10, 0x90, 0x60, 0x00,	// '5'
+	0x60, 0x80, 0xe0, 0x90, 0x90, 0x60, 0x00,	// '6'
+	0xf0, 0x10, 0x20, 0x20, 0x40, 0x40, 0x00,	// '7'
+	0x60, 0x90, 0x60, 0x90, 0x90, 0x60, 0x00,	// '8'
+	0x60, 0x90, 0x90, 0x70, 0x10, 0x60, 0x00,	// '9'
+	0x00, 0x60, 0x60, 0x00, 0x60, 0x60, 0x00,	// ':'
+	0x00, 0x60, 0x60, 0x00, 0x60, 0x40, 0x80,	// ';'
+	0x00, 0x20, 0x40, 0x80, 0x40, 0x20, 0x00,	// '<'
+	0x00, 0x00, 0xf0, 0x00, 0xf0, 0x00, 0x00,	// '='
+	0x00, 0x80, 0x40, 0x20, 0x40, 0x80, 0x00,	// '>'
+	0x40, 0xa0, 0x20, 0x40, 0x00, 0x40, 0x00,	// '?'
+	0x60, 0x90, 0xb0, 0xb0, 0x80, 0x60, 0x00,	// '@'
+	0x60, 0x90, 0x90, 0xf0, 0x90, 0x90, 0x00,	// 'A'
+	0xe0, 0x90, 0xe0, 0x90, 0x90, 0xe0, 0x00,	// 'B'
+	0x60, 0x90, 0x80, 0x80, 0x90, 0x60, 0x00,	// 'C'
+	0xe0, 0x90, 0x90, 0x90, 0x90, 0xe0, 0x00,	// 'D'
+	0xf0, 0x80, 0xe0, 0x80, 0x80, 0xf0, 0x00,	// 'E'
+	0xf0, 0x80, 0xe0, 0x80, 0x80, 0x80, 0x00,	// 'F'
+	0x60, 0x90, 0x80, 0xb0, 0x90, 0x60, 0x00,	// 'G'
+	0x90, 0x90, 0xf0, 0x90, 0x90, 0x90, 0x00,	// 'H'
+	0xe0, 0x40, 0x40, 0x40, 0x40, 0xe0, 0x00,	// 'I'
+	0x30, 0x10, 0x10, 0x10, 0x90, 0x60, 0x00,	// 'J'
+	0x90, 0xa0, 0xc0, 0xa0, 0xa0, 0x90, 0x00,	// 'K'
+	0x80, 0x80, 0x80, 0x80, 0x80, 0xf0, 0x00,	// 'L'
+	0x90, 0xf0, 0xf0, 0x90, 0x90, 0x90, 0x00,	// 'M'
+	0x90, 0xd0, 0xd0, 0xb0, 0xb0, 0x90, 0x00,	// 'N'
+	0x60, 0x90, 0x90, 0x90, 0x90, 0x60, 0x00,	// 'O'
+	0xe0, 0x90, 0x90, 0xe0, 0x80, 0x80, 0x00,	// 'P'
+	0x60, 0x90, 0x90, 0x90, 0xd0, 0x60, 0x10,	// 'Q'
+	0xe0, 0x90, 0x90, 0xe0, 0xa0, 0x90, 0x00,	// 'R'
+	0x60, 0x90, 0x40, 0x20, 0x90, 0x60, 0x00,	// 'S'
+	0xe0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x00,	// 'T'
+	0x90, 0x90, 0x90, 0x90, 0x90, 0x60, 0x00,	// 'U'
+	0x90, 0x90, 0x90, 0x90, 0x60, 0x60, 0x00,	// 'V'
+	0x90, 0x90, 0x90, 0xf0, 0xf0, 0x90, 0x00,	// 'W'
+	0x90, 0x90, 0x60, 0x60, 0x90, 0x90, 0x00,	// 'X'
+	0xa0, 0xa0, 0xa0, 0x40, 0x40, 0x40, 0x00,	// 'Y'
+	0xf0, 0x10, 0x20, 0x40, 0x80, 0xf0, 0x00,	// 'Z'
+	0xe0, 0x80, 0x80, 0x80, 0x80, 0xe0, 0x00,	// '['
+	0x00, 0x80, 0x40, 0x20, 0x10, 0x00, 0x00,	// '\\'
+	0xe0, 0x20, 0x20, 0x20, 0x20, 0xe0, 0x00,	// ']'
+	0x40, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00,	// '^'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0,	// '_'
+	0xc0, 0x40, 0x20, 0x00, 0x00, 0x00, 0x00,	// '`'
+	0x00, 0x00, 0x70, 0x90, 0xb0, 0x50, 0x00,	// 'a'
+	0x80, 0x80, 0xe0, 0x90, 0x90, 0xe0, 0x00,	// 'b'
+	0x00, 0x00, 0x60, 0x80, 0x80, 0x60, 0x00,	// 'c'
+	0x10, 0x10, 0x70, 0x90, 0x90, 0x70, 0x00,	// 'd'
+	0x00, 0x00, 0x60, 0xf0, 0x80, 0x70, 0x00,	// 'e'
+	0x20, 0x50, 0x40, 0xe0, 0x40, 0x40, 0x00,	// 'f'
+	0x00, 0x00, 0x70, 0x90, 0x60, 0x80, 0x70,	// 'g'
+	0x80, 0x80, 0xe0, 0x90, 0x90, 0x90, 0x00,	// 'h'
+	0x40, 0x00, 0xc0, 0x40, 0x40, 0xe0, 0x00,	// 'i'
+	0x20, 0x00, 0x20, 0x20, 0x20, 0xa0, 0x40,	// 'j'
+	0x80, 0x80, 0xa0, 0xc0, 0xa0, 0x90, 0x00,	// 'k'
+	0xc0, 0x40, 0x40, 0x40, 0x40, 0xe0, 0x00,	// 'l'
+	0x00, 0x00, 0xa0, 0xf0, 0x90, 0x90, 0x00,	// 'm'
+	0x00, 0x00, 0xe0, 0x90, 0x90, 0x90, 0x00,	// 'n'
+	0x00, 0x00, 0x60, 0x90, 0x90, 0x60, 0x00,	// 'o'
+	0x00, 0x00, 0xe0, 0x90, 0x90, 0xe0, 0x80,	// 'p'
+	0x00, 0x00, 0x70, 0x90, 0x90, 0x70, 0x10,	// 'q'
+	0x00, 0x00, 0xa0, 0xd0, 0x80, 0x80, 0x00,	// 'r'
+	0x00, 0x00, 0x70, 0xc0, 0x30, 0xe0, 0x00,	// 's'
+	0x40, 0x40, 0xe0, 0x40, 0x40, 0x30, 0x00,	// 't'
+	0x00, 0x00, 0x90, 0x90, 0x90, 0x70, 0x00,	// 'u'
+	0x00, 0x00, 0xa0, 0xa0, 0xa0, 0x40, 0x00,	// 'v'
+	0x00, 0x00, 0x90, 0x90, 0xf0, 0xf0, 0x00,	// 'w'
+	0x00, 0x00, 0x90, 0x60, 0x60, 0x90, 0x00,	// 'x'
+	0x00, 0x00, 0x90, 0x90, 0x50, 0x20, 0x40,	// 'y'
+	0x00, 0x00, 0xf0, 0x20, 0x40, 0xf0, 0x00,	// 'z'
+	0x20, 0x40, 0xc0, 0x40, 0x40, 0x20, 0x00,	// '{'
+	0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x00,	// '|'
+	0x40, 0x20, 0x30, 0x20, 0x20, 0x40, 0x00,	// '}'
+	0x50, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x00,	// '~'
+};
+
+
+// apple6x10, 6x10 pixel cell
+static constexpr uint8_t fontBitmap_apple6x10[] =
+{
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// ' '
+	0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00,	// '!'
+	0x00, 0x28, 0x28, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '"'
+	0x00, 0x28, 0x28, 0x7c, 0x50, 0xf8, 0x50, 0x50, 0x00, 0x00,	// '#'
+	0x00, 0x10, 0x3c, 0x50, 0x70, 0x1c, 0x14, 0x78, 0x10, 0x00,	// '$'
+	0x00, 0xe0, 0xa0, 0xe8, 0x30, 0x5c, 0x14, 0x1c, 0x00, 0x00,	// '%'
+	0x00, 0x38, 0x20, 0x30, 0x54, 0x4c, 0x48, 0x34, 0x00, 0x00,	// '&'
+	0x00, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '\''
+	0x10, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x10, 0x00,	// '('
+	0x20, 0x20, 0x10, 0x10, 0x10, 0x10, 0x10, 0x20, 0x20, 0x00,	// ')'
+	0x00, 0x54, 0x38, 0x38, 0x54, 0x00, 0x00, 0x00, 0x00, 0x00,	// '*'
+	0x00, 0x00, 0x10, 0x10, 0x7c, 0x10, 0x10, 0x00, 0x00, 0x00,	// '+'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x20, 0x20,	// ','
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x00,	// '-'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00,	// '.'
+	0x00, 0x04, 0x08, 0x08, 0x10, 0x10, 0x20, 0x20, 0x40, 0x00,	// '/'
+	0x00, 0x38, 0x44, 0x44, 0x54, 0x44, 0x44, 0x38, 0x00, 0x00,	// '0'
+	0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00,	// '1'
+	0x00, 0x38, 0x44, 0x04, 0x0c, 0x18, 0x20, 0x7c, 0x00, 0x00,	// '2'
+	0x00, 0x38, 0x44, 0x04, 0x38, 0x04, 0x44, 0x38, 0x00, 0x00,	// '3'
+	0x00, 0x08, 0x18, 0x28, 0x68, 0x7c, 0x08, 0x08, 0x00, 0x00,	// '4'
+	0x00, 0x78, 0x40, 0x78, 0x04, 0x04, 0x04, 0x78, 0x00, 0x00,	// '5'
+	0x00, 0x3c, 0x60, 0x40, 0x78, 0x44, 0x44, 0x38, 0x00, 0x00,	// '6'
+	0x00, 0x7c, 0x0c, 0x08, 0x08, 0x10, 0x10, 0x20, 0x00, 0x00,	// '7'
+	0x00, 0x38, 0x44, 0x44, 0x38, 0x44, 0x44, 0x38, 0x00, 0x00,	// '8'
+	0x00, 0x38, 0x44, 0x44, 0x3c, 0x04, 0x0c, 0x78, 0x00, 0x00,	// '9'
+	0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00,	// ':'
+	0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20, 0x20, 0x20,	// ';'
+	0x00, 0x00, 0x04, 0x38, 0x40, 0x38, 0x04, 0x00, 0x00, 0x00,	// '<'
+	0x00, 0x00, 0x00, 0xf8, 0x00, 0xf8, 0x00, 0x00, 0x00, 0x00,	// '='
+	0x00, 0x00, 0x40, 0x38, 0x04, 0x38, 0x40, 0x00, 0x00, 0x00,	// '>'
+	0x00, 0x78, 0x08, 0x10, 0x20, 0x20, 0x00, 0x20, 0x00, 0x00,	// '?'
+	0x00, 0x38, 0x24, 0x5c, 0x54, 0x54, 0x54, 0x5c, 0x20, 0x18,	// '@'
+	0x00, 0x10, 0x10, 0x28, 0x28, 0x38, 0x44, 0x44, 0x00, 0x00,	// 'A'
+	0x00, 0x78, 0x44, 0x44, 0x78, 0x44, 0x44, 0x78, 0x00, 0x00,	// 'B'
+	0x00, 0x3c, 0x64, 0x40, 0x40, 0x40, 0x64, 0x3c, 0x00, 0x00,	// 'C'
+	0x00, 0x78, 0x4c, 0x44, 0x44, 0x44, 0x4c, 0x78, 0x00, 0x00,	// 'D'
+	0x00, 0x7c, 0x40, 0x40, 0x7c, 0x40, 0x40, 0x7c, 0x00, 0x00,	// 'E'
+	0x00, 0x7c, 0x40, 0x40, 0x7c, 0x40, 0x40, 0x40, 0x00, 0x00,	// 'F'
+	0x00, 0x38, 0x64, 0x40, 0x4c, 0x44, 0x64, 0x3c, 0x00, 0x00,	// 'G'
+	0x00, 0x44, 0x44, 0x44, 0x7c, 0x44, 0x44, 0x44, 0x00, 0x00,	// 'H'
+	0x00, 0x7c, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00,	// 'I'
+	0x00, 0x38, 0x08, 0x08, 0x08, 0x08, 0x48, 0x30, 0x00, 0x00,	// 'J'
+	0x00, 0x44, 0x48, 0x50, 0x60, 0x50, 0x48, 0x44, 0x00, 0x00,	// 'K'
+	0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7c, 0x00, 0x00,	// 'L'
+	0x00, 0x44, 0x6c, 0x6c, 0x54, 0x44, 0x44, 0x44, 0x00, 0x00,	// 'M'
+	0x00, 0x44, 0x64, 0x64, 0x54, 0x4c, 0x4c, 0x44, 0x00, 0x00,	// 'N'
+	0x00, 0x38, 0x44, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00,	// 'O'
+	0x00, 0x78, 0x44, 0x44, 0x78, 0x40, 0x40, 0x40, 0x00, 0x00,	// 'P'
+	0x00, 0x38, 0x44, 0x44, 0x44, 0x44, 0x44, 0x38, 0x0c, 0x00,	// 'Q'
+	0x00, 0x78, 0x44, 0x44, 0x78, 0x4c, 0x44, 0x40, 0x00, 0x00,	// 'R'
+	0x00, 0x38, 0x44, 0x40, 0x38, 0x04, 0x44, 0x38, 0x00, 0x00,	// 'S'
+	0x00, 0x7c, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00,	// 'T'
+	0x00, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00,	// 'U'
+	0x00, 0x44, 0x44, 0x28, 0x28, 0x28, 0x10, 0x10, 0x00, 0x00,	// 'V'
+	0x00, 0x84, 0xb4, 0xb4, 0x78, 0x48, 0x48, 0x48, 0x00, 0x00,	// 'W'
+	0x00, 0x44, 0x28, 0x28, 0x10, 0x28, 0x28, 0x44, 0x00, 0x00,	// 'X'
+	0x00, 0x44, 0x28, 0x28, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00,	// 'Y'
+	0x00, 0x7c, 0x08, 0x08, 0x10, 0x20, 0x20, 0x7c, 0x00, 0x00,	// 'Z'
+	0x30, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x30, 0x00,	// '['
+	0x00, 0x40, 0x20, 0x20, 0x10, 0x10, 0x08, 0x08, 0x04, 0x00,	// '\\'
+	0x30, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x30, 0x00,	// ']'
+	0x00, 0x20, 0x50, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '^'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc,	// '_'
+	0x40, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '`'
+	0x00, 0x00, 0x00, 0x78, 0x04, 0x3c, 0x44, 0x7c, 0x00, 0x00,	// 'a'
+	0x40, 0x40, 0x40, 0x78, 0x44, 0x44, 0x44, 0x78, 0x00, 0x00,	// 'b'
+	0x00, 0x00, 0x00, 0x38, 0x40, 0x40, 0x40, 0x38, 0x00, 0x00,	// 'c'
+	0x04, 0x04, 0x04, 0x3c, 0x44, 0x44, 0x44, 0x3c, 0x00, 0x00,	// 'd'
+	0x00, 0x00, 0x00, 0x38, 0x44, 0x7c, 0x40, 0x3c, 0x00, 0x00,	// 'e'
+	0x18, 0x20, 0x20, 0x78, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00,	// 'f'
+	0x00, 0x00, 0x00, 0x3c, 0x44, 0x44, 0x44, 0x3c, 0x04, 0x38,	// 'g'
+	0x40, 0x40, 0x40, 0x58, 0x64, 0x44, 0x44, 0x44, 0x00, 0x00,	// 'h'
+	0x10, 0x00, 0x00, 0x30, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00,	// 'i'
+	0x10, 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x60,	// 'j'
+	0x40, 0x40, 0x40, 0x48, 0x50, 0x70, 0x48, 0x44, 0x00, 0x00,	// 'k'
+	0xe0, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x18, 0x00, 0x00,	// 'l'
+	0x00, 0x00, 0x00, 0x7c, 0x54, 0x54, 0x54, 0x54, 0x00, 0x00,	// 'm'
+	0x00, 0x00, 0x00, 0x58, 0x64, 0x44, 0x44, 0x44, 0x00, 0x00,	// 'n'
+	0x00, 0x00, 0x00, 0x38, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00,	// 'o'
+	0x00, 0x00, 0x00, 0x78, 0x44, 0x44, 0x44, 0x78, 0x40, 0x40,	// 'p'
+	0x00, 0x00, 0x00, 0x3c, 0x44, 0x44, 0x44, 0x3c, 0x04, 0x04,	// 'q'
+	0x00, 0x00, 0x00, 0x3c, 0x24, 0x20, 0x20, 0x20, 0x00, 0x00,	// 'r'
+	0x00, 0x00, 0x00, 0x3c, 0x40, 0x3c, 0x04, 0x78, 0x00, 0x00,	// 's'
+	0x00, 0x20, 0x20, 0x78, 0x20, 0x20, 0x20, 0x38, 0x00, 0x00,	// 't'
+	0x00, 0x00, 0x00, 0x44, 0x44, 0x44, 0x44, 0x3c, 0x00, 0x00,	// 'u'
+	0x00, 0x00, 0x00, 0x44, 0x28, 0x28, 0x28, 0x10, 0x00, 0x00,	// 'v'
+	0x00, 0x00, 0x00, 0x44, 0x54, 0x28, 0x28, 0x28, 0x00, 0x00,	// 'w'
+	0x00, 0x00, 0x00, 0x6c, 0x28, 0x10, 0x28, 0x6c, 0x00, 0x00,	// 'x'
+	0x00, 0x00, 0x00, 0x44, 0x28, 0x28, 0x10, 0x10, 0x10, 0x60,	// 'y'
+	0x00, 0x00, 0x00, 0x7c, 0x08, 0x10, 0x20, 0x7c, 0x00, 0x00,	// 'z'
+	0x18, 0x10, 0x10, 0x10, 0x60, 0x10, 0x10, 0x10, 0x18, 0x00,	// '{'
+	0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,	// '|'
+	0x30, 0x10, 0x10, 0x10, 0x0c, 0x10, 0x10, 0x10, 0x30, 0x00,	// '}'
+	0x00, 0x00, 0x00, 0x00, 0x70, 0x0c, 0x00, 0x00, 0x00, 0x00,	// '~'
+};
+
+
+// apple8x13, 8x13 pixel cell
+static constexpr uint8_t fontBitmap_apple8x13[] =
+{
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// ' '
+	0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00,	// '!'
+	0x00, 0x28, 0x28, 0x28, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '"'
+	0x12, 0x12, 0x16, 0x7f, 0x24, 0x24, 0xfe, 0x28, 0x48, 0x48, 0x00, 0x00, 0x00,	// '#'
+	0x00, 0x08, 0x3e, 0x49, 0x48, 0x38, 0x0e, 0x09, 0x49, 0x3e, 0x08, 0x08, 0x00,	// '$'
+	0x00, 0x60, 0x90, 0x90, 0x62, 0x1c, 0x66, 0x09, 0x09, 0x06, 0x00, 0x00, 0x00,	// '%'
+	0x00, 0x1c, 0x20, 0x20, 0x30, 0x49, 0x4d, 0x45, 0x62, 0x3d, 0x00, 0x00, 0x00,	// '&'
+	0x00, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '\''
+	0x08, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x08, 0x08, 0x04, 0x00, 0x00,	// '('
+	0x10, 0x10, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x10, 0x10, 0x30, 0x00, 0x00,	// ')'
+	0x00, 0x08, 0x49, 0x3e, 0x1c, 0x6b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '*'
+	0x00, 0x00, 0x10, 0x10, 0x10, 0xfe, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00,	// '+'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x10, 0x20, 0x00,	// ','
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '-'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00,	// '.'
+	0x00, 0x02, 0x04, 0x04, 0x08, 0x08, 0x18, 0x10, 0x10, 0x20, 0x20, 0x40, 0x00,	// '/'
+	0x00, 0x1c, 0x22, 0x41, 0x41, 0x49, 0x41, 0x41, 0x22, 0x1c, 0x00, 0x00, 0x00,	// '0'
+	0x00, 0x38, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x3e, 0x00, 0x00, 0x00,	// '1'
+	0x00, 0x3e, 0x43, 0x01, 0x01, 0x02, 0x0c, 0x18, 0x20, 0x7f, 0x00, 0x00, 0x00,	// '2'
+	0x00, 0x3e, 0x41, 0x01, 0x03, 0x1c, 0x03, 0x01, 0x43, 0x3e, 0x00, 0x00, 0x00,	// '3'
+	0x00, 0x06, 0x0a, 0x1a, 0x12, 0x22, 0x42, 0x7f, 0x02, 0x02, 0x00, 0x00, 0x00,	// '4'
+	0x00, 0x7e, 0x40, 0x40, 0x7c, 0x03, 0x01, 0x01, 0x43, 0x3c, 0x00, 0x00, 0x00,	// '5'
+	0x00, 0x1e, 0x21, 0x40, 0x5e, 0x63, 0x41, 0x41, 0x23, 0x1e, 0x00, 0x00, 0x00,	// '6'
+	0x00, 0x7f, 0x02, 0x02, 0x04, 0x04, 0x08, 0x18, 0x10, 0x20, 0x00, 0x00, 0x00,	// '7'
+	0x00, 0x3e, 0x41, 0x41, 0x41, 0x3e, 0x63, 0x41, 0x61, 0x3e, 0x00, 0x00, 0x00,	// '8'
+	0x00, 0x3c, 0x62, 0x41, 0x41, 0x63, 0x3d, 0x01, 0x42, 0x3c, 0x00, 0x00, 0x00,	// '9'
+	0x00, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00,	// ':'
+	0x00, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00, 0x18, 0x18, 0x10, 0x20, 0x00,	// ';'
+	0x00, 0x00, 0x00, 0x01, 0x0e, 0x70, 0x70, 0x0e, 0x01, 0x00, 0x00, 0x00, 0x00,	// '<'
+	0x00, 0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00,	// '='
+	0x00, 0x00, 0x00, 0x40, 0x38, 0x07, 0x07, 0x38, 0x40, 0x00, 0x00, 0x00, 0x00,	// '>'
+	0x00, 0x38, 0x44, 0x04, 0x08, 0x10, 0x10, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00,	// '?'
+	0x00, 0x1e, 0x33, 0x21, 0x47, 0x49, 0x49, 0x49, 0x47, 0x20, 0x30, 0x1e, 0x00,	// '@'
+	0x00, 0x08, 0x14, 0x14, 0x14, 0x22, 0x22, 0x3e, 0x63, 0x41, 0x00, 0x00, 0x00,	// 'A'
+	0x00, 0x7e, 0x41, 0x41, 0x41, 0x7e, 0x41, 0x41, 0x41, 0x7e, 0x00, 0x00, 0x00,	// 'B'
+	0x00, 0x1e, 0x21, 0x40, 0x40, 0x40, 0x40, 0x40, 0x21, 0x1e, 0x00, 0x00, 0x00,	// 'C'
+	0x00, 0x7c, 0x42, 0x41, 0x41, 0x41, 0x41, 0x41, 0x42, 0x7c, 0x00, 0x00, 0x00,	// 'D'
+	0x00, 0x7f, 0x40, 0x40, 0x40, 0x7f, 0x40, 0x40, 0x40, 0x7f, 0x00, 0x00, 0x00,	// 'E'
+	0x00, 0x7f, 0x40, 0x40, 0x40, 0x7f, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00,	// 'F'
+	0x00, 0x1e, 0x21, 0x40, 0x40, 0x43, 0x41, 0x41, 0x21, 0x1e, 0x00, 0x00, 0x00,	// 'G'
+	0x00, 0x41, 0x41, 0x41, 0x41, 0x7f, 0x41, 0x41, 0x41, 0x41, 0x00, 0x00, 0x00,	// 'H'
+	0x00, 0x7c, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00, 0x00,	// 'I'
+	0x00, 0x1c, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x44, 0x38, 0x00, 0x00, 0x00,	// 'J'
+	0x00, 0x42, 0x44, 0x48, 0x50, 0x70, 0x48, 0x44, 0x44, 0x42, 0x00, 0x00, 0x00,	// 'K'
+	0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7f, 0x00, 0x00, 0x00,	// 'L'
+	0x00, 0x63, 0x63, 0x55, 0x55, 0x55, 0x49, 0x41, 0x41, 0x41, 0x00, 0x00, 0x00,	// 'M'
+	0x00, 0x61, 0x61, 0x51, 0x51, 0x49, 0x45, 0x45, 0x43, 0x43, 0x00, 0x00, 0x00,	// 'N'
+	0x00, 0x1c, 0x22, 0x41, 0x41, 0x41, 0x41, 0x41, 0x22, 0x1c, 0x00, 0x00, 0x00,	// 'O'
+	0x00, 0x7e, 0x43, 0x41, 0x41, 0x43, 0x7e, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00,	// 'P'
+	0x00, 0x1c, 0x22, 0x41, 0x41, 0x41, 0x41, 0x41, 0x23, 0x1e, 0x06, 0x02, 0x00,	// 'Q'
+	0x00, 0x7e, 0x43, 0x41, 0x41, 0x7e, 0x42, 0x41, 0x41, 0x40, 0x00, 0x00, 0x00,	// 'R'
+	0x00, 0x3e, 0x61, 0x40, 0x60, 0x3e, 0x03, 0x01, 0x43, 0x3e, 0x00, 0x00, 0x00,	// 'S'
+	0x00, 0xfe, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00,	// 'T'
+	0x00, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x3e, 0x00, 0x00, 0x00,	// 'U'
+	0x00, 0x41, 0x63, 0x22, 0x22, 0x22, 0x14, 0x14, 0x14, 0x08, 0x00, 0x00, 0x00,	// 'V'
+	0x00, 0x81, 0x81, 0x81, 0x5a, 0x5a, 0x5a, 0x66, 0x66, 0x66, 0x00, 0x00, 0x00,	// 'W'
+	0x00, 0x63, 0x22, 0x14, 0x1c, 0x08, 0x14, 0x36, 0x22, 0x41, 0x00, 0x00, 0x00,	// 'X'
+	0x00, 0x82, 0x44, 0x28, 0x28, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00,	// 'Y'
+	0x00, 0x7f, 0x03, 0x06, 0x04, 0x08, 0x10, 0x30, 0x60, 0x7f, 0x00, 0x00, 0x00,	// 'Z'
+	0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1c, 0x00, 0x00,	// '['
+	0x00, 0x40, 0x20, 0x20, 0x10, 0x10, 0x18, 0x08, 0x08, 0x04, 0x04, 0x02, 0x00,	// '\\'
+	0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x38, 0x00, 0x00,	// ']'
+	0x00, 0x10, 0x28, 0x44, 0xc6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '^'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,	// '_'
+	0x10, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '`'
+	0x00, 0x00, 0x00, 0x1c, 0x22, 0x02, 0x3e, 0x42, 0x46, 0x3a, 0x00, 0x00, 0x00,	// 'a'
+	0x40, 0x40, 0x40, 0x7c, 0x66, 0x42, 0x42, 0x42, 0x66, 0x7c, 0x00, 0x00, 0x00,	// 'b'
+	0x00, 0x00, 0x00, 0x1c, 0x22, 0x40, 0x40, 0x40, 0x22, 0x1c, 0x00, 0x00, 0x00,	// 'c'
+	0x02, 0x02, 0x02, 0x3e, 0x66, 0x42, 0x42, 0x42, 0x66, 0x3e, 0x00, 0x00, 0x00,	// 'd'
+	0x00, 0x00, 0x00, 0x3c, 0x66, 0x42, 0x7e, 0x40, 0x62, 0x3c, 0x00, 0x00, 0x00,	// 'e'
+	0x10, 0x10, 0x10, 0x7c, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00,	// 'f'
+	0x00, 0x00, 0x00, 0x3e, 0x66, 0x42, 0x42, 0x42, 0x66, 0x3a, 0x02, 0x22, 0x1c,	// 'g'
+	0x40, 0x40, 0x40, 0x5c, 0x62, 0x42, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00,	// 'h'
+	0x00, 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00, 0x00,	// 'i'
+	0x00, 0x00, 0x00, 0x38, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x70,	// 'j'
+	0x40, 0x40, 0x40, 0x44, 0x48, 0x50, 0x70, 0x48, 0x44, 0x42, 0x00, 0x00, 0x00,	// 'k'
+	0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x0e, 0x00, 0x00, 0x00,	// 'l'
+	0x00, 0x00, 0x00, 0x7f, 0x49, 0x49, 0x49, 0x49, 0x49, 0x49, 0x00, 0x00, 0x00,	// 'm'
+	0x00, 0x00, 0x00, 0x5c, 0x62, 0x42, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00,	// 'n'
+	0x00, 0x00, 0x00, 0x3c, 0x66, 0x42, 0x42, 0x42, 0x66, 0x3c, 0x00, 0x00, 0x00,	// 'o'
+	0x00, 0x00, 0x00, 0x7c, 0x66, 0x42, 0x42, 0x42, 0x66, 0x7c, 0x40, 0x40, 0x40,	// 'p'
+	0x00, 0x00, 0x00, 0x3e, 0x66, 0x42, 0x42, 0x42, 0x66, 0x3a, 0x02, 0x02, 0x02,	// 'q'
+	0x00, 0x00, 0x00, 0x3c, 0x32, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00,	// 'r'
+	0x00, 0x00, 0x00, 0x3c, 0x42, 0x40, 0x3c, 0x02, 0x42, 0x3c, 0x00, 0x00, 0x00,	// 's'
+	0x00, 0x10, 0x10, 0x7e, 0x10, 0x10, 0x10, 0x10, 0x10, 0x0e, 0x00, 0x00, 0x00,	// 't'
+	0x00, 0x00, 0x00, 0x42, 0x42, 0x42, 0x42, 0x42, 0x46, 0x3a, 0x00, 0x00, 0x00,	// 'u'
+	0x00, 0x00, 0x00, 0x42, 0x66, 0x24, 0x24, 0x3c, 0x18, 0x18, 0x00, 0x00, 0x00,	// 'v'
+	0x00, 0x00, 0x00, 0x81, 0x81, 0x5a, 0x5a, 0x5a, 0x24, 0x24, 0x00, 0x00, 0x00,	// 'w'
+	0x00, 0x00, 0x00, 0x66, 0x24, 0x18, 0x18, 0x18, 0x24, 0x66, 0x00, 0x00, 0x00,	// 'x'
+	0x00, 0x00, 0x00, 0x42, 0x22, 0x24, 0x24, 0x14, 0x18, 0x08, 0x08, 0x10, 0x30,	// 'y'
+	0x00, 0x00, 0x00, 0x7e, 0x02, 0x04, 0x18, 0x20, 0x40, 0x7e, 0x00, 0x00, 0x00,	// 'z'
+	0x10, 0x10, 0x10, 0x10, 0x60, 0x10, 0x10, 0x10, 0x10, 0x10, 0x0c, 0x00, 0x00,	// '{'
+	0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00,	// '|'
+	0x10, 0x10, 0x10, 0x10, 0x0c, 0x10, 0x10, 0x10, 0x10, 0x10, 0x60, 0x00, 0x00,	// '}'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x39, 0x46, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '~'
+};
+
+
+// gohufont6x11, 6x11 pixel cell
+static constexpr uint8_t fontBitmap_gohufont6x11[] =
+{
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// ' '
+	0x00, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00,	// '!'
+	0x00, 0x00, 0x28, 0x28, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '"'
+	0x00, 0x00, 0x28, 0x28, 0x7c, 0x50, 0xf8, 0x50, 0x50, 0x00, 0x00,	// '#'
+	0x00, 0x00, 0x10, 0x3c, 0x50, 0x70, 0x1c, 0x14, 0x78, 0x10, 0x00,	// '$'
+	0x00, 0x00, 0xe0, 0xa0, 0xe8, 0x30, 0x5c, 0x14, 0x1c, 0x00, 0x00,	// '%'
+	0x00, 0x00, 0x38, 0x20, 0x30, 0x54, 0x4c, 0x48, 0x34, 0x00, 0x00,	// '&'
+	0x00, 0x00, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '\''
+	0x00, 0x10, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x10, 0x00,	// '('
+	0x00, 0x20, 0x20, 0x10, 0x10, 0x10, 0x10, 0x10, 0x20, 0x20, 0x00,	// ')'
+	0x00, 0x00, 0x54, 0x38, 0x38, 0x54, 0x00, 0x00, 0x00, 0x00, 0x00,	// '*'
+	0x00, 0x00, 0x00, 0x10, 0x10, 0x7c, 0x10, 0x10, 0x00, 0x00, 0x00,	// '+'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x20, 0x20,	// ','
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x00,	// '-'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00,	// '.'
+	0x00, 0x00, 0x04, 0x08, 0x08, 0x10, 0x10, 0x20, 0x20, 0x40, 0x00,	// '/'
+	0x00, 0x00, 0x38, 0x44, 0x44, 0x54, 0x44, 0x44, 0x38, 0x00, 0x00,	// '0'
+	0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00,	// '1'
+	0x00, 0x00, 0x38, 0x44, 0x04, 0x0c, 0x18, 0x20, 0x7c, 0x00, 0x00,	// '2'
+	0x00, 0x00, 0x38, 0x44, 0x04, 0x38, 0x04, 0x44, 0x38, 0x00, 0x00,	// '3'
+	0x00, 0x00, 0x08, 0x18, 0x28, 0x68, 0x7c, 0x08, 0x08, 0x00, 0x00,	// '4'
+	0x00, 0x00, 0x78, 0x40, 0x78, 0x04, 0x04, 0x04, 0x78, 0x00, 0x00,	// '5'
+	0x00, 0x00, 0x3c, 0x60, 0x40, 0x78, 0x44, 0x44, 0x38, 0x00, 0x00,	// '6'
+	0x00, 0x00, 0x7c, 0x0c, 0x08, 0x08, 0x10, 0x10, 0x20, 0x00, 0x00,	// '7'
+	0x00, 0x00, 0x38, 0x44, 0x44, 0x38, 0x44, 0x44, 0x38, 0x00, 0x00,	// '8'
+	0x00, 0x00, 0x38, 0x44, 0x44, 0x3c, 0x04, 0x0c, 0x78, 0x00, 0x00,	// '9'
+	0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00,	// ':'
+	0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20, 0x20, 0x20,	// ';'
+	0x00, 0x00, 0x00, 0x04, 0x38, 0x40, 0x38, 0x04, 0x00, 0x00, 0x00,	// '<'
+	0x00, 0x00, 0x00, 0x00, 0xf8, 0x00, 0xf8, 0x00, 0x00, 0x00, 0x00,	// '='
+	0x00, 0x00, 0x00, 0x40, 0x38, 0x04, 0x38, 0x40, 0x00, 0x00, 0x00,	// '>'
+	0x00, 0x00, 0x78, 0x08, 0x10, 0x20, 0x20, 0x00, 0x20, 0x00, 0x00,	// '?'
+	0x00, 0x00, 0x38, 0x24, 0x5c, 0x54, 0x54, 0x54, 0x5c, 0x20, 0x18,	// '@'
+	0x00, 0x00, 0x10, 0x10, 0x28, 0x28, 0x38, 0x44, 0x44, 0x00, 0x00,	// 'A'
+	0x00, 0x00, 0x78, 0x44, 0x44, 0x78, 0x44, 0x44, 0x78, 0x00, 0x00,	// 'B'
+	0x00, 0x00, 0x3c, 0x64, 0x40, 0x40, 0x40, 0x64, 0x3c, 0x00, 0x00,	// 'C'
+	0x00, 0x00, 0x78, 0x4c, 0x44, 0x44, 0x44, 0x4c, 0x78, 0x00, 0x00,	// 'D'
+	0x00, 0x00, 0x7c, 0x40, 0x40, 0x7c, 0x40, 0x40, 0x7c, 0x00, 0x00,	// 'E'
+	0x00, 0x00, 0x7c, 0x40, 0x40, 0x7c, 0x40, 0x40, 0x40, 0x00, 0x00,	// 'F'
+	0x00, 0x00, 0x38, 0x64, 0x40, 0x4c, 0x44, 0x64, 0x3c, 0x00, 0x00,	// 'G'
+	0x00, 0x00, 0x44, 0x44, 0x44, 0x7c, 0x44, 0x44, 0x44, 0x00, 0x00,	// 'H'
+	0x00, 0x00, 0x7c, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00,	// 'I'
+	0x00, 0x00, 0x38, 0x08, 0x08, 0x08, 0x08, 0x48, 0x30, 0x00, 0x00,	// 'J'
+	0x00, 0x00, 0x44, 0x48, 0x50, 0x60, 0x50, 0x48, 0x44, 0x00, 0x00,	// 'K'
+	0x00, 0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7c, 0x00, 0x00,	// 'L'
+	0x00, 0x00, 0x44, 0x6c, 0x6c, 0x54, 0x44, 0x44, 0x44, 0x00, 0x00,	// 'M'
+	0x00, 0x00, 0x44, 0x64, 0x64, 0x54, 0x4c, 0x4c, 0x44, 0x00, 0x00,	// 'N'
+	0x00, 0x00, 0x38, 0x44, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00,	// 'O'
+	0x00, 0x00, 0x78, 0x44, 0x44, 0x78, 0x40, 0x40, 0x40, 0x00, 0x00,	// 'P'
+	0x00, 0x00, 0x38, 0x44, 0x44, 0x44, 0x44, 0x44, 0x38, 0x0c, 0x00,	// 'Q'
+	0x00, 0x00, 0x78, 0x44, 0x44, 0x78, 0x4c, 0x44, 0x40, 0x00, 0x00,	// 'R'
+	0x00, 0x00, 0x38, 0x44, 0x40, 0x38, 0x04, 0x44, 0x38, 0x00, 0x00,	// 'S'
+	0x00, 0x00, 0x7c, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00,	// 'T'
+	0x00, 0x00, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00,	// 'U'
+	0x00, 0x00, 0x44, 0x44, 0x28, 0x28, 0x28, 0x10, 0x10, 0x00, 0x00,	// 'V'
+	0x00, 0x00, 0x84, 0xb4, 0xb4, 0x78, 0x48, 0x48, 0x48, 0x00, 0x00,	// 'W'
+	0x00, 0x00, 0x44, 0x28, 0x28, 0x10, 0x28, 0x28, 0x44, 0x00, 0x00,	// 'X'
+	0x00, 0x00, 0x44, 0x28, 0x28, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00,	// 'Y'
+	0x00, 0x00, 0x7c, 0x08, 0x08, 0x10, 0x20, 0x20, 0x7c, 0x00, 0x00,	// 'Z'
+	0x00, 0x30, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x30, 0x00,	// '['
+	0x00, 0x00, 0x40, 0x20, 0x20, 0x10, 0x10, 0x08, 0x08, 0x04, 0x00,	// '\\'
+	0x00, 0x30, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x30, 0x00,	// ']'
+	0x00, 0x00, 0x20, 0x50, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '^'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc,	// '_'
+	0x00, 0x40, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '`'
+	0x00, 0x00, 0x00, 0x00, 0x78, 0x04, 0x3c, 0x44, 0x7c, 0x00, 0x00,	// 'a'
+	0x00, 0x40, 0x40, 0x40, 0x78, 0x44, 0x44, 0x44, 0x78, 0x00, 0x00,	// 'b'
+	0x00, 0x00, 0x00, 0x00, 0x38, 0x40, 0x40, 0x40, 0x38, 0x00, 0x00,	// 'c'
+	0x00, 0x04, 0x04, 0x04, 0x3c, 0x44, 0x44, 0x44, 0x3c, 0x00, 0x00,	// 'd'
+	0x00, 0x00, 0x00, 0x00, 0x38, 0x44, 0x7c, 0x40, 0x3c, 0x00, 0x00,	// 'e'
+	0x00, 0x18, 0x20, 0x20, 0x78, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00,	// 'f'
+	0x00, 0x00, 0x00, 0x00, 0x3c, 0x44, 0x44, 0x44, 0x3c, 0x04, 0x38,	// 'g'
+	0x00, 0x40, 0x40, 0x40, 0x58, 0x64, 0x44, 0x44, 0x44, 0x00, 0x00,	// 'h'
+	0x00, 0x10, 0x00, 0x00, 0x30, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00,	// 'i'
+	0x00, 0x10, 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x60,	// 'j'
+	0x00, 0x40, 0x40, 0x40, 0x48, 0x50, 0x70, 0x48, 0x44, 0x00, 0x00,	// 'k'
+	0x00, 0xe0, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x18, 0x00, 0x00,	// 'l'
+	0x00, 0x00, 0x00, 0x00, 0x7c, 0x54, 0x54, 0x54, 0x54, 0x00, 0x00,	// 'm'
+	0x00, 0x00, 0x00, 0x00, 0x58, 0x64, 0x44, 0x44, 0x44, 0x00, 0x00,	// 'n'
+	0x00, 0x00, 0x00, 0x00, 0x38, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00,	// 'o'
+	0x00, 0x00, 0x00, 0x00, 0x78, 0x44, 0x44, 0x44, 0x78, 0x40, 0x40,	// 'p'
+	0x00, 0x00, 0x00, 0x00, 0x3c, 0x44, 0x44, 0x44, 0x3c, 0x04, 0x04,	// 'q'
+	0x00, 0x00, 0x00, 0x00, 0x3c, 0x24, 0x20, 0x20, 0x20, 0x00, 0x00,	// 'r'
+	0x00, 0x00, 0x00, 0x00, 0x3c, 0x40, 0x3c, 0x04, 0x78, 0x00, 0x00,	// 's'
+	0x00, 0x00, 0x20, 0x20, 0x78, 0x20, 0x20, 0x20, 0x38, 0x00, 0x00,	// 't'
+	0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x44, 0x44, 0x3c, 0x00, 0x00,	// 'u'
+	0x00, 0x00, 0x00, 0x00, 0x44, 0x28, 0x28, 0x28, 0x10, 0x00, 0x00,	// 'v'
+	0x00, 0x00, 0x00, 0x00, 0x44, 0x54, 0x28, 0x28, 0x28, 0x00, 0x00,	// 'w'
+	0x00, 0x00, 0x00, 0x00, 0x6c, 0x28, 0x10, 0x28, 0x6c, 0x00, 0x00,	// 'x'
+	0x00, 0x00, 0x00, 0x00, 0x44, 0x28, 0x28, 0x10, 0x10, 0x10, 0x60,	// 'y'
+	0x00, 0x00, 0x00, 0x00, 0x7c, 0x08, 0x10, 0x20, 0x7c, 0x00, 0x00,	// 'z'
+	0x00, 0x18, 0x10, 0x10, 0x10, 0x60, 0x10, 0x10, 0x10, 0x18, 0x00,	// '{'
+	0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,	// '|'
+	0x00, 0x30, 0x10, 0x10, 0x10, 0x0c, 0x10, 0x10, 0x10, 0x30, 0x00,	// '}'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x0c, 0x00, 0x00, 0x00, 0x00,	// '~'
+};
+
+
+// gohufont6x11b, 6x11 pixel cell
+static constexpr uint8_t fontBitmap_gohufont6x11b[] =
+{
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// ' '
+	0x00, 0x00, 0x30, 0x30, 0x30, 0x30, 0x30, 0x00, 0x30, 0x00, 0x00,	// '!'
+	0x00, 0x00, 0x50, 0x50, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '"'
+	0x00, 0x00, 0x28, 0x28, 0x7c, 0x68, 0xf8, 0x50, 0x50, 0x00, 0x00,	// '#'
+	0x00, 0x00, 0x10, 0x3c, 0x50, 0x78, 0x3c, 0x14, 0x78, 0x10, 0x00,	// '$'
+	0x00, 0x00, 0xe0, 0xa0, 0xec, 0x30, 0xdc, 0x14, 0x1c, 0x00, 0x00,	// '%'
+	0x00, 0x00, 0x38, 0x30, 0x10, 0x3c, 0x6c, 0x6c, 0x3c, 0x00, 0x00,	// '&'
+	0x00, 0x00, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '\''
+	0x00, 0x08, 0x10, 0x30, 0x30, 0x30, 0x30, 0x30, 0x10, 0x08, 0x00,	// '('
+	0x00, 0x20, 0x10, 0x18, 0x18, 0x18, 0x18, 0x18, 0x10, 0x20, 0x00,	// ')'
+	0x00, 0x00, 0x54, 0x38, 0x38, 0x54, 0x00, 0x00, 0x00, 0x00, 0x00,	// '*'
+	0x00, 0x00, 0x00, 0x20, 0x20, 0xf8, 0x20, 0x20, 0x00, 0x00, 0x00,	// '+'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x60, 0x00,	// ','
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x00, 0x00, 0x00, 0x00,	// '-'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00,	// '.'
+	0x00, 0x00, 0x04, 0x08, 0x08, 0x10, 0x10, 0x20, 0x20, 0x40, 0x00,	// '/'
+	0x00, 0x00, 0x38, 0x6c, 0x6c, 0x7c, 0x6c, 0x6c, 0x38, 0x00, 0x00,	// '0'
+	0x00, 0x00, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0x7c, 0x00, 0x00,	// '1'
+	0x00, 0x00, 0x78, 0x0c, 0x0c, 0x18, 0x30, 0x60, 0x7c, 0x00, 0x00,	// '2'
+	0x00, 0x00, 0x7c, 0x0c, 0x30, 0x0c, 0x0c, 0x0c, 0x78, 0x00, 0x00,	// '3'
+	0x00, 0x00, 0x18, 0x18, 0x38, 0x58, 0x7c, 0x18, 0x18, 0x00, 0x00,	// '4'
+	0x00, 0x00, 0x7c, 0x60, 0x78, 0x0c, 0x0c, 0x0c, 0x78, 0x00, 0x00,	// '5'
+	0x00, 0x00, 0x3c, 0x60, 0x78, 0x6c, 0x6c, 0x6c, 0x38, 0x00, 0x00,	// '6'
+	0x00, 0x00, 0x7c, 0x04, 0x08, 0x08, 0x10, 0x10, 0x20, 0x00, 0x00,	// '7'
+	0x00, 0x00, 0x38, 0x6c, 0x6c, 0x10, 0x6c, 0x6c, 0x38, 0x00, 0x00,	// '8'
+	0x00, 0x00, 0x38, 0x6c, 0x6c, 0x6c, 0x3c, 0x0c, 0x78, 0x00, 0x00,	// '9'
+	0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x30, 0x30, 0x00, 0x00,	// ':'
+	0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x30, 0x30, 0x60, 0x00,	// ';'
+	0x00, 0x00, 0x00, 0x04, 0x38, 0x40, 0x38, 0x04, 0x00, 0x00, 0x00,	// '<'
+	0x00, 0x00, 0x00, 0x00, 0x7c, 0x00, 0x7c, 0x00, 0x00, 0x00, 0x00,	// '='
+	0x00, 0x00, 0x00, 0x40, 0x38, 0x04, 0x38, 0x40, 0x00, 0x00, 0x00,	// '>'
+	0x00, 0x00, 0x38, 0x58, 0x18, 0x20, 0x30, 0x00, 0x30, 0x00, 0x00,	// '?'
+	0x00, 0x00, 0x38, 0x44, 0x9c, 0xa4, 0xa4, 0x9c, 0x40, 0x3c, 0x00,	// '@'
+	0x00, 0x00, 0x10, 0x38, 0x28, 0x28, 0x38, 0x6c, 0x6c, 0x00, 0x00,	// 'A'
+	0x00, 0x00, 0x78, 0x6c, 0x6c, 0x70, 0x6c, 0x6c, 0x78, 0x00, 0x00,	// 'B'
+	0x00, 0x00, 0x3c, 0x60, 0x60, 0x60, 0x60, 0x60, 0x3c, 0x00, 0x00,	// 'C'
+	0x00, 0x00, 0x78, 0x6c, 0x6c, 0x6c, 0x6c, 0x6c, 0x78, 0x00, 0x00,	// 'D'
+	0x00, 0x00, 0x7c, 0x60, 0x60, 0x7c, 0x60, 0x60, 0x7c, 0x00, 0x00,	// 'E'
+	0x00, 0x00, 0x7c, 0x60, 0x60, 0x7c, 0x60, 0x60, 0x60, 0x00, 0x00,	// 'F'
+	0x00, 0x00, 0x3c, 0x60, 0x60, 0x6c, 0x6c, 0x6c, 0x3c, 0x00, 0x00,	// 'G'
+	0x00, 0x00, 0x6c, 0x6c, 0x6c, 0x7c, 0x6c, 0x6c, 0x6c, 0x00, 0x00,	// 'H'
+	0x00, 0x00, 0x78, 0x30, 0x30, 0x30, 0x30, 0x30, 0x78, 0x00, 0x00,	// 'I'
+	0x00, 0x00, 0x3c, 0x0c, 0x0c, 0x0c, 0x0c, 0x4c, 0x38, 0x00, 0x00,	// 'J'
+	0x00, 0x00, 0x64, 0x6c, 0x78, 0x78, 0x6c, 0x64, 0x64, 0x00, 0x00,	// 'K'
+	0x00, 0x00, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x7c, 0x00, 0x00,	// 'L'
+	0x00, 0x00, 0x6c, 0x7c, 0x7c, 0x7c, 0x6c, 0x6c, 0x6c, 0x00, 0x00,	// 'M'
+	0x00, 0x00, 0x6c, 0x6c, 0x7c, 0x7c, 0x7c, 0x6c, 0x6c, 0x00, 0x00,	// 'N'
+	0x00, 0x00, 0x38, 0x6c, 0x6c, 0x6c, 0x6c, 0x6c, 0x38, 0x00, 0x00,	// 'O'
+	0x00, 0x00, 0x78, 0x6c, 0x6c, 0x6c, 0x78, 0x60, 0x60, 0x00, 0x00,	// 'P'
+	0x00, 0x00, 0x38, 0x6c, 0x6c, 0x6c, 0x6c, 0x6c, 0x38, 0x08, 0x00,	// 'Q'
+	0x00, 0x00, 0x78, 0x6c, 0x6c, 0x70, 0x68, 0x6c, 0x64, 0x00, 0x00,	// 'R'
+	0x00, 0x00, 0x38, 0x64, 0x60, 0x38, 0x0c, 0x4c, 0x38, 0x00, 0x00,	// 'S'
+	0x00, 0x00, 0xfc, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x00, 0x00,	// 'T'
+	0x00, 0x00, 0x6c, 0x6c, 0x6c, 0x6c, 0x6c, 0x6c, 0x38, 0x00, 0x00,	// 'U'
+	0x00, 0x00, 0x6c, 0x6c, 0x28, 0x28, 0x28, 0x38, 0x38, 0x00, 0x00,	// 'V'
+	0x00, 0x00, 0x84, 0xb4, 0xb4, 0xfc, 0x78, 0x48, 0x48, 0x00, 0x00,	// 'W'
+	0x00, 0x00, 0x6c, 0x28, 0x38, 0x10, 0x38, 0x28, 0x6c, 0x00, 0x00,	// 'X'
+	0x00, 0x00, 0xcc, 0x48, 0x78, 0x30, 0x30, 0x30, 0x30, 0x00, 0x00,	// 'Y'
+	0x00, 0x00, 0x7c, 0x0c, 0x18, 0x10, 0x30, 0x60, 0x7c, 0x00, 0x00,	// 'Z'
+	0x00, 0x38, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x38, 0x00,	// '['
+	0x00, 0x00, 0x40, 0x20, 0x20, 0x10, 0x10, 0x08, 0x08, 0x04, 0x00,	// '\\'
+	0x00, 0x38, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x38, 0x00,	// ']'
+	0x00, 0x00, 0x20, 0x50, 0xd8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '^'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc,	// '_'
+	0x00, 0x60, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// '`'
+	0x00, 0x00, 0x00, 0x00, 0x38, 0x0c, 0x7c, 0x6c, 0x7c, 0x00, 0x00,	// 'a'
+	0x00, 0x60, 0x60, 0x60, 0x78, 0x6c, 0x6c, 0x6c, 0x78, 0x00, 0x00,	// 'b'
+	0x00, 0x00, 0x00, 0x00, 0x3c, 0x60, 0x60, 0x60, 0x3c, 0x00, 0x00,	// 'c'
+	0x00, 0x0c, 0x0c, 0x0c, 0x3c, 0x6c, 0x6c, 0x6c, 0x3c, 0x00, 0x00,	// 'd'
+	0x00, 0x00, 0x00, 0x00, 0x38, 0x6c, 0x7c, 0x60, 0x3c, 0x00, 0x00,	// 'e'
+	0x00, 0x1c, 0x30, 0x30, 0x7c, 0x30, 0x30, 0x30, 0x30, 0x00, 0x00,	// 'f'
+	0x00, 0x00, 0x00, 0x00, 0x3c, 0x6c, 0x6c, 0x6c, 0x3c, 0x0c, 0x38,	// 'g'
+	0x00, 0x60, 0x60, 0x60, 0x7c, 0x6c, 0x6c, 0x6c, 0x6c, 0x00, 0x00,	// 'h'
+	0x00, 0x30, 0x30, 0x00, 0x70, 0x30, 0x30, 0x30, 0xfc, 0x00, 0x00,	// 'i'
+	0x00, 0x18, 0x18, 0x00, 0x38, 0x18, 0x18, 0x18, 0x18, 0x18, 0x70,	// 'j'
+	0x00, 0x60, 0x60, 0x60, 0x68, 0x70, 0x78, 0x68, 0x6c, 0x00, 0x00,	// 'k'
+	0x00, 0x70, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x1c, 0x00, 0x00,	// 'l'
+	0x00, 0x00, 0x00, 0x00, 0x7c, 0x54, 0x54, 0x54, 0x54, 0x00, 0x00,	// 'm'
+	0x00, 0x00, 0x00, 0x00, 0x7c, 0x6c, 0x6c, 0x6c, 0x6c, 0x00, 0x00,	// 'n'
+	0x00, 0x00, 0x00, 0x00, 0x38, 0x6c, 0x6c, 0x6c, 0x38, 0x00, 0x00,	// 'o'
+	0x00, 0x00, 0x00, 0x00, 0x78, 0x6c, 0x6c, 0x6c, 0x78, 0x60, 0x60,	// 'p'
+	0x00, 0x00, 0x00, 0x00, 0x3c, 0x6c, 0x6c, 0x6c, 0x3c, 0x0c, 0x0c,	// 'q'
+	0x00, 0x00, 0x00, 0x00, 0x78, 0x60, 0x60, 0x60, 0x60, 0x00, 0x00,	// 'r'
+	0x00, 0x00, 0x00, 0x00, 0x3c, 0x60, 0x38, 0x0c, 0x7c, 0x00, 0x00,	// 's'
+	0x00, 0x00, 0x30, 0x30, 0x7c, 0x30, 0x30, 0x30, 0x3c, 0x00, 0x00,	// 't'
+	0x00, 0x00, 0x00, 0x00, 0x6c, 0x6c, 0x6c, 0x6c, 0x7c, 0x00, 0x00,	// 'u'
+	0x00, 0x00, 0x00, 0x00, 0x6c, 0x6c, 0x28, 0x28, 0x38, 0x00, 0x00,	// 'v'
+	0x00, 0x00, 0x00, 0x00, 0x44, 0x54, 0x7c, 0x28, 0x28, 0x00, 0x00,	// 'w'
+	0x00, 0x00, 0x00, 0x00, 0x6c, 0x38, 0x10, 0x28, 0x6c, 0x00, 0x00,	// 'x'
+	0x00, 0x00, 0x00, 0x00, 0x6c, 0x28, 0x28, 0x38, 0x10, 0x30, 0x60,	// 'y'
+	0x00, 0x00, 0x00, 0x00, 0x7c, 0x08, 0x10, 0x20, 0x7c, 0x00, 0x00,	// 'z'
+	0x00, 0x38, 0x30, 0x30, 0x30, 0xc0, 0x30, 0x30, 0x30, 0x38, 0x00,	// '{'
+	0x00, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,	// '|'
+	0x00, 0x70, 0x30, 0x30, 0x30, 0x0c, 0x30, 0x30, 0x30, 0x70, 0x00,	// '}'
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x0c, 0x00, 0x00, 0x00, 0x00,	// '~'
+};
+
+
+#endif // XPM_FONTDATA_H_
@@ -0,0 +1,276 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "fonts.h"
+#include "fontdata.h"
+
+
+//-----------------------------------------------------------------------------
+// Glyph metrics, computed from the bitmaps at compile time
+//-----------------------------------------------------------------------------
+struct tGlyphTable
+{
+	tGlyphMetrics	glyph[FONT_GLYPHCOUNT];
+};
+
+// all set pixel columns of a glyph
+static constexpr uint8_t glyphColumns(const uint8_t *rows, size_t count)
+{
+	return count? (rows[0] | glyphColumns(rows +1, count -1)) : 0;
+}
+
+// first row with set pixels, count if none
+static constexpr uint8_t glyphTop(const uint8_t *rows, size_t count, size_t i = 0)
+{
+	return ((i >= count) || rows[i])? i : glyphTop(rows, count, i +1);
+}
+
+// row after the last one with set pixels
+static constexpr uint8_t glyphBottom(const uint8_t *rows, size_t i)
+{
+	return (!i || rows[i -1])? i : glyphBottom(rows, i -1);
+}
+
+// first set column of a mask, MSB leftmost
+static constexpr uint8_t columnFirst(uint8_t mask, uint8_t i = 0)
+{
+	return ((i >= 8) || (mask & (0x80 >> i)))? i : columnFirst(mask, i +1);
+}
+
+// column after the last set one of a mask
+static constexpr uint8_t columnEnd(uint8_t mask, uint8_t i = 8)
+{
+	return (!i || (mask & (0x80 >> (i -1))))? i : columnEnd(mask, i -1);
+}
+
+// the panel's fonts are fixed pitch, every glyph advances by the cell width
+static constexpr tGlyphMetrics glyphMetrics(const uint8_t *rows, uint8_t width, uint8_t height)
+{
+	return glyphColumns(rows, height)?
+		tGlyphMetrics{	columnFirst(glyphColumns(rows, height)),
+						(uint8_t)(columnEnd(glyphColumns(rows, height)) - columnFirst(glyphColumns(rows, height))),
+						glyphTop(rows, height),
+						(uint8_t)(glyphBottom(rows, height) - glyphTop(rows, height)),
+						width } :
+		tGlyphMetrics{	0, 0, 0, 0, width };
+}
+
+template<size_t... G>
+static constexpr tGlyphTable glyphTable(const uint8_t *bitmap, uint8_t width, uint8_t height, tIndices<G...>)
+{
+	return tGlyphTable{ { glyphMetrics(&bitmap[G * height], width, height)... } };
+}
+
+// ink stays within the character cell
+static constexpr bool glyphsFit(const tGlyphTable &table, uint8_t width, uint8_t height, size_t i = 0)
+{
+	return (i >= FONT_GLYPHCOUNT) ||
+		(((table.glyph[i].left + table.glyph[i].width) <= width) &&
+		 ((table.glyph[i].top + table.glyph[i].height) <= height) &&
+		 glyphsFit(table, width, height, i +1));
+}
+
+#define FONT_METRICS(_name, _width, _height) \
+	static constexpr tGlyphTable fontMetrics_##_name = glyphTable(fontBitmap_##_name, _width, _height, tMakeIndices<FONT_GLYPHCOUNT>::type()); \
+	static_assert(sizeof(fontBitmap_##_name) == (FONT_GLYPHCOUNT * _height), #_name " glyph count"); \
+	static_assert(glyphsFit(fontMetrics_##_name, _width, _height), #_name " glyphs exceed their cell")
+
+FONT_METRICS(apple3x5,		4,  6);
+FONT_METRICS(apple5x7,		5,  7);
+FONT_METRICS(apple6x10,		6, 10);
+FONT_METRICS(apple8x13,		8, 13);
+FONT_METRICS(gohufont6x11,	6, 11);
+FONT_METRICS(gohufont6x11b,	6, 11);
+
+
+
+//-----------------------------------------------------------------------------
+// Glyph span atlases, computed from the bitmaps at compile time
+//-----------------------------------------------------------------------------
+template<size_t N>
+struct tSpanTable
+{
+	tGlyphSpan		span[N];
+	uint16_t		first[FONT_GLYPHCOUNT +1];
+};
+
+// set bits of a mask
+static constexpr uint8_t bitCount(uint8_t mask)
+{
+	return mask? ((mask & 1) + bitCount(mask >> 1)) : 0;
+}
+
+// first column of every run of set pixels in a row, MSB leftmost
+static constexpr uint8_t runStarts(uint8_t bits)
+{
+	return (uint8_t)(bits & ~(bits >> 1));
+}
+
+// spans of rows lo to hi -1, halving the range keeps the recursion shallow
+static constexpr size_t spanCount(const uint8_t *rows, size_t lo, size_t hi)
+{
+	return (hi <= lo)? 0 :
+		((hi - lo) == 1)? bitCount(runStarts(rows[lo])) :
+		(spanCount(rows, lo, (lo + hi) / 2) + spanCount(rows, (lo + hi) / 2, hi));
+}
+
+// spans of the rows before row n within lo to hi -1
+static constexpr size_t spansBefore(const uint8_t *rows, size_t n, size_t lo, size_t hi)
+{
+	return (n <= lo)? 0 :
+		(n >= hi)? spanCount(rows, lo, hi) :
+		(spansBefore(rows, n, lo, (lo + hi) / 2) + spansBefore(rows, n, (lo + hi) / 2, hi));
+}
+
+// row holding span k of rows lo to hi -1
+static constexpr size_t spanRow(const uint8_t *rows, size_t k, size_t lo, size_t hi)
+{
+	return ((hi - lo) == 1)? lo :
+		(k < spanCount(rows, lo, (lo + hi) / 2))? spanRow(rows, k, lo, (lo + hi) / 2) :
+		spanRow(rows, k - spanCount(rows, lo, (lo + hi) / 2), (lo + hi) / 2, hi);
+}
+
+// column of the set bit n of a mask, counted from the left
+static constexpr uint8_t bitColumn(uint8_t mask, size_t n, uint8_t c = 0)
+{
+	return (c >= 8)? 8 :
+		!(mask & (0x80 >> c))? bitColumn(mask, n, c +1) :
+		n? bitColumn(mask, n -1, c +1) : c;
+}
+
+// set pixels from column c on
+static constexpr uint8_t runLength(uint8_t bits, uint8_t c)
+{
+	return ((c < 8) && (bits & (0x80 >> c)))? (1 + runLength(bits, c +1)) : 0;
+}
+
+static constexpr tGlyphSpan rowSpan(uint8_t bits, uint8_t row, uint8_t c)
+{
+	return tGlyphSpan{ row, c, runLength(bits, c) };
+}
+
+// span k of a font, row is relative to its glyph
+static constexpr tGlyphSpan glyphSpan(const uint8_t *bitmap, uint8_t height, size_t k, size_t row)
+{
+	return rowSpan(bitmap[row], (uint8_t)(row % height),
+				   bitColumn(runStarts(bitmap[row]), k - spansBefore(bitmap, row, 0, FONT_GLYPHCOUNT * height)));
+}
+
+template<size_t N, size_t... S, size_t... G>
+static constexpr tSpanTable<N> spanTable(const uint8_t *bitmap, uint8_t height, tIndices<S...>, tIndices<G...>)
+{
+	return tSpanTable<N>{	{ glyphSpan(bitmap, height, S, spanRow(bitmap, S, 0, FONT_GLYPHCOUNT * height))... },
+							{ (uint16_t)spansBefore(bitmap, G * height, 0, FONT_GLYPHCOUNT * height)... } };
+}
+
+#define FONT_SPANS(_name, _height) \
+	static constexpr size_t fontSpanCount_##_name = spanCount(fontBitmap_##_name, 0, FONT_GLYPHCOUNT * _height); \
+	static_assert((fontSpanCount_##_name > 0) && (fontSpanCount_##_name <= UINT16_MAX), #_name " span count"); \
+	static constexpr tSpanTable<fontSpanCount_##_name> fontSpans_##_name = spanTable<fontSpanCount_##_name>(fontBitmap_##_name, _height, \
+		tMakeIndices<fontSpanCount_##_name>::type(), tMakeIndices<FONT_GLYPHCOUNT +1>::type())
+
+FONT_SPANS(apple3x5,		 6);
+FONT_SPANS(apple5x7,		 7);
+FONT_SPANS(apple6x10,		10);
+FONT_SPANS(apple8x13,		13);
+FONT_SPANS(gohufont6x11,	11);
+FONT_SPANS(gohufont6x11b,	11);
+
+
+
+//=============================================================================
+// Display panel built-in fonts
+//=============================================================================
+
+static const tBitmapFont fonts[FONT_MAXINDEX +1] =
+{
+	// name, width, height, bitmap, metrics
+	{ "apple3x5",		4,  6, fontBitmap_apple3x5,		fontMetrics_apple3x5.glyph },		// font3x5
+	{ "apple5x7",		5,  7, fontBitmap_apple5x7,		fontMetrics_apple5x7.glyph },		// font5x7
+	{ "apple6x10",		6, 10, fontBitmap_apple6x10,	fontMetrics_apple6x10.glyph },		// font6x10
+	{ "apple8x13",		8, 13, fontBitmap_apple8x13,	fontMetrics_apple8x13.glyph },		// font8x13
+	{ "gohufont6x11",	6, 11, fontBitmap_gohufont6x11,	fontMetrics_gohufont6x11.glyph },	// gohufont11
+	{ "gohufont6x11b",	6, 11, fontBitmap_gohufont6x11b, fontMetrics_gohufont6x11b.glyph }	// gohufont11b
+};
+
+// span lists of the fonts above, in the same order
+static const tGlyphAtlas atlases[FONT_MAXINDEX +1] =
+{
+	// spans, first
+	{ fontSpans_apple3x5.span,		fontSpans_apple3x5.first },		// font3x5
+	{ fontSpans_apple5x7.span,		fontSpans_apple5x7.first },		// font5x7
+	{ fontSpans_apple6x10.span,		fontSpans_apple6x10.first },	// font6x10
+	{ fontSpans_apple8x13.span,		fontSpans_apple8x13.first },	// font8x13
+	{ fontSpans_gohufont6x11.span,	fontSpans_gohufont6x11.first },	// gohufont11
+	{ fontSpans_gohufont6x11b.span,	fontSpans_gohufont6x11b.first }	// gohufont11b
+};
+
+
+
+/**
+ * Lookup host copy of a panel font.
+ * 
+ * @return	Font description, or NULL for an unknown font.
+ */
+const tBitmapFont* getBitmapFont(fontChoices font)
+{
+	if((size_t)font > FONT_MAXINDEX)
+		return NULL;
+
+	return &fonts[font];
+}
+
+bool bitmapFontsExact()
+{
+	return FONTDATA_FIRMWARE;
+}
+
+const tGlyphAtlas* getGlyphAtlas(const tBitmapFont *font)
+{
+	if((font < fonts) || (font > &fonts[FONT_MAXINDEX]))
+		return NULL;
+
+	return &atlases[font - fonts];
+}
+
+/**
+ * Measure text the way drawString() lays it out, each '\n' starts a new
+ * line at the left edge, so the width is that of the widest line.
+ *
+ * @return	Width and height in pixels, 0,0 for empty text.
+ */
+Point2I measureText(const tBitmapFont &font, const char *text)
+{
+	int		width = 0, line = 0;
+	int		lines = 1;
+
+
+	if(!*text)
+		return Point2I();
+
+	for(; *text; text++)
+	{
+		if(*text == '\n')
+		{
+			width = std::max(width, line);
+			line  = 0;
+			lines++;
+			continue;
+		}
+
+		line += font.metric(*text).advance;
+	}
+
+	return Point2I((int16_t)std::max(width, line), (int16_t)(lines * font.height));
+}
+
+Point2I measureText(fontChoices font, const char *text)
+{
+	const tBitmapFont *desc = getBitmapFont(font);
+
+
+	if(!desc)
+		return Point2I();
+
+	return measureText(*desc, text);
+}
@@ -0,0 +1,73 @@
+#ifndef XPM_FONTS_H_
+#define XPM_FONTS_H_
+
+
+#define FONT_FIRSTCHAR		0x20	// first glyph in font bitmaps, space
+#define FONT_LASTCHAR		0x7E	// last glyph in font bitmaps, tilde
+#define FONT_GLYPHCOUNT		(FONT_LASTCHAR - FONT_FIRSTCHAR +1)
+
+
+// Glyph ink box within its character cell and pen advance
+struct tGlyphMetrics
+{
+	uint8_t			 left;		// first column with set pixels
+	uint8_t			 width;		// columns from left to the last with set pixels, 0 for blank glyphs
+	uint8_t			 top;		// first row with set pixels
+	uint8_t			 height;	// rows from top to the last with set pixels
+	uint8_t			 advance;	// pen movement to the next glyph in pixels
+};
+
+
+// Run of set pixels within a glyph row
+struct tGlyphSpan
+{
+	uint8_t			 row;
+	uint8_t			 x;			// first column
+	uint8_t			 length;	// pixels
+};
+
+// Glyphs of a font as span lists, drawing a glyph is a few fills instead of testing every bit
+struct tGlyphAtlas
+{
+	const tGlyphSpan *spans;	// all glyphs' spans, top row first
+	const uint16_t	*first;		// first span per glyph, FONT_GLYPHCOUNT +1 entries, the last one ends the list
+};
+
+
+// Host copy of a display panel built-in bitmap font
+struct tBitmapFont
+{
+	const char		*name;		// panel side font name
+	uint8_t			 width;		// character cell width in pixels (max 8)
+	uint8_t			 height;	// character cell height in pixels
+	const uint8_t	*bitmap;	// glyph rows, one byte per row MSB first, height bytes per glyph
+	const tGlyphMetrics *metrics;	// per glyph, FONT_GLYPHCOUNT entries
+
+
+	static uint8_t index(char chr)
+	{
+		uint8_t c = (uint8_t)chr;
+		if((c < FONT_FIRSTCHAR) || (c > FONT_LASTCHAR))
+			c = '?';
+		return c - FONT_FIRSTCHAR;
+	}
+
+	// retrieve rows of a glyph, unprintable characters map to '?'
+	const uint8_t* glyph(char chr) const			{ return &bitmap[index(chr) * height]; }
+	const tGlyphMetrics& metric(char chr) const		{ return metrics[index(chr)]; }
+};
+
+
+extern const tBitmapFont* getBitmapFont(fontChoices font);
+// the bitmaps are the firmware's own rather than stand-ins, see fontdata.h
+extern bool bitmapFontsExact();
+// span atlas of a font from getBitmapFont(), generated at compile time
+extern const tGlyphAtlas* getGlyphAtlas(const tBitmapFont *font);
+
+// size of the cells text covers as drawn by drawString(), widest line by line count
+extern Point2I measureText(const tBitmapFont &font, const char *text);
+// same for a font choice, 0,0 for an unknown font
+extern Point2I measureText(fontChoices font, const char *text);
+
+
+#endif // XPM_FONTS_H_
@@ -0,0 +1,757 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "fonts.h"
+#include "framebuffer.h"
+#include "sprite.h"
+
+
+//=============================================================================
+// Host side framebuffer class
+//=============================================================================
+FrameBuffer::FrameBuffer(int16_t width, int16_t height)
+:	mWidth(0),
+	mHeight(0),
+	mFont(getBitmapFont(font5x7)),
+	mAtlas(getGlyphAtlas(mFont))
+{
+	resize(width, height);
+}
+FrameBuffer::~FrameBuffer()
+{
+}
+
+bool FrameBuffer::resize(int16_t width, int16_t height)
+{
+	if((width < 0) || (height < 0))
+		return false;
+
+	mWidth  = width;
+	mHeight = height;
+	mPixels.assign((size_t)width * (size_t)height, rgb24(0, 0, 0));
+
+	resetClip();
+	return true;
+}
+
+void FrameBuffer::copy(const FrameBuffer &src)
+{
+	if((src.mWidth != mWidth) || (src.mHeight != mHeight))
+		resize(src.mWidth, src.mHeight);
+
+	memcpy((uint8_t *)mPixels.data(), (const uint8_t *)src.mPixels.data(), mPixels.size() * sizeof(rgb24));
+}
+
+void FrameBuffer::swap(FrameBuffer &other)
+{
+	std::swap(mPixels, other.mPixels);
+	std::swap(mWidth,  other.mWidth);
+	std::swap(mHeight, other.mHeight);
+	std::swap(mClip,   other.mClip);
+}
+
+rgb24 FrameBuffer::getPixel(int16_t x, int16_t y) const
+{
+	if((x < 0) || (y < 0) || (x >= mWidth) || (y >= mHeight))
+		return rgb24(0, 0, 0);
+
+	return mPixels[(y * mWidth) + x];
+}
+
+void FrameBuffer::setClip(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+	if(x0 > x1)	std::swap(x0, x1);
+	if(y0 > y1)	std::swap(y0, y1);
+
+	mClip.x0 = std::max<int16_t>(x0, 0);
+	mClip.y0 = std::max<int16_t>(y0, 0);
+	mClip.x1 = std::min<int16_t>(x1, mWidth  -1);
+	mClip.y1 = std::min<int16_t>(y1, mHeight -1);
+}
+
+
+//-----------------------------------------------------------------------------
+// Rasterizer internals
+//-----------------------------------------------------------------------------
+
+/**
+ * Fill a run of pixels with a single color.
+ */
+void fillPixels(rgb24 *dest, size_t count, const rgb24& color)
+{
+	if(!count)
+		return;
+
+	// grey levels are a plain byte fill
+	if((color.red == color.green) && (color.green == color.blue))
+	{
+		memset((uint8_t *)dest, color.red, count * sizeof(rgb24));
+		return;
+	}
+
+	// otherwise keep doubling the already filled part
+	size_t done = 1, chunk;
+
+	dest[0] = color;
+	while(done < count)
+	{
+		chunk = (done < (count - done))? done : (count - done);
+		memcpy((uint8_t *)&dest[done], (const uint8_t *)dest, chunk * sizeof(rgb24));
+		done += chunk;
+	}
+}
+
+// clipped horizontal span fill, inclusive end points in any order
+void FrameBuffer::span(int x0, int x1, int y, const rgb24& color)
+{
+	if((y < mClip.y0) || (y > mClip.y1))
+		return;
+
+	if(x0 > x1)			std::swap(x0, x1);
+	if(x0 < mClip.x0)	x0 = mClip.x0;
+	if(x1 > mClip.x1)	x1 = mClip.x1;
+	if(x0 > x1)
+		return;
+
+	fillPixels(&mPixels[(y * mWidth) + x0], (size_t)(x1 - x0 +1), color);
+}
+
+// circle outline quadrants, corners bitmask 1 = top left, 2 = top right, 4 = bottom right, 8 = bottom left.
+// right side quadrants are offset by dx and bottom side quadrants by dy from the passed center.
+void FrameBuffer::circleQuadrants(int x0, int y0, int radius, uint8_t corners, int dx, int dy, const rgb24& color)
+{
+	int f     = 1 - radius;
+	int ddF_x = 1;
+	int ddF_y = -2 * radius;
+	int x     = 0;
+	int y     = radius;
+
+
+	while(x < y)
+	{
+		if(f >= 0)
+		{
+			y--;
+			ddF_y += 2;
+			f     += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f     += ddF_x;
+
+		if(corners & 0x01)	{ plot(x0 - y,      y0 - x,      color); plot(x0 - x,      y0 - y,      color); }
+		if(corners & 0x02)	{ plot(x0 + dx + x, y0 - y,      color); plot(x0 + dx + y, y0 - x,      color); }
+		if(corners & 0x04)	{ plot(x0 + dx + x, y0 + dy + y, color); plot(x0 + dx + y, y0 + dy + x, color); }
+		if(corners & 0x08)	{ plot(x0 - y,      y0 + dy + x, color); plot(x0 - x,      y0 + dy + y, color); }
+	}
+}
+
+// filled circle halves as horizontal spans, sides bitmask 1 = top, 2 = bottom. spans are stretched
+// by dx and the bottom half is offset by dy, rows between the two centers are left to the caller.
+void FrameBuffer::circleSpans(int x0, int y0, int radius, uint8_t sides, int dx, int dy, const rgb24& color)
+{
+	int f     = 1 - radius;
+	int ddF_x = 1;
+	int ddF_y = -2 * radius;
+	int x     = 0;
+	int y     = radius;
+
+
+	if(sides & 0x01)	span(x0, x0 + dx, y0 - radius,      color);
+	if(sides & 0x02)	span(x0, x0 + dx, y0 + dy + radius, color);
+
+	while(x < y)
+	{
+		if(f >= 0)
+		{
+			y--;
+			ddF_y += 2;
+			f     += ddF_y;
+		}
+		x++;
+		ddF_x += 2;
+		f     += ddF_x;
+
+		if(sides & 0x01)
+		{
+			span(x0 - x, x0 + dx + x, y0 - y, color);
+			span(x0 - y, x0 + dx + y, y0 - x, color);
+		}
+		if(sides & 0x02)
+		{
+			span(x0 - x, x0 + dx + x, y0 + dy + y, color);
+			span(x0 - y, x0 + dx + y, y0 + dy + x, color);
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+// Drawing functions
+//-----------------------------------------------------------------------------
+
+void FrameBuffer::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24& color)
+{
+	// test for more optimized draw operations
+	if(x0 == x1)
+	{
+		drawFastVLine(x0, y0, y1, color);
+		return;
+	} else
+	if(y0 == y1)
+	{
+		span(x0, x1, y0, color);
+		return;
+	}
+
+	// Bresenham
+	int dx  =  abs(x1 - x0), sx = (x0 < x1)? 1 : -1;
+	int dy  = -abs(y1 - y0), sy = (y0 < y1)? 1 : -1;
+	int err = dx + dy, e2;
+	int x   = x0, y = y0;
+
+	for(;;)
+	{
+		plot(x, y, color);
+		if((x == x1) && (y == y1))
+			break;
+
+		e2 = 2 * err;
+		if(e2 >= dy)	{ err += dy; x += sx; }
+		if(e2 <= dx)	{ err += dx; y += sy; }
+	}
+}
+
+void FrameBuffer::drawFastVLine(int16_t x, int16_t y0, int16_t y1, const rgb24& color)
+{
+	if((x < mClip.x0) || (x > mClip.x1))
+		return;
+
+	if(y0 > y1)			std::swap(y0, y1);
+	if(y0 < mClip.y0)	y0 = mClip.y0;
+	if(y1 > mClip.y1)	y1 = mClip.y1;
+	if(y0 > y1)
+		return;
+
+	rgb24 *dest = &mPixels[(y0 * mWidth) + x];
+	for(int y=y0; y<=y1; y++, dest += mWidth)
+		*dest = color;
+}
+
+void FrameBuffer::drawCircle(int16_t x, int16_t y, uint16_t radius, const rgb24& color)
+{
+	plot(x,          y + radius, color);
+	plot(x,          y - radius, color);
+	plot(x + radius, y,          color);
+	plot(x - radius, y,          color);
+
+	circleQuadrants(x, y, radius, 0x0F, 0, 0, color);
+}
+
+void FrameBuffer::fillCircle(int16_t x, int16_t y, uint16_t radius, const rgb24& outlineColor, const rgb24& fillColor)
+{
+	span(x - radius, x + radius, y, fillColor);
+	circleSpans(x, y, radius, 0x03, 0, 0, fillColor);
+
+	drawCircle(x, y, radius, outlineColor);
+}
+
+void FrameBuffer::drawEllipse(int16_t x, int16_t y, uint16_t radiusX, uint16_t radiusY, const rgb24& color)
+{
+	// midpoint ellipse, integer math with the 1/4 terms rounded down
+	const int64_t rx2 = (int64_t)radiusX * radiusX, twoRx2 = 2 * rx2;
+	const int64_t ry2 = (int64_t)radiusY * radiusY, twoRy2 = 2 * ry2;
+	int64_t px = 0, py = twoRx2 * radiusY, p;
+	int     dx = 0, dy = radiusY;
+
+	#define ELLIPSE_PLOT4() \
+		{ plot(x + dx, y + dy, color); plot(x - dx, y + dy, color); \
+		  plot(x + dx, y - dy, color); plot(x - dx, y - dy, color); }
+
+	ELLIPSE_PLOT4();
+
+	// region 1, slope above -1
+	p = ry2 - (rx2 * radiusY) + (rx2 / 4);
+	while(px < py)
+	{
+		dx++;
+		px += twoRy2;
+		if(p < 0)
+			p += ry2 + px;
+		else
+		{
+			dy--;
+			py -= twoRx2;
+			p  += ry2 + px - py;
+		}
+		ELLIPSE_PLOT4();
+	}
+
+	// region 2, slope below -1
+	p = (ry2 * ((int64_t)dx * dx + dx)) + (ry2 / 4) + (rx2 * (int64_t)(dy -1) * (dy -1)) - (rx2 * ry2);
+	while(dy > 0)
+	{
+		dy--;
+		py -= twoRx2;
+		if(p > 0)
+			p += rx2 - py;
+		else
+		{
+			dx++;
+			px += twoRy2;
+			p  += rx2 - py + px;
+		}
+		ELLIPSE_PLOT4();
+	}
+
+	#undef ELLIPSE_PLOT4
+}
+
+void FrameBuffer::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, const rgb24& color)
+{
+	drawLine(x0, y0, x1, y1, color);
+	drawLine(x1, y1, x2, y2, color);
+	drawLine(x2, y2, x0, y0, color);
+}
+
+void FrameBuffer::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, const rgb24& outlineColor, const rgb24& fillColor)
+{
+	int a, b, y, last;
+
+
+	// sort coordinates by Y order (y2 >= y1 >= y0)
+	if(y0 > y1)	{ std::swap(y0, y1); std::swap(x0, x1); }
+	if(y1 > y2)	{ std::swap(y2, y1); std::swap(x2, x1); }
+	if(y0 > y1)	{ std::swap(y0, y1); std::swap(x0, x1); }
+
+	if(y0 == y2)
+	{
+		// all on the same line
+		a = std::min(x0, std::min(x1, x2));
+		b = std::max(x0, std::max(x1, x2));
+		span(a, b, y0, fillColor);
+	} else
+	{
+		int dx01 = x1 - x0, dy01 = y1 - y0;
+		int dx02 = x2 - x0, dy02 = y2 - y0;
+		int dx12 = x2 - x1, dy12 = y2 - y1;
+		int sa   = 0, sb = 0;
+
+		// upper part, include the y1 scanline only when the lower part is flat
+		last = (y1 == y2)? y1 : y1 -1;
+		for(y=y0; y<=last; y++)
+		{
+			a   = x0 + sa / dy01;
+			b   = x0 + sb / dy02;
+			sa += dx01;
+			sb += dx02;
+			span(a, b, y, fillColor);
+		}
+
+		// lower part
+		sa = dx12 * (y - y1);
+		sb = dx02 * (y - y0);
+		for(; y<=y2; y++)
+		{
+			a   = x1 + sa / dy12;
+			b   = x0 + sb / dy02;
+			sa += dx12;
+			sb += dx02;
+			span(a, b, y, fillColor);
+		}
+	}
+
+	drawTriangle(x0, y0, x1, y1, x2, y2, outlineColor);
+}
+
+void FrameBuffer::drawRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24& color)
+{
+	span(x0, x1, y0, color);
+	span(x0, x1, y1, color);
+	drawFastVLine(x0, y0, y1, color);
+	drawFastVLine(x1, y0, y1, color);
+}
+
+void FrameBuffer::fillRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24& outlineColor, const rgb24& fillColor)
+{
+	if(y0 > y1)
+		std::swap(y0, y1);
+
+	for(int y=std::max<int>(y0, mClip.y0); y<=std::min<int>(y1, mClip.y1); y++)
+		span(x0, x1, y, fillColor);
+
+	if(outlineColor != fillColor)
+		drawRectangle(x0, y0, x1, y1, outlineColor);
+}
+
+void FrameBuffer::drawRoundRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t radius, const rgb24& outlineColor)
+{
+	if(x0 > x1)	std::swap(x0, x1);
+	if(y0 > y1)	std::swap(y0, y1);
+
+	// limit radius to half the shortest side
+	int r = std::min<int>(radius, std::min(x1 - x0 +1, y1 - y0 +1) / 2);
+
+	span(x0 + r, x1 - r, y0, outlineColor);
+	span(x0 + r, x1 - r, y1, outlineColor);
+	drawFastVLine(x0, y0 + r, y1 - r, outlineColor);
+	drawFastVLine(x1, y0 + r, y1 - r, outlineColor);
+
+	circleQuadrants(x0 + r, y0 + r, r, 0x0F, x1 - x0 - 2*r, y1 - y0 - 2*r, outlineColor);
+}
+
+void FrameBuffer::fillRoundRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t radius, const rgb24& outlineColor, const rgb24& fillColor)
+{
+	if(x0 > x1)	std::swap(x0, x1);
+	if(y0 > y1)	std::swap(y0, y1);
+
+	// limit radius to half the shortest side
+	int r = std::min<int>(radius, std::min(x1 - x0 +1, y1 - y0 +1) / 2);
+
+	// straight middle section, then the rounded top and bottom
+	for(int y=std::max<int>(y0 + r, mClip.y0); y<=std::min<int>(y1 - r, mClip.y1); y++)
+		span(x0, x1, y, fillColor);
+
+	circleSpans(x0 + r, y0 + r, r, 0x03, x1 - x0 - 2*r, y1 - y0 - 2*r, fillColor);
+
+	drawRoundRectangle(x0, y0, x1, y1, r, outlineColor);
+}
+
+void FrameBuffer::fillScreen(const rgb24& color)
+{
+	fillPixels(mPixels.data(), mPixels.size(), color);
+}
+
+/**
+ * Draw a glyph from the font's span atlas, glyphs entirely within the
+ * clipping bounds fill their spans without any further checks.
+ */
+void FrameBuffer::drawChar(int16_t x, int16_t y, const rgb24& charColor, char character)
+{
+	const uint8_t		 g     = tBitmapFont::index(character);
+	const tGlyphSpan	*span  = &mAtlas->spans[mAtlas->first[g]];
+	const tGlyphSpan	*end   = &mAtlas->spans[mAtlas->first[g +1]];
+	const tGlyphMetrics	&ink   = mFont->metrics[g];
+
+
+	// stand-in glyphs would show different text than the panel
+	if(!bitmapFontsExact() || (span == end))
+		return;
+
+	if(((x + ink.left) < mClip.x0) || ((x + ink.left + ink.width -1) > mClip.x1) ||
+	   ((y + ink.top) < mClip.y0) || ((y + ink.top + ink.height -1) > mClip.y1))
+	{
+		for(; span < end; span++)
+			this->span(x + span->x, x + span->x + span->length -1, y + span->row, charColor);
+		return;
+	}
+
+	rgb24 *origin = &mPixels[(y * mWidth) + x];
+	for(; span < end; span++)
+	{
+		rgb24 *dest = &origin[(span->row * mWidth) + span->x];
+
+		for(uint8_t i=0; i<span->length; i++)
+			dest[i] = charColor;
+	}
+}
+
+void FrameBuffer::drawMonoBitmap(int16_t x, int16_t y, uint8_t width, uint8_t height, const rgb24& bitmapColor, const uint8_t *bitmap)
+{
+	const size_t pitch = (width + 7) / 8;
+
+
+	for(int r=0; r<height; r++, bitmap += pitch)
+	{
+		// draw each run of set bits as one span
+		for(int c=0; c<width;)
+		{
+			if(!(bitmap[c / 8] & (0x80 >> (c % 8))))
+			{
+				c++;
+				continue;
+			}
+
+			int start = c;
+			while((c < width) && (bitmap[c / 8] & (0x80 >> (c % 8))))
+				c++;
+
+			span(x + start, x + c -1, y + r, bitmapColor);
+		}
+	}
+}
+
+void FrameBuffer::drawBitmap(int16_t x, int16_t y, uint8_t width, uint8_t height, const rgb24 *pixels, const rgb24 *key)
+{
+	for(int r=0; r<height; r++, pixels += width)
+	{
+		const int py = y + r;
+
+		if((py < mClip.y0) || (py > mClip.y1))
+			continue;
+
+		for(int c=0; c<width; c++)
+		{
+			if(!key || (pixels[c] != *key))
+				plot(x + c, py, pixels[c]);
+		}
+	}
+}
+
+void FrameBuffer::drawImage(int16_t x, int16_t y, const FrameBuffer &image)
+{
+	// visible part in image coordinates
+	const int c0 = std::max<int>(mClip.x0 - x, 0);
+	const int c1 = std::min<int>(mClip.x1 - x, image.width() -1);
+	const int r0 = std::max<int>(mClip.y0 - y, 0);
+	const int r1 = std::min<int>(mClip.y1 - y, image.height() -1);
+
+	if((c0 > c1) || (r0 > r1))
+		return;
+
+	for(int r=r0; r<=r1; r++)
+		memcpy((uint8_t *)&mPixels[((y + r) * mWidth) + x + c0], (const uint8_t *)(image.row(r) + c0), (c1 - c0 +1) * sizeof(rgb24));
+}
+
+void FrameBuffer::drawString(int16_t x, int16_t y, const rgb24& charColor, const rgb24& backColor, const char text[])
+{
+	// same fore and back colors draws a transparent background
+	const bool	opaque = (charColor != backColor);
+	int16_t		left   = x;
+
+
+	if(!bitmapFontsExact())
+		return;
+
+	for(; *text; text++)
+	{
+		if(*text == '\n')
+		{
+			x  = left;
+			y += mFont->height;
+			continue;
+		}
+
+		// background of the whole line at once
+		if(opaque && (x == left))
+		{
+			int width = 0;
+			for(const char *c = text; *c && (*c != '\n'); c++)
+				width += mFont->metric(*c).advance;
+
+			fillRectangle(x, y, x + width -1, y + mFont->height -1, backColor, backColor);
+		}
+
+		drawChar(x, y, charColor, *text);
+		x += mFont->metric(*text).advance;
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+// Font functions
+//-----------------------------------------------------------------------------
+
+void FrameBuffer::setFont(fontChoices newFont)
+{
+	const tBitmapFont *font = getBitmapFont(newFont);
+
+	if(font)
+	{
+		mFont  = font;
+		mAtlas = getGlyphAtlas(font);
+	}
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Command replay
+//-----------------------------------------------------------------------------
+
+// read packed command parameters, coordinates followed by colors
+static const uint8_t* unpackParams(const uint8_t *src, int16_t *values, size_t count, rgb24 *colors, size_t colorCount)
+{
+	memcpy(values, src, count * sizeof(int16_t));
+	src += count * sizeof(int16_t);
+	memcpy((uint8_t *)colors, src, colorCount * sizeof(rgb24));
+	return src + colorCount * sizeof(rgb24);
+}
+
+void FrameBuffer::replay(const std::vector<uint8_t> &packets, const std::vector<Sprite *> *sprites)
+{
+	std::string	text;	// DRAWSTRING_SLOT contents
+
+
+	for(size_t offset = 0; (offset + RPCDATA_SIZE) <= packets.size(); offset += RPCDATA_SIZE)
+	{
+		const uint8_t	*packet = &packets[offset];
+		const uint8_t	*params = &packet[RPCC_SIZE];
+		int16_t			 v[6];
+		rgb24			 c[2];
+
+
+		if((packet[0] == (uint8_t)rpcType::IO) && (packet[1] == (uint8_t)rpcIO::XferRecv))
+		{
+			tRPCXfer xfer;
+
+			memcpy(&xfer, params, sizeof(xfer));
+			if((xfer.index & RPCXFER_MASK_SLOT) != DRAWSTRING_SLOT)
+				continue;
+
+			if(!(xfer.index & RPCXFER_APPEND))
+				text.clear();
+			text.append((const char *)&params[sizeof(xfer)], xfer.size);
+			continue;
+		}
+
+		if(packet[0] != (uint8_t)rpcType::Drawing)
+			continue;
+
+		switch((rpcDrawing)packet[1])
+		{
+			case rpcDrawing::DrawPixel:
+				unpackParams(params, v, 2, c, 1);
+				drawPixel(v[0], v[1], c[0]);
+				break;
+			case rpcDrawing::DrawLine:
+				unpackParams(params, v, 4, c, 1);
+				drawLine(v[0], v[1], v[2], v[3], c[0]);
+				break;
+			case rpcDrawing::DrawFastVLine:
+				unpackParams(params, v, 3, c, 1);
+				drawFastVLine(v[0], v[1], v[2], c[0]);
+				break;
+			case rpcDrawing::DrawFastHLine:
+				unpackParams(params, v, 3, c, 1);
+				drawFastHLine(v[0], v[1], v[2], c[0]);
+				break;
+			case rpcDrawing::DrawCircle:
+				unpackParams(params, v, 3, c, 1);
+				drawCircle(v[0], v[1], v[2], c[0]);
+				break;
+			case rpcDrawing::FillCircle:
+				unpackParams(params, v, 3, c, 2);
+				fillCircle(v[0], v[1], v[2], c[0], c[1]);
+				break;
+			case rpcDrawing::DrawEllipse:
+				unpackParams(params, v, 4, c, 1);
+				drawEllipse(v[0], v[1], v[2], v[3], c[0]);
+				break;
+			case rpcDrawing::DrawTriangle:
+				unpackParams(params, v, 6, c, 1);
+				drawTriangle(v[0], v[1], v[2], v[3], v[4], v[5], c[0]);
+				break;
+			case rpcDrawing::FillTriangle:
+				unpackParams(params, v, 6, c, 2);
+				fillTriangle(v[0], v[1], v[2], v[3], v[4], v[5], c[0], c[1]);
+				break;
+			case rpcDrawing::DrawRectangle:
+				unpackParams(params, v, 4, c, 1);
+				drawRectangle(v[0], v[1], v[2], v[3], c[0]);
+				break;
+			case rpcDrawing::FillRectangle:
+				unpackParams(params, v, 4, c, 2);
+				fillRectangle(v[0], v[1], v[2], v[3], c[0], c[1]);
+				break;
+			case rpcDrawing::DrawRoundRectangle:
+				unpackParams(params, v, 5, c, 1);
+				drawRoundRectangle(v[0], v[1], v[2], v[3], v[4], c[0]);
+				break;
+			case rpcDrawing::FillRoundRectangle:
+				unpackParams(params, v, 5, c, 2);
+				fillRoundRectangle(v[0], v[1], v[2], v[3], v[4], c[0], c[1]);
+				break;
+			case rpcDrawing::FillScreen:
+				unpackParams(params, v, 0, c, 1);
+				fillScreen(c[0]);
+				break;
+			case rpcDrawing::SetFont:
+				setFont((fontChoices)params[0]);
+				break;
+			case rpcDrawing::DrawChar:
+			{
+				const uint8_t *chr = unpackParams(params, v, 2, c, 1);
+				drawChar(v[0], v[1], c[0], (char)*chr);
+				break;
+			}
+			case rpcDrawing::DrawString:
+				unpackParams(params, v, 2, c, 2);
+				drawString(v[0], v[1], c[0], c[1], text.c_str());
+				break;
+			case rpcDrawing::DrawMonoBitmap:
+			{
+				tRPCMonoBitmap bitmap;
+
+				unpackParams(params, v, 2, c, 0);
+				if(text.size() < sizeof(bitmap))
+					break;
+
+				memcpy(&bitmap, text.data(), sizeof(bitmap));
+				if(text.size() >= (sizeof(bitmap) + (size_t)((bitmap.width + 7) / 8) * bitmap.height))
+					drawMonoBitmap(v[0], v[1], bitmap.width, bitmap.height, rgb24(bitmap.color[0], bitmap.color[1], bitmap.color[2]),
+								   (const uint8_t *)text.data() + sizeof(bitmap));
+				break;
+			}
+			case rpcDrawing::Sprite:
+			{
+				tRPCSprite sprite;
+
+				memcpy(&sprite, params, sizeof(sprite));
+				if((sprite.op != (uint8_t)rpcSpriteOp::Blit) || !sprites || !sprite.handle ||
+					(sprite.handle > sprites->size()) || !(*sprites)[sprite.handle -1])
+					break;
+
+				(*sprites)[sprite.handle -1]->draw(*this, sprite.x, sprite.y, rgb24(sprite.color[0], sprite.color[1], sprite.color[2]),
+												   (sprite.flags & RPCSPR_FLAG_KEY) != 0);
+				break;
+			}
+			case rpcDrawing::DrawBatch:
+			{
+				tRPCDrawBatch	 batch;
+				const uint8_t	*entry = &params[sizeof(batch)];
+
+				memcpy(&batch, params, sizeof(batch));
+
+				const rpcDrawing cmd    = (rpcDrawing)batch.cmd;
+				const bool		 shared = (batch.flags & RPCBATCH_FLAG_SHARED) != 0;
+				const size_t	 coords = shared? 1 : ((cmd == rpcDrawing::DrawPixel)? 2 : ((cmd == rpcDrawing::DrawLine)? 4 : 3));
+				const size_t	 colors = (batch.flags & RPCBATCH_FLAG_COLOR)? 0 : 1;
+
+				if(shared && (cmd != rpcDrawing::DrawFastVLine) && (cmd != rpcDrawing::DrawFastHLine))
+					break;
+
+				c[0] = rgb24(batch.color[0], batch.color[1], batch.color[2]);
+				for(uint8_t i=0; i<batch.count; i++)
+				{
+					if((entry + (coords * sizeof(int16_t)) + (colors * sizeof(rgb24))) > &packet[RPCDATA_SIZE])
+						break;
+
+					// shared coordinates go around the entry's own, VLine x, y0, y1 and HLine x0, x1, y
+					entry = unpackParams(entry, &v[(shared && (cmd == rpcDrawing::DrawFastHLine))? 2 : 0], coords, c, colors);
+					if(shared && (cmd == rpcDrawing::DrawFastVLine))
+					{
+						v[1] = batch.shared[0];
+						v[2] = batch.shared[1];
+					} else if(shared)
+					{
+						v[0] = batch.shared[0];
+						v[1] = batch.shared[1];
+					}
+
+					switch(cmd)
+					{
+						case rpcDrawing::DrawPixel:		drawPixel(v[0], v[1], c[0]); break;
+						case rpcDrawing::DrawLine:		drawLine(v[0], v[1], v[2], v[3], c[0]); break;
+						case rpcDrawing::DrawFastVLine:	drawFastVLine(v[0], v[1], v[2], c[0]); break;
+						case rpcDrawing::DrawFastHLine:	drawFastHLine(v[0], v[1], v[2], c[0]); break;
+						default: break;
+					}
+				}
+				break;
+			}
+			default:
+				break;
+		}
+	}
+}
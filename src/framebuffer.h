@@ -0,0 +1,94 @@
+#ifndef XPM_FRAMEBUFFER_H_
+#define XPM_FRAMEBUFFER_H_
+
+
+struct tBitmapFont;
+struct tGlyphAtlas;
+class Sprite;
+
+
+// Host side rgb24 framebuffer with a software rasterizer mirroring LEDMatrix drawing functions
+class FrameBuffer
+{
+private:
+	std::vector<rgb24>	mPixels;
+	int16_t				mWidth;
+	int16_t				mHeight;
+	const tBitmapFont	*mFont;
+	const tGlyphAtlas	*mAtlas;		// span lists of mFont's glyphs
+	struct
+	{
+		int16_t			x0, y0;
+		int16_t			x1, y1;
+	}					mClip;			// inclusive drawing bounds
+
+
+	void span(int x0, int x1, int y, const rgb24& color);
+	void plot(int x, int y, const rgb24& color)
+	{
+		if((x >= mClip.x0) && (x <= mClip.x1) && (y >= mClip.y0) && (y <= mClip.y1))
+			mPixels[(y * mWidth) + x] = color;
+	}
+	void circleQuadrants(int x0, int y0, int radius, uint8_t corners, int dx, int dy, const rgb24& color);
+	void circleSpans(int x0, int y0, int radius, uint8_t sides, int dx, int dy, const rgb24& color);
+
+
+public:
+	FrameBuffer(int16_t width = 0, int16_t height = 0);
+	~FrameBuffer();
+
+	bool resize(int16_t width, int16_t height);
+	void copy(const FrameBuffer &src);
+	void swap(FrameBuffer &other);
+
+	int16_t width() const							{ return mWidth; }
+	int16_t height() const							{ return mHeight; }
+	size_t  size() const							{ return mPixels.size(); }
+	rgb24* pixels()									{ return mPixels.data(); }
+	const rgb24* pixels() const						{ return mPixels.data(); }
+	rgb24* row(int16_t y)							{ return &mPixels[y * mWidth]; }
+	const rgb24* row(int16_t y) const				{ return &mPixels[y * mWidth]; }
+	rgb24 getPixel(int16_t x, int16_t y) const;
+
+	// clipping
+	void setClip(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+	void resetClip()								{ setClip(0, 0, mWidth -1, mHeight -1); }
+
+	// drawing functions, same semantics as the display panel's
+	void drawPixel(int16_t x, int16_t y, const rgb24& color)	{ plot(x, y, color); }
+	void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24& color);
+	void drawFastVLine(int16_t x, int16_t y0, int16_t y1, const rgb24& color);
+	void drawFastHLine(int16_t x0, int16_t x1, int16_t y, const rgb24& color)	{ span(x0, x1, y, color); }
+	void drawCircle(int16_t x, int16_t y, uint16_t radius, const rgb24& color);
+	void fillCircle(int16_t x, int16_t y, uint16_t radius, const rgb24& outlineColor, const rgb24& fillColor);
+	void drawEllipse(int16_t x, int16_t y, uint16_t radiusX, uint16_t radiusY, const rgb24& color);
+	void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, const rgb24& color);
+	void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, const rgb24& outlineColor, const rgb24& fillColor);
+	void drawRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24& color);
+	void fillRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24& outlineColor, const rgb24& fillColor);
+	void drawRoundRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t radius, const rgb24& outlineColor);
+	void fillRoundRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t radius, const rgb24& outlineColor, const rgb24& fillColor);
+	void fillScreen(const rgb24& color);
+	// text is only drawn once fontdata.h holds the panel's own glyphs, see bitmapFontsExact()
+	void drawChar(int16_t x, int16_t y, const rgb24& charColor, char character);
+	void drawString(int16_t x, int16_t y, const rgb24& charColor, const rgb24& backColor, const char text[]);
+	// rows of (width +7) / 8 bytes, most significant bit leftmost, clear bits are left untouched
+	void drawMonoBitmap(int16_t x, int16_t y, uint8_t width, uint8_t height, const rgb24& bitmapColor, const uint8_t *bitmap);
+	// pixels equal to the key are left untouched, if given
+	void drawBitmap(int16_t x, int16_t y, uint8_t width, uint8_t height, const rgb24 *pixels, const rgb24 *key = NULL);
+	// copy of another framebuffer with its top left at x, y, e.g. a decoded image
+	void drawImage(int16_t x, int16_t y, const FrameBuffer &image);
+
+	// fonts
+	void setFont(fontChoices newFont);
+
+	// draw recorded drawing command packets, see XpmRPC::record(), sprite blits look up
+	// the sprites by handle -1 as the panel would
+	void replay(const std::vector<uint8_t> &packets, const std::vector<Sprite *> *sprites = NULL);
+};
+
+
+extern void fillPixels(rgb24 *dest, size_t count, const rgb24& color);
+
+
+#endif // XPM_FRAMEBUFFER_H_
@@ -0,0 +1,151 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "framecompress.h"
+#include "simd.h"
+
+
+/**
+ * Greedy match search over a few fixed distances, pixel repeats of the
+ * direct and indexed formats and the row above, which covers the solid
+ * runs and columns host rendered frames are made of.
+ *
+ * @return	Bytes written, SIZE_MAX if over capacity.
+ */
+static size_t compressSegment(const uint8_t *frame, size_t begin, size_t end, size_t stride, uint8_t *dest, size_t capacity)
+{
+	const size_t	distances[] = { 3, 1, 2, 4, 6, stride, stride * 2 };
+	size_t			out     = 0;
+	size_t			literal = SIZE_MAX;		// position of the open literal token
+
+
+	for(size_t p = begin; p < end;)
+	{
+		size_t length = 0, distance = 0;
+
+		for(size_t i=0; i<ARRAYSIZE(distances); i++)
+		{
+			const size_t d = distances[i];
+			if(!d || (d > p) || (d > 0xFFFF))
+				continue;
+
+			const size_t l = simdMatchLength(&frame[p], &frame[p - d], std::min<size_t>(end - p, RPCFB_MATCH_MAX));
+			if(l > length)
+			{
+				length   = l;
+				distance = d;
+			}
+		}
+
+		if(length >= RPCFB_MATCH_MIN)
+		{
+			if((out + 3) > capacity)
+				return SIZE_MAX;
+
+			dest[out++] = 0x80 + (length - RPCFB_MATCH_MIN);
+			dest[out++] = distance;
+			dest[out++] = distance >> 8;
+			literal = SIZE_MAX;
+			p += length;
+			continue;
+		}
+
+		// extend the open literal token or start a new one
+		if((literal == SIZE_MAX) || (dest[literal] == (RPCFB_LITERAL_MAX -1)))
+		{
+			if((out + 2) > capacity)
+				return SIZE_MAX;
+
+			literal = out;
+			dest[out++] = 0;
+		} else
+		{
+			if((out + 1) > capacity)
+				return SIZE_MAX;
+
+			dest[literal]++;
+		}
+		dest[out++] = frame[p++];
+	}
+
+	return out;
+}
+
+/**
+ * Compress consecutive segments into one packet payload. Matches may
+ * reach back into earlier segments, the panel's drawing buffer has to hold
+ * this frame's bytes before the first segment, as it does during delta
+ * streaming sending changed segments in order.
+ *
+ * @param frame		Frame in wire format.
+ * @param size		Frame size in bytes.
+ * @param stride	Row size in bytes, 0 if unknown.
+ * @param first		First segment.
+ * @param count		Segments to cover at most.
+ * @param dest		Receives up to RPCFB_COMPRESSED_SIZE bytes of tokens.
+ * @param written	Receives number of bytes written to dest.
+ * @return	Segments covered, 0 if the first one doesn't compress into a packet.
+ */
+size_t frameCompress(const uint8_t *frame, size_t size, size_t stride, size_t first, size_t count, uint8_t *dest, size_t &written)
+{
+	size_t i;
+
+
+	written = 0;
+	for(i=0; i<count; i++)
+	{
+		const size_t begin = (first + i) * RPCFB_SEGMENT_SIZE;
+		if(begin >= size)
+			break;
+
+		const size_t n = compressSegment(frame, begin, std::min<size_t>(begin + RPCFB_SEGMENT_SIZE, size), stride,
+										 &dest[written], RPCFB_COMPRESSED_SIZE - written);
+		if(n == SIZE_MAX)
+			break;
+
+		written += n;
+	}
+
+	return i;
+}
+
+bool frameDecompress(uint8_t *frame, size_t size, size_t first, size_t count, const uint8_t *src, size_t length)
+{
+	size_t p   = first * RPCFB_SEGMENT_SIZE;
+	size_t end = std::min<size_t>((first + count) * RPCFB_SEGMENT_SIZE, size);
+	size_t s   = 0;
+
+
+	while(p < end)
+	{
+		if(s >= length)
+			return false;
+
+		const uint8_t token = src[s++];
+		if(token < 0x80)
+		{
+			const size_t n = token +1;
+			if(((s + n) > length) || ((p + n) > end))
+				return false;
+
+			memcpy(&frame[p], &src[s], n);
+			s += n;
+			p += n;
+		} else
+		{
+			if((s + 2) > length)
+				return false;
+
+			const size_t d = src[s] | (src[s +1] << 8);
+			const size_t n = token - 0x80 + RPCFB_MATCH_MIN;
+			s += 2;
+			if(!d || (d > p) || ((p + n) > end))
+				return false;
+
+			// byte wise, overlapping copies repeat the pattern
+			for(size_t i=0; i<n; i++, p++)
+				frame[p] = frame[p - d];
+		}
+	}
+
+	return s == length;
+}
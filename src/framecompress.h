@@ -0,0 +1,15 @@
+#ifndef XPM_FRAMECOMPRESS_H_
+#define XPM_FRAMECOMPRESS_H_
+
+
+// Compressed framebuffer segments, see RPCFB_SEGMENT_COMPRESSED for the token format
+
+// compress up to count consecutive segments starting at first into dest, at most RPCFB_COMPRESSED_SIZE
+// bytes, stride is the frame row size in bytes or 0, returns the number of segments that fit
+size_t frameCompress(const uint8_t *frame, size_t size, size_t stride, size_t first, size_t count, uint8_t *dest, size_t &written);
+
+// decode like the panel does, frame holds the bytes before the first segment already, false if malformed
+bool frameDecompress(uint8_t *frame, size_t size, size_t first, size_t count, const uint8_t *src, size_t length);
+
+
+#endif // XPM_FRAMECOMPRESS_H_
@@ -0,0 +1,349 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "framepalette.h"
+#include "framestream.h"
+#include "frameencoder.h"
+
+
+static inline uint32_t packColor(const rgb24 &color)
+{
+	return ((uint32_t)color.red << 16) | ((uint32_t)color.green << 8) | color.blue;
+}
+
+// draw list covers the whole panel before anything else is drawn, with a fill or, if shifts
+// count, the displayed frame shifted
+static bool startsWithFill(const std::vector<uint8_t> &packets, bool shifts)
+{
+	for(size_t offset = 0; (offset + RPCDATA_SIZE) <= packets.size(); offset += RPCDATA_SIZE)
+	{
+		// fences don't draw
+		if((packets[offset] == (uint8_t)rpcType::System) && (packets[offset +1] == (uint8_t)rpcSystem::Fence))
+			continue;
+
+		if(packets[offset] == (uint8_t)rpcType::Display)
+			return shifts && ((rpcDisplay)packets[offset +1] == rpcDisplay::ShiftBuffer);
+
+		if(packets[offset] != (uint8_t)rpcType::Drawing)
+			return false;
+
+		switch((rpcDrawing)packets[offset +1])
+		{
+			case rpcDrawing::SetFont:
+				continue;
+			case rpcDrawing::FillScreen:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	return false;
+}
+
+
+//=============================================================================
+// Frame encoder cost model class
+//=============================================================================
+FrameEncoder::FrameEncoder()
+:	mUnshadowed(false),
+	encoding(FrameEncoding::None)
+{
+	for(size_t i=0; i<ARRAYSIZE(estimate); i++)
+		estimate[i] = SIZE_MAX;
+}
+FrameEncoder::~FrameEncoder()
+{
+}
+
+void FrameEncoder::closeRegion(const tRegion &region)
+{
+	if((size_t)((region.x1 - region.x0 +1) * (region.y1 - region.y0 +1)) < ENCODER_REGIONS_MINAREA)
+		return;
+
+	mRegions.push_back(region);
+	mRegionFrame.fillRectangle(region.x0, region.y0, region.x1, region.y1, region.color, region.color);
+}
+
+/**
+ * Find the dominant color and the uniform rectangles of a frame, rendering
+ * them into mRegionFrame the way the fill commands would.
+ *
+ * @param frame	Host rendered frame.
+ * @param limit	Give up once this many packets are exceeded.
+ * @return	Packets the fill commands take, SIZE_MAX if over limit.
+ */
+size_t FrameEncoder::analyzeRegions(const FrameBuffer &frame, size_t limit)
+{
+	const rgb24	*pixels = frame.pixels();
+	const size_t count  = frame.size();
+
+
+	// dominant color becomes the FillScreen background
+	mHistogram.resize(count);
+	for(size_t i=0; i<count; i++)
+		mHistogram[i] = packColor(pixels[i]);
+	std::sort(mHistogram.begin(), mHistogram.end());
+
+	uint32_t	dominant = 0;
+	size_t		best = 0;
+	for(size_t i=0, run; i<count; i+=run)
+	{
+		for(run = 1; ((i + run) < count) && (mHistogram[i + run] == mHistogram[i]); run++);
+		if(run > best)
+		{
+			best     = run;
+			dominant = mHistogram[i];
+		}
+	}
+	mBackground = rgb24(dominant >> 16, dominant >> 8, dominant);
+
+	mRegionFrame.resize(frame.width(), frame.height());
+	mRegionFrame.fillScreen(mBackground);
+	mRegions.clear();
+	mOpen.clear();
+
+	// grow rectangles down from equal color row runs sharing the exact same span
+	for(int16_t y=0; y<frame.height(); y++)
+	{
+		const rgb24 *line = frame.row(y);
+
+		mNext.clear();
+		for(int16_t x=0, end; x<frame.width(); x=end)
+		{
+			for(end = x +1; (end < frame.width()) && (line[end] == line[x]); end++);
+
+			if((line[x] == mBackground) || ((end - x) < ENCODER_REGIONS_MINRUN))
+				continue;
+
+			tRegion region = { x, y, (int16_t)(end -1), y, line[x] };
+			for(size_t i=0; i<mOpen.size(); i++)
+			{
+				tRegion &open = mOpen[i];
+				if((open.x0 == region.x0) && (open.x1 == region.x1) && (open.color == region.color))
+				{
+					region.y0 = open.y0;
+					open.x1   = -1;	// continued
+					break;
+				}
+			}
+			mNext.push_back(region);
+		}
+
+		// regions not continued on this row are complete
+		for(size_t i=0; i<mOpen.size(); i++)
+		{
+			if(mOpen[i].x1 >= 0)
+				closeRegion(mOpen[i]);
+		}
+		mOpen.swap(mNext);
+
+		if((mRegions.size() +1) > limit)
+			return SIZE_MAX;
+	}
+	for(size_t i=0; i<mOpen.size(); i++)
+		closeRegion(mOpen[i]);
+
+	// FillScreen and a FillRectangle per region
+	return mRegions.size() +1;
+}
+
+/**
+ * Count, or send, the pixels mRegionFrame is missing as horizontal line commands.
+ *
+ * @param frame	Host rendered frame.
+ * @param limit	Give up once this many packets are exceeded.
+ * @param send	Send the commands rather than only counting them.
+ * @return	Number of commands, SIZE_MAX if over limit or on I/O error.
+ */
+size_t FrameEncoder::residualSpans(const FrameBuffer &frame, size_t limit, bool send)
+{
+	size_t result = 0;
+
+
+	for(int16_t y=0; y<frame.height(); y++)
+	{
+		const rgb24 *line = frame.row(y);
+		const rgb24 *have = mRegionFrame.row(y);
+
+		for(int16_t x=0, end; x<frame.width(); x=end)
+		{
+			end = x +1;
+			if(line[x] == have[x])
+				continue;
+
+			for(; (end < frame.width()) && (line[end] == line[x]) && (have[end] != line[end]); end++);
+
+			if(++result > limit)
+				return SIZE_MAX;
+
+			if(send)
+			{
+				struct
+				{
+					int16_t  x0, x1, y;
+					rgb24    color;
+				} PACKED p = // parameters
+				{
+					x, (int16_t)(end -1), y, line[x]
+				};
+
+				if(!rpc.send(rpcType::Drawing, rpcDrawing::DrawFastHLine, &p, sizeof(p)))
+					return SIZE_MAX;
+			}
+		}
+	}
+
+	return result;
+}
+
+bool FrameEncoder::sendRegions(const FrameBuffer &frame)
+{
+	if(!rpc.send(rpcType::Drawing, rpcDrawing::FillScreen, &mBackground, sizeof(mBackground)))
+		return false;
+
+	for(size_t i=0; i<mRegions.size(); i++)
+	{
+		const tRegion &region = mRegions[i];
+		struct
+		{
+			int16_t  x0, y0, x1, y1;
+			rgb24    colorOutline, colorFill;
+		} PACKED p = // parameters
+		{
+			region.x0, region.y0, region.x1, region.y1, region.color, region.color
+		};
+
+		if(!rpc.send(rpcType::Drawing, rpcDrawing::FillRectangle, &p, sizeof(p)))
+			return false;
+	}
+
+	// remaining pixels as addressed segments, the last one swaps
+	if(rpc.hasCapability(RPCCAP_FB_SEGMENTS))
+	{
+		mStream.assume((const uint8_t *)mRegionFrame.pixels(), mRegionFrame.size() * sizeof(rgb24));
+		return mStream.sendDelta((const uint8_t *)frame.pixels(), frame.size() * sizeof(rgb24), frame.width() * sizeof(rgb24));
+	}
+
+	if(residualSpans(frame, SIZE_MAX -1, true) == SIZE_MAX)
+		return false;
+
+	return sendSwap();
+}
+
+bool FrameEncoder::sendSwap()
+{
+	uint8_t i = 0x01; // copy displayed into drawing buffer
+
+	return rpc.send(rpcType::Display, rpcDisplay::SwapBuffers, &i, sizeof(i));
+}
+
+/**
+ * Estimate the packet cost of every viable encoding and send the frame
+ * with the cheapest, followed by a buffer swap leaving the frame in both
+ * panel framebuffers.
+ *
+ * @param frame		Host rendered frame.
+ * @param drawList	Recorded drawing commands producing frame from the previous
+ * 					encoded frame, or from scratch if it starts with FillScreen.
+ * @param unshadowed	drawList draws something frame lacks, panel font text
+ * 					while the host has no exact copy of those fonts. Such
+ * 					frames, and every frame drawn on top of them, can only
+ * 					be sent as their draw list.
+ * @return	false on device I/O error.
+ */
+bool FrameEncoder::encode(const FrameBuffer &frame, const std::vector<uint8_t> *drawList, bool unshadowed)
+{
+	const uint8_t	*data     = (const uint8_t *)frame.pixels();
+	const size_t	 size     = frame.size() * sizeof(rgb24);
+	const bool		 segments = rpc.hasCapability(RPCCAP_FB_SEGMENTS);
+	const bool		 fresh    = drawList && startsWithFill(*drawList, true);
+	const bool		 cleared  = drawList && startsWithFill(*drawList, false);
+	bool			 result;
+
+
+	for(size_t i=0; i<ARRAYSIZE(estimate); i++)
+		estimate[i] = SIZE_MAX;
+
+	// the panel won't match frame afterwards, its pixels are unknown until a cleared unshadowed
+	// frame, a shifted one keeps them
+	if(drawList && (unshadowed || (mUnshadowed && !cleared)))
+	{
+		estimate[(int)FrameEncoding::DrawList] = (drawList->size() / RPCDATA_SIZE) +1;
+
+		result = rpc.replay(*drawList) && sendSwap();
+		mStream.reset();
+		mUnshadowed = true;
+
+		encoding = FrameEncoding::DrawList;
+		return result;
+	}
+
+	// drawing commands only apply on top of a known panel framebuffer
+	if(drawList && (mStream.valid() || fresh))
+		estimate[(int)FrameEncoding::DrawList] = (drawList->size() / RPCDATA_SIZE) +1;
+
+	if(segments)
+		estimate[(int)FrameEncoding::Delta] = std::max<size_t>(mStream.changed(data, size), 1);
+
+	estimate[(int)FrameEncoding::Full] = (size + RPCFB_RASTER_SIZE -1) / RPCFB_RASTER_SIZE;
+
+	FrameEncoding choice = FrameEncoding::DrawList;
+	for(int i=(int)FrameEncoding::DrawList; i<(int)FrameEncoding::_Count; i++)
+	{
+		if(estimate[i] < estimate[(int)choice])
+			choice = (FrameEncoding)i;
+	}
+
+	// uniform regions only pay off on frames that are otherwise expensive
+	if(estimate[(int)choice] > ENCODER_REGIONS_MINCOST)
+	{
+		size_t limit = estimate[(int)choice] -1;
+		size_t cost  = analyzeRegions(frame, limit);
+
+		if(cost <= limit)
+		{
+			size_t residual = (segments)?
+				std::max<size_t>(FrameStream::compare(data, (const uint8_t *)mRegionFrame.pixels(), size), 1) :
+				residualSpans(frame, limit - cost, false);
+
+			if(residual <= (limit - cost))
+			{
+				estimate[(int)FrameEncoding::Regions] = cost + residual + ((segments)? 0 : 1);
+				if(estimate[(int)FrameEncoding::Regions] < estimate[(int)choice])
+					choice = FrameEncoding::Regions;
+			}
+		}
+	}
+
+	switch(choice)
+	{
+		case FrameEncoding::DrawList:
+			result = rpc.replay(*drawList) && sendSwap();
+			if(result)
+				mStream.assume(data, size);
+			break;
+
+		case FrameEncoding::Regions:
+			result = sendRegions(frame);
+			if(result)
+				mStream.assume(data, size);
+			break;
+
+		case FrameEncoding::Delta:
+			result = mStream.sendDelta(data, size, frame.width() * sizeof(rgb24));
+			break;
+
+		default:
+			result = mStream.sendFull(data, size);
+			break;
+	}
+
+	if(!result)
+		mStream.reset();
+
+	mUnshadowed = false;
+	encoding    = choice;
+	return result;
+}
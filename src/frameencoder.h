@@ -0,0 +1,68 @@
+#ifndef XPM_FRAMEENCODER_H_
+#define XPM_FRAMEENCODER_H_
+
+
+#define ENCODER_REGIONS_MINCOST		4		// packets, cheaper frames skip the uniform region analysis
+#define ENCODER_REGIONS_MINRUN		4		// pixels, shortest row run considered part of a uniform region
+#define ENCODER_REGIONS_MINAREA		(RPCFB_SEGMENT_SIZE / sizeof(rgb24))	// pixels, smallest region worth a fill command
+
+
+// Ways of bringing the panel to a frame, in order of preference on equal cost
+enum class FrameEncoding
+{
+	None = 0,			// nothing encoded yet
+	DrawList,			// replay of the recorded drawing commands
+	Regions,			// uniform regions as fill commands, remaining pixels as segments or spans
+	Delta,				// changed framebuffer segments only
+	Full,				// whole framebuffer raster
+
+	_Count
+};
+
+
+// Per frame cost model, sends a host rendered frame the way that takes the fewest packets
+class FrameEncoder
+{
+private:
+	struct tRegion
+	{
+		int16_t				x0, y0;
+		int16_t				x1, y1;		// inclusive
+		rgb24				color;
+	};
+
+	FrameStream				mStream;
+	FrameBuffer				mRegionFrame;	// background and regions as the fill commands would draw them
+	std::vector<tRegion>	mRegions;		// uniform regions found by the last analysis
+	std::vector<tRegion>	mOpen;			// regions still growing downwards during analysis
+	std::vector<tRegion>	mNext;
+	std::vector<uint32_t>	mHistogram;
+	rgb24					mBackground;	// dominant color of the last analysis
+	bool					mUnshadowed;	// panel shows drawing the host frames lack, see encode()
+
+
+	void   closeRegion(const tRegion &region);
+	size_t analyzeRegions(const FrameBuffer &frame, size_t limit);
+	size_t residualSpans(const FrameBuffer &frame, size_t limit, bool send);
+	bool   sendRegions(const FrameBuffer &frame);
+	bool   sendSwap();
+
+
+public:
+	FrameEncoding			encoding;		// encoding used for the last frame
+	size_t					estimate[(int)FrameEncoding::_Count];	// packet cost per encoding for the last frame, SIZE_MAX if not viable
+
+
+	FrameEncoder();
+	~FrameEncoder();
+
+	// forget what the panel holds, next frame is encoded from scratch
+	void reset()									{ mStream.reset(); mUnshadowed = false; }
+
+	// send frame followed by a copying buffer swap, drawList is an optional recording of
+	// the drawing commands that turned the previous frame into this one
+	bool encode(const FrameBuffer &frame, const std::vector<uint8_t> *drawList = NULL, bool unshadowed = false);
+};
+
+
+#endif // XPM_FRAMEENCODER_H_
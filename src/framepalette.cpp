@@ -0,0 +1,307 @@
+#include <xpmcommon.h>
+#include <climits>
+#include "rpc.h"
+#include "framepalette.h"
+
+
+#define NEAREST_SIZE	(1 << (PALETTE_NEAREST_BITS * 3))
+
+
+static inline uint32_t packColor(const rgb24 &color)
+{
+	return ((uint32_t)color.red << 16) | ((uint32_t)color.green << 8) | color.blue;
+}
+
+static inline uint16_t reduceColor(const rgb24 &color)
+{
+	const int shift = 8 - PALETTE_NEAREST_BITS;
+
+	return ((color.red >> shift) << (PALETTE_NEAREST_BITS * 2)) | ((color.green >> shift) << PALETTE_NEAREST_BITS) | (color.blue >> shift);
+}
+
+static inline int reducedChannel(uint16_t key, int axis)
+{
+	return (key >> (PALETTE_NEAREST_BITS * (2 - axis))) & ((1 << PALETTE_NEAREST_BITS) -1);
+}
+
+
+//=============================================================================
+// Indexed frame format palette class
+//=============================================================================
+FramePalette::FramePalette()
+{
+	rebuild();
+}
+FramePalette::~FramePalette()
+{
+}
+
+void FramePalette::rebuild()
+{
+	memset(mHashKey, 0, sizeof(mHashKey));
+	for(size_t i=0; i<mColors.size(); i++)
+		insert(packColor(mColors[i]), i);
+
+	mNearest.assign(NEAREST_SIZE, 0);
+}
+
+bool FramePalette::insert(uint32_t key, uint8_t index)
+{
+	for(size_t slot = ((key * 2654435761u) >> 16) & (PALETTE_HASH_SIZE -1);; slot = (slot +1) & (PALETTE_HASH_SIZE -1))
+	{
+		if(mHashKey[slot] == (key | PALETTE_HASH_USED))
+			return false;
+
+		if(!mHashKey[slot])
+		{
+			mHashKey[slot]   = key | PALETTE_HASH_USED;
+			mHashIndex[slot] = index;
+			return true;
+		}
+	}
+}
+
+int FramePalette::find(uint32_t key) const
+{
+	for(size_t slot = ((key * 2654435761u) >> 16) & (PALETTE_HASH_SIZE -1); mHashKey[slot]; slot = (slot +1) & (PALETTE_HASH_SIZE -1))
+	{
+		if(mHashKey[slot] == (key | PALETTE_HASH_USED))
+			return mHashIndex[slot];
+	}
+
+	return -1;
+}
+
+uint8_t FramePalette::nearest(const rgb24 &color)
+{
+	uint16_t &cached = mNearest[reduceColor(color)];
+
+
+	// nearby colors share the entry found for the first one looked up
+	if(!cached)
+	{
+		int best = INT_MAX;
+
+		for(size_t i=0; i<mColors.size(); i++)
+		{
+			const int dr = (int)mColors[i].red   - color.red;
+			const int dg = (int)mColors[i].green - color.green;
+			const int db = (int)mColors[i].blue  - color.blue;
+			const int d  = (dr * dr) + (dg * dg) + (db * db);
+
+			if(d < best)
+			{
+				best   = d;
+				cached = i +1;
+			}
+		}
+	}
+
+	return (cached)? (cached -1) : 0;
+}
+
+void FramePalette::assign(const rgb24 *colors, size_t count)
+{
+	mColors.assign(colors, colors + std::min<size_t>(count, RPCFB_PALETTE_SIZE));
+	rebuild();
+}
+
+/**
+ * Build the palette from the distinct colors of the pixels, in order of
+ * first appearance.
+ *
+ * @param pixels	Frame pixels.
+ * @param count		Number of pixels.
+ * @param maxColors	Palette size limit.
+ * @return	false if the pixels hold more colors, the palette is unusable then.
+ */
+bool FramePalette::exact(const rgb24 *pixels, size_t count, size_t maxColors)
+{
+	uint32_t last = PALETTE_HASH_USED;	// never a color
+
+
+	mColors.clear();
+	memset(mHashKey, 0, sizeof(mHashKey));
+	maxColors = std::min<size_t>(maxColors, RPCFB_PALETTE_SIZE);
+
+	for(size_t i=0; i<count; i++)
+	{
+		const uint32_t key = packColor(pixels[i]);
+
+		// runs of one color are common
+		if(key == last)
+			continue;
+		last = key;
+
+		if((find(key) < 0))
+		{
+			if(mColors.size() == maxColors)
+				return false;
+
+			insert(key, mColors.size());
+			mColors.push_back(pixels[i]);
+		}
+	}
+
+	mNearest.assign(NEAREST_SIZE, 0);
+	return true;
+}
+
+void FramePalette::measure(tBox &box) const
+{
+	int lo[3] = { INT_MAX, INT_MAX, INT_MAX };
+	int hi[3] = { -1, -1, -1 };
+
+
+	for(size_t i=box.begin; i<box.end; i++)
+	{
+		for(int c=0; c<3; c++)
+		{
+			const int v = reducedChannel(mBins[i].key, c);
+			lo[c] = std::min(lo[c], v);
+			hi[c] = std::max(hi[c], v);
+		}
+	}
+
+	box.axis  = 0;
+	box.range = -1;
+	for(int c=0; c<3; c++)
+	{
+		if((hi[c] - lo[c]) > box.range)
+		{
+			box.axis  = c;
+			box.range = hi[c] - lo[c];
+		}
+	}
+}
+
+/**
+ * Build the palette by median cut over a reduced color histogram, splitting
+ * the box with the widest channel range at its pixel weighted median until
+ * maxColors boxes exist, each box contributing its average color.
+ *
+ * @param pixels	Frame pixels.
+ * @param count		Number of pixels.
+ * @param maxColors	Palette size limit.
+ */
+void FramePalette::medianCut(const rgb24 *pixels, size_t count, size_t maxColors)
+{
+	maxColors = std::min<size_t>(maxColors, RPCFB_PALETTE_SIZE);
+
+	// histogram of the reduced colors
+	mBins.clear();
+	mBinOf.resize(NEAREST_SIZE, 0);
+	for(size_t i=0; i<count; i++)
+	{
+		const uint16_t	key = reduceColor(pixels[i]);
+		uint32_t		&bin = mBinOf[key];
+
+		if(!bin)
+		{
+			tBin b = { key, 0, { 0, 0, 0 } };
+			mBins.push_back(b);
+			bin = mBins.size();
+		}
+
+		tBin &b = mBins[bin -1];
+		b.count++;
+		b.sum[0] += pixels[i].red;
+		b.sum[1] += pixels[i].green;
+		b.sum[2] += pixels[i].blue;
+	}
+	for(size_t i=0; i<mBins.size(); i++)
+		mBinOf[mBins[i].key] = 0;
+
+	mBoxes.clear();
+	if(!mBins.empty())
+	{
+		tBox box = { 0, mBins.size(), 0, 0 };
+		measure(box);
+		mBoxes.push_back(box);
+	}
+
+	while(mBoxes.size() < maxColors)
+	{
+		size_t split = mBoxes.size();
+		for(size_t i=0; i<mBoxes.size(); i++)
+		{
+			if((mBoxes[i].range > 0) && ((split == mBoxes.size()) || (mBoxes[i].range > mBoxes[split].range)))
+				split = i;
+		}
+		if(split == mBoxes.size())
+			break;	// every box holds a single bin
+
+		tBox		&box  = mBoxes[split];
+		const int	 axis = box.axis;
+		uint32_t	 total = 0, half = 0;
+
+		std::sort(mBins.begin() + box.begin, mBins.begin() + box.end,
+			[axis](const tBin &a, const tBin &b) { return reducedChannel(a.key, axis) < reducedChannel(b.key, axis); });
+
+		for(size_t i=box.begin; i<box.end; i++)
+			total += mBins[i].count;
+
+		// weighted median, both halves keep at least one bin
+		size_t middle = box.begin +1;
+		for(size_t i=box.begin; i<(box.end -1); i++)
+		{
+			half += mBins[i].count;
+			middle = i +1;
+			if((half * 2) >= total)
+				break;
+		}
+
+		tBox upper = { middle, box.end, 0, 0 };
+		box.end = middle;
+		measure(box);
+		measure(upper);
+		mBoxes.push_back(upper);
+	}
+
+	// average color of every box
+	mColors.clear();
+	for(size_t i=0; i<mBoxes.size(); i++)
+	{
+		uint32_t total = 0, sum[3] = { 0, 0, 0 };
+
+		for(size_t j=mBoxes[i].begin; j<mBoxes[i].end; j++)
+		{
+			total += mBins[j].count;
+			for(int c=0; c<3; c++)
+				sum[c] += mBins[j].sum[c];
+		}
+
+		mColors.push_back(rgb24(sum[0] / total, sum[1] / total, sum[2] / total));
+	}
+
+	rebuild();
+}
+
+void FramePalette::map(const rgb24 *pixels, size_t count, int bits, uint8_t *dest)
+{
+	uint32_t last  = PALETTE_HASH_USED;	// never a color
+	uint8_t  index = 0;
+
+
+	for(size_t i=0; i<count; i++)
+	{
+		const uint32_t key = packColor(pixels[i]);
+
+		if(key != last)
+		{
+			const int found = find(key);
+
+			index = (found >= 0)? found : nearest(pixels[i]);
+			last  = key;
+		}
+
+		if(bits == 4)
+		{
+			if(i & 1)
+				dest[i / 2] |= index & 0x0F;
+			else
+				dest[i / 2] = index << 4;
+		} else
+			dest[i] = index;
+	}
+}
@@ -0,0 +1,62 @@
+#ifndef XPM_FRAMEPALETTE_H_
+#define XPM_FRAMEPALETTE_H_
+
+
+#define PALETTE_HASH_SIZE		1024	// exact match hash slots, power of two, twice the largest palette at least
+#define PALETTE_HASH_USED		0x01000000	// marks an occupied hash slot, colors take the lower 24 bits
+#define PALETTE_NEAREST_BITS	5		// bits per channel of the nearest entry cache key and median cut bins
+
+
+// Color palette for the indexed frame formats, built from a frame or assigned, mapping pixels to indices
+class FramePalette
+{
+private:
+	struct tBin
+	{
+		uint16_t			key;		// color reduced to PALETTE_NEAREST_BITS per channel
+		uint32_t			count;
+		uint32_t			sum[3];		// full precision channel sums
+	};
+	struct tBox
+	{
+		size_t				begin, end;	// range of mBins
+		int					axis;		// channel with the widest range
+		int					range;
+	};
+
+	std::vector<rgb24>		mColors;
+	uint32_t				mHashKey[PALETTE_HASH_SIZE];	// packed color | PALETTE_HASH_USED, 0 if free
+	uint8_t					mHashIndex[PALETTE_HASH_SIZE];
+	std::vector<uint16_t>	mNearest;	// reduced color -> index +1, 0 until looked up
+	std::vector<tBin>		mBins;
+	std::vector<uint32_t>	mBinOf;		// reduced color -> bin +1 during median cut
+	std::vector<tBox>		mBoxes;
+
+
+	void rebuild();
+	void measure(tBox &box) const;
+	bool insert(uint32_t key, uint8_t index);
+	int  find(uint32_t key) const;
+	uint8_t nearest(const rgb24 &color);
+
+
+public:
+	FramePalette();
+	~FramePalette();
+
+	const std::vector<rgb24>& colors() const		{ return mColors; }
+	size_t size() const								{ return mColors.size(); }
+
+	// use the given colors, up to 256
+	void assign(const rgb24 *colors, size_t count);
+	// every distinct color of the pixels, false if there are more than maxColors
+	bool exact(const rgb24 *pixels, size_t count, size_t maxColors);
+	// up to maxColors colors approximating the pixels
+	void medianCut(const rgb24 *pixels, size_t count, size_t maxColors);
+
+	// indices of the exact or nearest palette entries, packed two per byte high nibble first if bits is 4
+	void map(const rgb24 *pixels, size_t count, int bits, uint8_t *dest);
+};
+
+
+#endif // XPM_FRAMEPALETTE_H_
@@ -0,0 +1,181 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "framepalette.h"
+#include "framestream.h"
+#include "framequeue.h"
+
+
+#define FRAMEQUEUE_SWAP_TIMEOUT	1000	// msec, give up waiting for a swap the panel never reports
+
+
+//=============================================================================
+// Asynchronous frame submission class
+//=============================================================================
+FrameQueue::FrameQueue()
+:	mCurrent(NULL),
+	mDepth(0),
+	mInFlight(0),
+	mStop(false),
+	mError(false),
+	submitted(0),
+	displayed(0)
+{
+}
+FrameQueue::~FrameQueue()
+{
+	stop();
+}
+
+/**
+ * Start the worker thread streaming submitted frames. Frames are sent in
+ * order, each after the panel swapped to the previous one, while up to
+ * depth frames can be submitted ahead.
+ *
+ * @param depth	Render ahead depth, clamped to 1 - FRAMEQUEUE_DEPTH_MAX.
+ * @return	false if already running.
+ */
+bool FrameQueue::start(size_t depth)
+{
+	if(running())
+		return false;
+
+	mDepth    = std::max<size_t>(1, std::min<size_t>(depth, FRAMEQUEUE_DEPTH_MAX));
+	mInFlight = 0;
+	mStop     = false;
+	mError    = false;
+	mCurrent  = NULL;
+	submitted = 0;
+	displayed = 0;
+
+	// one buffer more than in flight, the one being rendered
+	mFree.clear();
+	mPending.clear();
+	for(size_t i=0; i<=mDepth; i++)
+	{
+		mFrames[i].resize(matrix.width, matrix.height);
+		mFree.push_back(&mFrames[i]);
+	}
+
+	mStream.reset();
+	mWorker = std::thread(&FrameQueue::run, this);
+	return true;
+}
+
+void FrameQueue::stop()
+{
+	if(!running())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mWake.notify_all();
+	mWorker.join();
+
+	if(mCurrent)
+	{
+		mFree.push_back(mCurrent);
+		mCurrent = NULL;
+	}
+}
+
+FrameBuffer* FrameQueue::beginFrame(size_t msec)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+
+	if(mCurrent)
+		return mCurrent;
+
+	// only blocks with depth frames in flight already
+	if(!mSpace.wait_for(lock, std::chrono::milliseconds(msec),
+		[this] { return mError || mStop || ((mInFlight < mDepth) && !mFree.empty()); }))
+		return NULL;
+
+	if(mError || mStop)
+		return NULL;
+
+	mCurrent = mFree.front();
+	mFree.pop_front();
+
+	if((mCurrent->width() != matrix.width) || (mCurrent->height() != matrix.height))
+		mCurrent->resize(matrix.width, matrix.height);
+
+	return mCurrent;
+}
+
+bool FrameQueue::submitFrame()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		if(!mCurrent || mError || mStop)
+			return false;
+
+		mPending.push_back(mCurrent);
+		mCurrent = NULL;
+		mInFlight++;
+		submitted++;
+	}
+
+	mWake.notify_one();
+	return true;
+}
+
+void FrameQueue::run()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+
+
+	for(;;)
+	{
+		if(mPending.empty())
+		{
+			if(mStop)
+				break;
+
+			mWake.wait(lock);
+			continue;
+		}
+
+		FrameBuffer *frame = mPending.front();
+		mPending.pop_front();
+		lock.unlock();
+
+		// the whole frame goes out in one piece, other threads' commands wait
+		bool	result = false;
+		size_t	swaps  = 0;
+		if(!mError)
+		{
+			std::lock_guard<std::recursive_mutex> io(rpc.mutex());
+
+			swaps  = matrix.bufferswaps;
+			result = mStream.send(*frame);
+		}
+
+		// the frame's buffer is free again once sent
+		lock.lock();
+		mFree.push_back(frame);
+		lock.unlock();
+		mSpace.notify_all();
+
+		// the next frame goes into the drawing buffer, wait for the panel to swap this one in
+		for(int64_t start = clock_getnstime(CLOCK_MONOTONIC); result && rpc.ok() && !gm_Exit && (swaps == matrix.bufferswaps);)
+		{
+			rpc.poll(FRAMEQUEUE_POLL);
+			if((clock_getnstime(CLOCK_MONOTONIC) - start) > (FRAMEQUEUE_SWAP_TIMEOUT * 1000000LL))
+				break;
+		}
+
+		lock.lock();
+		if(result)
+			displayed++;
+		else
+			mError = true;
+		mInFlight--;
+		mSpace.notify_all();
+	}
+}
@@ -0,0 +1,55 @@
+#ifndef XPM_FRAMEQUEUE_H_
+#define XPM_FRAMEQUEUE_H_
+
+
+#define FRAMEQUEUE_DEPTH_MAX	3		// frames rendered ahead of the one the panel displays at most
+#define FRAMEQUEUE_POLL			5		// msec, device polling slice while waiting for a swap
+
+
+// Host rendered frames streamed by a worker thread, rendering the next frames overlaps the transfer
+class FrameQueue
+{
+private:
+	FrameStream				mStream;
+	FrameBuffer				mFrames[FRAMEQUEUE_DEPTH_MAX +1];
+	std::deque<FrameBuffer *> mFree;	// buffers beginFrame() hands out
+	std::deque<FrameBuffer *> mPending;	// submitted, waiting for the worker
+	FrameBuffer				*mCurrent;	// handed out by beginFrame()
+	size_t					mDepth;
+	size_t					mInFlight;	// submitted frames the panel hasn't swapped to yet
+	bool					mStop;
+	bool					mError;
+	std::mutex				mMutex;
+	std::condition_variable	mWake;		// worker, frame submitted or stopping
+	std::condition_variable	mSpace;		// beginFrame(), frame buffer released or in flight count dropped
+	std::thread				mWorker;
+
+
+	void run();
+
+
+public:
+	size_t					submitted;	// frames submitted since start()
+	size_t					displayed;	// frames the panel swapped to since start()
+
+
+	FrameQueue();
+	~FrameQueue();
+
+	// stream settings, e.g. wire format, only while stopped
+	FrameStream& stream()								{ return mStream; }
+
+	// spawn the worker, depth is the number of frames rendered ahead, 1 to FRAMEQUEUE_DEPTH_MAX
+	bool start(size_t depth = 2);
+	// send what has been submitted and stop the worker
+	void stop();
+	bool running() const								{ return mWorker.joinable(); }
+
+	// frame to render into, waits up to msec for one to become free, NULL on timeout or error
+	FrameBuffer* beginFrame(size_t msec = 1000);
+	// queue the frame from beginFrame() for sending, doesn't block
+	bool submitFrame();
+};
+
+
+#endif // XPM_FRAMEQUEUE_H_
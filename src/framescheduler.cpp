@@ -0,0 +1,84 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framescheduler.h"
+
+
+//=============================================================================
+// Frame scheduler class
+//=============================================================================
+FrameScheduler::FrameScheduler()
+:	mPeriod(0),
+	mNext(0)
+{
+	reset();
+}
+FrameScheduler::~FrameScheduler()
+{
+}
+
+void FrameScheduler::setRate(double fps)
+{
+	mPeriod = (fps > 0.0)? (int64_t)(1000000000.0 / fps + 0.5) : 0;
+	reset();
+}
+
+double FrameScheduler::getRate() const
+{
+	return (mPeriod)? (1000000000.0 / mPeriod) : 0.0;
+}
+
+void FrameScheduler::reset()
+{
+	mNext    = 0;
+	frames   = 0;
+	dropped  = 0;
+	missed   = 0;
+	lateness = 0;
+	worst    = 0;
+}
+
+/**
+ * Wait for the next frame slot while servicing the panel. Slots follow an
+ * absolute schedule, a late frame doesn't shift the ones after it, and when
+ * rendering overran whole slots they are dropped instead of being rendered
+ * in a burst to catch up, keeping latency at most one slot.
+ *
+ * @return	Slots since the previous frame, 0 on device error or exit.
+ */
+size_t FrameScheduler::waitFrame()
+{
+	const int64_t now = clock_getnstime(CLOCK_MONOTONIC);
+
+
+	frames++;
+	if(!mPeriod)
+		return 1;
+
+	// the first frame starts the schedule
+	if(!mNext)
+	{
+		mNext = now + mPeriod;
+		return 1;
+	}
+
+	if(now > mNext)
+	{
+		const int64_t behind = (now - mNext) / mPeriod;	// whole slots overrun
+
+		lateness = now - mNext;
+		worst    = std::max(worst, lateness);
+		missed++;
+		dropped += behind;
+
+		mNext += (behind +1) * mPeriod;
+		return behind +1;
+	}
+
+	lateness = 0;
+	if(!matrix.sleepUntil(mNext))
+		return 0;
+
+	mNext += mPeriod;
+	return 1;
+}
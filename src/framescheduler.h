@@ -0,0 +1,35 @@
+#ifndef XPM_FRAMESCHEDULER_H_
+#define XPM_FRAMESCHEDULER_H_
+
+
+// Fixed rate frame pacing against absolute deadlines, overrun frame slots are dropped rather than caught up
+class FrameScheduler
+{
+private:
+	int64_t				mPeriod;		// nanoseconds per frame slot, 0 when not pacing
+	int64_t				mNext;			// monotonic time the next frame slot starts, 0 before the first frame
+
+
+public:
+	size_t				frames;			// frames started since reset()
+	size_t				dropped;		// frame slots skipped after overruns
+	size_t				missed;			// frames started after their slot
+	int64_t				lateness;		// nanoseconds the last frame started after its slot
+	int64_t				worst;			// largest lateness since reset()
+
+
+	FrameScheduler();
+	~FrameScheduler();
+
+	// target frame rate, 0 to not pace, restarts the schedule
+	void   setRate(double fps);
+	double getRate() const;
+	void   reset();
+
+	// service the panel until the next frame slot, returns the number of slots since the previous frame,
+	// more than 1 when slots were dropped so animations can advance by that much, 0 on error or exit
+	size_t waitFrame();
+};
+
+
+#endif // XPM_FRAMESCHEDULER_H_
@@ -0,0 +1,396 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "framepalette.h"
+#include "framestream.h"
+#include "colorpipeline.h"
+#include "pixelformat.h"
+#include "framecompress.h"
+#include "simd.h"
+
+
+//=============================================================================
+// Direct framebuffer streaming class
+//=============================================================================
+FrameStream::FrameStream()
+:	mValid(false),
+	mFormat(rpcFrameFormat::RGB888),
+	mPaletteFixed(false),
+	mPaletteValid(false),
+	mCompression(true),
+	mPipeline(NULL),
+	packets(0),
+	segments(0),
+	compressed(0)
+{
+}
+FrameStream::~FrameStream()
+{
+}
+
+bool FrameStream::sendSegment(uint16_t index, const uint8_t *data, size_t size, uint8_t flags)
+{
+	uint8_t				packet[sizeof(tRPCFrameSegment) + RPCFB_SEGMENT_SIZE];
+	tRPCFrameSegment	header = { index };
+
+
+	memcpy(packet, &header, sizeof(header));
+	if(size)
+		memcpy(&packet[sizeof(header)], data, size);
+
+	packets++;
+	return rpc.sendTypeFrame(RPCFB_FLAG_ADDRESS | flags, packet, sizeof(header) + size);
+}
+
+bool FrameStream::supported(rpcFrameFormat format)
+{
+	return rpc.hasCapability(pixelFormatCapability(format));
+}
+
+/**
+ * Select the wire format of the frames send() streams. Reduced bit depths
+ * cut the bytes per frame by a third (RGB565) to two thirds (RGB332), the
+ * panel is switched over with the next frame sent.
+ *
+ * @param format	Wire format.
+ * @return	false if the panel doesn't advertise the format, nothing changes.
+ */
+bool FrameStream::setFormat(rpcFrameFormat format)
+{
+	if(!supported(format))
+		return false;
+
+	if(format != mFormat)
+	{
+		mFormat = format;
+		reset();
+
+		if(mPaletteFixed)
+			assignPalette();
+	}
+	return true;
+}
+
+void FrameStream::setPalette(const rgb24 *colors, size_t count)
+{
+	mPaletteFixed = (colors != NULL);
+	if(mPaletteFixed)
+	{
+		mPaletteColors.assign(colors, colors + count);
+		assignPalette();
+	}
+}
+
+// only the entries the format can address take part, the nearest match must not pick any others
+void FrameStream::assignPalette()
+{
+	const size_t colors = pixelFormatColors(mFormat);
+
+	mPalette.assign(mPaletteColors.data(), (colors)? std::min(mPaletteColors.size(), colors) : mPaletteColors.size());
+}
+
+/**
+ * Send the palette segments that differ from what the panel's drawing
+ * buffer holds.
+ *
+ * @param swap	Last segment swaps buffers, a bare swap marker if none differs.
+ * @return	false on device I/O error.
+ */
+bool FrameStream::sendPaletteSegments(bool swap)
+{
+	const size_t	size    = pixelFormatColors(mFormat) * sizeof(rgb24);
+	const size_t	count   = (size + RPCFB_SEGMENT_SIZE -1) / RPCFB_SEGMENT_SIZE;
+	size_t			pending = count;	// changed segment held back to carry the swap flag
+	uint8_t			data[RPCFB_PALETTE_SIZE * sizeof(rgb24)];
+
+
+	if(!matrix.setFrameFormat(mFormat))
+		return false;
+
+	// unused entries are black
+	memset(data, 0, sizeof(data));
+	memcpy(data, mPalette.colors().data(), std::min(size, mPalette.size() * sizeof(rgb24)));
+
+	if(mPaletteSent.size() != size)
+	{
+		mPaletteSent.assign(size, 0);
+		mPaletteValid = false;
+	}
+
+	for(size_t i=0; i<count; i++)
+	{
+		const size_t offset = i * RPCFB_SEGMENT_SIZE;
+		const size_t chunk  = std::min<size_t>(size - offset, RPCFB_SEGMENT_SIZE);
+
+		if(mPaletteValid && !memcmp(&data[offset], &mPaletteSent[offset], chunk))
+			continue;
+
+		if(!swap)
+		{
+			if(!sendSegment(RPCFB_SEGMENT_PALETTE | i, &data[offset], chunk, 0))
+				goto Abort;
+			continue;
+		}
+
+		if((pending < count) &&
+			!sendSegment(RPCFB_SEGMENT_PALETTE | pending, &data[pending * RPCFB_SEGMENT_SIZE], RPCFB_SEGMENT_SIZE, 0))
+			goto Abort;
+
+		pending = i;
+	}
+
+	if(swap)
+	{
+		if(pending < count)
+		{
+			if(!sendSegment(RPCFB_SEGMENT_PALETTE | pending, &data[pending * RPCFB_SEGMENT_SIZE],
+							std::min<size_t>(size - pending * RPCFB_SEGMENT_SIZE, RPCFB_SEGMENT_SIZE), RPCFB_FLAG_SWAP))
+				goto Abort;
+		} else
+		{
+			if(!sendSegment(RPCFB_SEGMENT_NONE, NULL, 0, RPCFB_FLAG_SWAP))
+				goto Abort;
+		}
+	}
+
+	memcpy(mPaletteSent.data(), data, size);
+	mPaletteValid = true;
+	return true;
+
+Abort:
+	mPaletteValid = false;
+	return false;
+}
+
+/**
+ * Send only the palette, for color cycling effects. The swap copies the
+ * displayed frame into the drawing buffer, so the panel shows the previous
+ * frame's pixels through the new palette.
+ *
+ * @return	false if the stream isn't indexed or on device I/O error.
+ */
+bool FrameStream::sendPalette()
+{
+	if(!pixelFormatIndexed(mFormat))
+		return false;
+
+	packets    = 0;
+	segments   = 0;
+	compressed = 0;
+	matrix.frameOverwritten();
+
+	return sendPaletteSegments(true);
+}
+
+/**
+ * Take the given frame as the reference for the next delta update, without
+ * sending anything. Only valid when the panel's drawing buffer really holds
+ * it, e.g. after drawing commands followed by a copying buffer swap.
+ */
+void FrameStream::assume(const uint8_t *data, size_t size)
+{
+	mPrevious.assign(data, data + size);
+	mValid = true;
+}
+
+size_t FrameStream::changed(const uint8_t *data, size_t size) const
+{
+	if(!mValid || (mPrevious.size() != size))
+		return (size + RPCFB_SEGMENT_SIZE -1) / RPCFB_SEGMENT_SIZE;
+
+	return compare(data, mPrevious.data(), size);
+}
+
+size_t FrameStream::compare(const uint8_t *a, const uint8_t *b, size_t size)
+{
+	size_t result = 0;
+
+
+	for(size_t offset = 0; offset < size; offset += RPCFB_SEGMENT_SIZE)
+	{
+		if(!simdEqual(&a[offset], &b[offset], std::min<size_t>(size - offset, RPCFB_SEGMENT_SIZE)))
+			result++;
+	}
+
+	return result;
+}
+
+/**
+ * Send a whole frame as sequential raster packets, the last one swaps buffers.
+ */
+bool FrameStream::sendFull(const uint8_t *data, size_t size)
+{
+	size_t offset, chunk;
+
+
+	packets    = 0;
+	segments   = 0;
+	compressed = 0;
+	if(!matrix.setFrameFormat(mFormat))
+		return false;
+	matrix.frameOverwritten();
+
+	// the raster stream doesn't define what the drawing buffer holds after the swap
+	mValid        = false;
+	mPaletteValid = false;
+
+	for(offset = 0; offset < size; offset += chunk)
+	{
+		uint8_t flags = 0;
+
+		chunk = std::min<size_t>(size - offset, RPCFB_RASTER_SIZE);
+		if(offset)
+			flags |= RPCFB_FLAG_APPEND;
+		if((offset + chunk) == size)
+			flags |= RPCFB_FLAG_SWAP;
+
+		if(!rpc.sendTypeFrame(flags, &data[offset], chunk))
+			return false;
+		packets++;
+	}
+
+	return true;
+}
+
+/**
+ * Send only the segments that changed since the previous delta frame, the
+ * last one swaps buffers. Anything else drawing to the panel in between
+ * requires a reset() first.
+ */
+bool FrameStream::sendDelta(const uint8_t *data, size_t size, size_t stride)
+{
+	const size_t	count    = (size + RPCFB_SEGMENT_SIZE -1) / RPCFB_SEGMENT_SIZE;
+	const bool		compress = mCompression && rpc.hasCapability(RPCCAP_FB_COMPRESSED);
+
+
+	packets    = 0;
+	segments   = 0;
+	compressed = 0;
+	if(!matrix.setFrameFormat(mFormat))
+		return false;
+	matrix.frameOverwritten();
+
+	// without a known drawing buffer every segment is sent
+	if(!mValid || (mPrevious.size() != size))
+	{
+		mPrevious.assign(size, 0);
+		mValid = false;
+	}
+
+	mChanged.clear();
+	for(size_t i=0; i<count; i++)
+	{
+		const size_t offset = i * RPCFB_SEGMENT_SIZE;
+		const size_t chunk  = std::min<size_t>(size - offset, RPCFB_SEGMENT_SIZE);
+
+		if(!mValid || !simdEqual(&data[offset], &mPrevious[offset], chunk))
+			mChanged.push_back(i);
+	}
+	segments = mChanged.size();
+
+	// bare swap marker when nothing changed
+	if(mChanged.empty() && !sendSegment(RPCFB_SEGMENT_NONE, NULL, 0, RPCFB_FLAG_SWAP))
+		goto Abort;
+
+	// in order, compressed segments may refer back to earlier ones, the last packet swaps
+	for(size_t i=0, covered; i<mChanged.size(); i+=covered)
+	{
+		const size_t	index = mChanged[i];
+		size_t			run, written = 0;
+
+		for(run = 1; ((i + run) < mChanged.size()) && (mChanged[i + run] == (index + run)); run++);
+
+		covered = 0;
+		if(compress && (run > 1))
+		{
+			uint8_t packet[RPCFB_RASTER_SIZE];
+
+			covered = frameCompress(data, size, stride, index, std::min<size_t>(run, 0xFF),
+									&packet[sizeof(tRPCFrameCompressed)], written);
+
+			// raw segments when compression doesn't save a packet
+			if(covered > 1)
+			{
+				tRPCFrameCompressed header = { (uint16_t)(index | RPCFB_SEGMENT_COMPRESSED), (uint8_t)covered };
+
+				memcpy(packet, &header, sizeof(header));
+				if(!rpc.sendTypeFrame(RPCFB_FLAG_ADDRESS | (((i + covered) == mChanged.size())? RPCFB_FLAG_SWAP : 0),
+									  packet, sizeof(header) + written))
+					goto Abort;
+
+				packets++;
+				compressed += covered;
+				continue;
+			}
+		}
+
+		covered = 1;
+		if(!sendSegment(index, &data[index * RPCFB_SEGMENT_SIZE],
+						std::min<size_t>(size - index * RPCFB_SEGMENT_SIZE, RPCFB_SEGMENT_SIZE),
+						((i +1) == mChanged.size())? RPCFB_FLAG_SWAP : 0))
+			goto Abort;
+	}
+
+	memcpy(mPrevious.data(), data, size);
+	mValid = true;
+	return true;
+
+Abort:
+	mValid        = false;
+	mPaletteValid = false;
+	return false;
+}
+
+bool FrameStream::send(const FrameBuffer &frame)
+{
+	const rgb24		*pixels = frame.pixels();
+	const uint8_t	*data;
+	size_t			 size = frame.size() * sizeof(rgb24);
+	size_t			 palette = 0;
+	bool			 result;
+
+
+	// color correction ahead of palette building and format conversion
+	if(mPipeline && !mPipeline->identity())
+	{
+		mCorrected.resize(frame.size());
+		mPipeline->apply(pixels, mCorrected.data(), frame.size());
+		pixels = mCorrected.data();
+	}
+	data = (const uint8_t *)pixels;
+
+	if(pixelFormatIndexed(mFormat))
+	{
+		const size_t colors = pixelFormatColors(mFormat);
+
+		if(!mPaletteFixed && !mPalette.exact(pixels, frame.size(), colors))
+			mPalette.medianCut(pixels, frame.size(), colors);
+
+		size = pixelFormatSize(mFormat, frame.size());
+		mConverted.resize(size);
+		mPalette.map(pixels, frame.size(), (mFormat == rpcFrameFormat::Indexed4)? 4 : 8, mConverted.data());
+		data = mConverted.data();
+
+		// palette changes ahead of the pixels, both take effect with the swap
+		packets = 0;
+		if(!sendPaletteSegments(false))
+			return false;
+		palette = packets;
+	} else
+	if(mFormat != rpcFrameFormat::RGB888)
+	{
+		size = pixelFormatSize(mFormat, frame.size());
+		mConverted.resize(size);
+		pixelFormatConvert(mFormat, pixels, frame.size(), mConverted.data());
+		data = mConverted.data();
+	}
+
+	if(rpc.hasCapability(RPCCAP_FB_SEGMENTS))
+		result = sendDelta(data, size, pixelFormatSize(mFormat, frame.width()));
+	else
+		result = sendFull(data, size);
+
+	packets += palette;
+	return result;
+}
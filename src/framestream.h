@@ -0,0 +1,84 @@
+#ifndef XPM_FRAMESTREAM_H_
+#define XPM_FRAMESTREAM_H_
+
+
+class FrameBuffer;
+class ColorPipeline;
+
+
+// Direct framebuffer streaming to the display panel, bypassing drawing commands
+class FrameStream
+{
+private:
+	std::vector<uint8_t>	mPrevious;		// last frame sent with delta streaming
+	bool					mValid;			// panel drawing buffer holds mPrevious
+	rpcFrameFormat			mFormat;		// wire format of the frames sent
+	std::vector<uint8_t>	mConverted;		// frame converted into mFormat
+	FramePalette			mPalette;		// indexed formats only
+	bool					mPaletteFixed;	// mPalette was assigned, rather than built per frame
+	std::vector<rgb24>		mPaletteColors;	// assigned palette, mPalette holds the entries mFormat can address
+	std::vector<uint8_t>	mPaletteSent;	// palette bytes the panel drawing buffer holds
+	bool					mPaletteValid;
+	bool					mCompression;	// compressed segments when the panel supports them
+	std::vector<size_t>		mChanged;		// segments a delta update sends
+	const ColorPipeline		*mPipeline;		// color correction of sent frames, NULL if none
+	std::vector<rgb24>		mCorrected;		// frame after color correction
+
+
+	bool sendSegment(uint16_t index, const uint8_t *data, size_t size, uint8_t flags);
+	bool sendPaletteSegments(bool swap);
+	void assignPalette();
+
+
+public:
+	size_t					packets;		// packets sent for the last frame
+	size_t					segments;		// changed segments sent for the last frame
+	size_t					compressed;		// changed segments sent in compressed packets for the last frame
+
+
+	FrameStream();
+	~FrameStream();
+
+	// forget previous frame, next delta update resends every segment
+	void reset()									{ mValid = false; mPaletteValid = false; }
+
+	// panel drawing buffer was brought to the given frame by other means, e.g. drawing commands
+	void assume(const uint8_t *data, size_t size);
+	bool valid() const								{ return mValid; }
+	// number of segments a delta update of the given frame would send
+	size_t changed(const uint8_t *data, size_t size) const;
+	// number of segments differing between two frames of the same size
+	static size_t compare(const uint8_t *a, const uint8_t *b, size_t size);
+
+	// wire format send() converts frames into, false if the panel doesn't support it
+	bool setFormat(rpcFrameFormat format);
+	rpcFrameFormat format() const					{ return mFormat; }
+	static bool supported(rpcFrameFormat format);
+
+	// indexed formats, persistent palette or NULL to build one per frame, exact if the
+	// frame has few enough colors else by median cut, entries past pixelFormatColors() are unused
+	void setPalette(const rgb24 *colors, size_t count);
+	const FramePalette& palette() const				{ return mPalette; }
+	// palette only update followed by a buffer swap, recolors the frame on the panel
+	bool sendPalette();
+
+	// frame data is expected in format(), converted sizes apply to the raw functions below
+	// whole frame as sequential raster packets, followed by a buffer swap
+	bool sendFull(const uint8_t *data, size_t size);
+	// only segments changed since the previous delta frame, followed by a buffer swap, stride
+	// is the row size in bytes helping compression
+	bool sendDelta(const uint8_t *data, size_t size, size_t stride = 0);
+
+	// compress runs of changed segments when the panel supports it, enabled by default
+	void setCompression(bool enable)				{ mCompression = enable; }
+
+	// color correction applied to frames send() streams, NULL for none, the pipeline is not copied
+	void setColorPipeline(const ColorPipeline *pipeline)	{ mPipeline = pipeline; }
+	const ColorPipeline* colorPipeline() const		{ return mPipeline; }
+
+	// picks delta streaming when the panel supports it
+	bool send(const FrameBuffer &frame);
+};
+
+
+#endif // XPM_FRAMESTREAM_H_
@@ -0,0 +1,316 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "ftfont.h"
+
+#ifdef HAVE_FREETYPE
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+
+//-----------------------------------------------------------------------------
+// Shared FreeType library and glyph cache
+//-----------------------------------------------------------------------------
+struct tFTCacheEntry
+{
+	uint64_t				key;
+	tFTGlyph				glyph;
+};
+
+static std::recursive_mutex m_FTLock;		// library, face creation and the cache
+static FT_Library			m_FTLibrary = NULL;
+static size_t				m_FTUsers   = 0;	// opened faces
+static uint32_t				m_FTFaceIds = 0;
+static std::list<tFTCacheEntry> m_FTCache;		// most recently used first
+static std::unordered_map<uint64_t, std::list<tFTCacheEntry>::iterator> m_FTIndex;
+
+
+static inline uint64_t glyphKey(uint32_t face, uint16_t size, uint32_t codepoint)
+{
+	return ((uint64_t)(face & 0xFFFFFF) << 40) | ((uint64_t)size << 24) | (codepoint & 0x1FFFFF);
+}
+
+uint32_t utf8Decode(const char *&text)
+{
+	const uint8_t	*s = (const uint8_t *)text;
+	uint32_t		 cp;
+	size_t			 extra;
+
+
+	if(s[0] < 0x80)			{ cp = s[0];		extra = 0; }
+	else if(s[0] < 0xC2)	{ text++; return 0xFFFD; }	// continuation or overlong lead byte
+	else if(s[0] < 0xE0)	{ cp = s[0] & 0x1F;	extra = 1; }
+	else if(s[0] < 0xF0)	{ cp = s[0] & 0x0F;	extra = 2; }
+	else if(s[0] < 0xF5)	{ cp = s[0] & 0x07;	extra = 3; }
+	else					{ text++; return 0xFFFD; }
+
+	for(size_t i=1; i<=extra; i++)
+	{
+		if((s[i] & 0xC0) != 0x80)
+		{
+			text += i;
+			return 0xFFFD;
+		}
+		cp = (cp << 6) | (s[i] & 0x3F);
+	}
+
+	text += extra +1;
+	return cp;
+}
+
+
+
+//=============================================================================
+// FreeType font class
+//=============================================================================
+FreeTypeFont::FreeTypeFont()
+:	mFace(NULL),
+	mFaceId(0),
+	mSize(0),
+	mAscender(0),
+	mLineHeight(0)
+{
+}
+FreeTypeFont::~FreeTypeFont()
+{
+	close();
+}
+
+bool FreeTypeFont::open(const char *path, uint16_t size, long faceIndex)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_FTLock);
+
+	FT_Face face;
+
+
+	if(mFace)
+		return false;
+
+	if(!m_FTLibrary && FT_Init_FreeType(&m_FTLibrary))
+	{
+		printf("%s error: FT_Init_FreeType() failed\n", __METHOD_NAME_C__);
+		m_FTLibrary = NULL;
+		return false;
+	}
+
+	if(FT_New_Face(m_FTLibrary, path, faceIndex, &face))
+	{
+		printf("%s error: can't open font '%s'\n", __METHOD_NAME_C__, path);
+		if(!m_FTUsers)
+		{
+			FT_Done_FreeType(m_FTLibrary);
+			m_FTLibrary = NULL;
+		}
+		return false;
+	}
+
+	m_FTUsers++;
+	mFace   = face;
+	mFaceId = ++m_FTFaceIds;
+	mSize   = 0;
+
+	if(!setSize(size))
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void FreeTypeFont::close()
+{
+	std::lock_guard<std::recursive_mutex> lock(m_FTLock);
+
+
+	if(!mFace)
+		return;
+
+	// cached glyphs of this face age out, its id isn't reused
+	FT_Done_Face((FT_Face)mFace);
+	mFace = NULL;
+
+	if(!--m_FTUsers)
+	{
+		FT_Done_FreeType(m_FTLibrary);
+		m_FTLibrary = NULL;
+	}
+}
+
+bool FreeTypeFont::setSize(uint16_t size)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_FTLock);
+
+	FT_Face face = (FT_Face)mFace;
+
+
+	if(!face || !size || FT_Set_Pixel_Sizes(face, 0, size))
+		return false;
+
+	mSize       = size;
+	mAscender   = (int16_t)((face->size->metrics.ascender + 63) >> 6);
+	mLineHeight = (int16_t)((face->size->metrics.height + 63) >> 6);
+	return true;
+}
+
+/**
+ * Lookup a rendered glyph, rasterizing it on a cache miss.
+ *
+ * @return	Glyph, NULL if the face can't render it. Valid until the next call.
+ */
+const tFTGlyph* FreeTypeFont::glyph(uint32_t codepoint)
+{
+	const uint64_t key = glyphKey(mFaceId, mSize, codepoint);
+
+
+	std::unordered_map<uint64_t, std::list<tFTCacheEntry>::iterator>::iterator found = m_FTIndex.find(key);
+	if(found != m_FTIndex.end())
+	{
+		m_FTCache.splice(m_FTCache.begin(), m_FTCache, found->second);
+		return &found->second->glyph;
+	}
+
+	FT_Face face = (FT_Face)mFace;
+	if(FT_Load_Char(face, codepoint, FT_LOAD_RENDER | FT_LOAD_TARGET_LIGHT))
+		return NULL;
+
+	// reuse the least recently used entry once the cache is full
+	if(m_FTCache.size() >= FTFONT_CACHE_GLYPHS)
+	{
+		m_FTIndex.erase(m_FTCache.back().key);
+		m_FTCache.splice(m_FTCache.begin(), m_FTCache, --m_FTCache.end());
+	} else
+		m_FTCache.push_front(tFTCacheEntry());
+
+	const FT_Bitmap	&bitmap = face->glyph->bitmap;
+	tFTCacheEntry	&entry  = m_FTCache.front();
+	tFTGlyph		&g      = entry.glyph;
+
+	entry.key = key;
+	g.width   = (int16_t)bitmap.width;
+	g.height  = (int16_t)bitmap.rows;
+	g.left    = (int16_t)face->glyph->bitmap_left;
+	g.top     = (int16_t)face->glyph->bitmap_top;
+	g.advance = (int16_t)((face->glyph->advance.x + 32) >> 6);
+	g.coverage.resize((size_t)g.width * g.height);
+
+	for(int r=0; r<g.height; r++)
+	{
+		const uint8_t	*src  = bitmap.buffer + (r * bitmap.pitch);
+		uint8_t			*dest = &g.coverage[r * g.width];
+
+		if(bitmap.pixel_mode == FT_PIXEL_MODE_MONO)
+		{
+			for(int c=0; c<g.width; c++)
+				dest[c] = (src[c / 8] & (0x80 >> (c % 8)))? 255 : 0;
+		} else
+			memcpy(dest, src, g.width);
+	}
+
+	m_FTIndex[key] = m_FTCache.begin();
+	return &g;
+}
+
+Point2I FreeTypeFont::measure(const char *text)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_FTLock);
+
+	int		width = 0, line = 0;
+	int		lines = 1;
+
+
+	if(!mFace || !*text)
+		return Point2I();
+
+	while(*text)
+	{
+		const uint32_t cp = utf8Decode(text);
+
+		if(cp == '\n')
+		{
+			width = std::max(width, line);
+			line  = 0;
+			lines++;
+			continue;
+		}
+
+		const tFTGlyph *g = glyph(cp);
+		if(g)
+			line += g->advance;
+	}
+
+	return Point2I((int16_t)std::max(width, line), (int16_t)(lines * mLineHeight));
+}
+
+void FreeTypeFont::draw(FrameBuffer &dest, int16_t x, int16_t y, const rgb24 &color, const char *text)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_FTLock);
+
+	int		pen      = x;
+	int		baseline = y + mAscender;
+
+
+	if(!mFace)
+		return;
+
+	while(*text)
+	{
+		const uint32_t cp = utf8Decode(text);
+
+		if(cp == '\n')
+		{
+			pen       = x;
+			baseline += mLineHeight;
+			continue;
+		}
+
+		const tFTGlyph *g = glyph(cp);
+		if(!g)
+			continue;
+
+		// coverage blended over what's there, clipped to the framebuffer
+		const int gx = pen + g->left;
+		const int gy = baseline - g->top;
+		const int c0 = std::max(0, -gx), c1 = std::min<int>(g->width,  dest.width()  - gx);
+		const int r0 = std::max(0, -gy), r1 = std::min<int>(g->height, dest.height() - gy);
+
+		for(int r=r0; r<r1; r++)
+		{
+			const uint8_t	*a = &g->coverage[r * g->width];
+			rgb24			*p = dest.row(gy + r) + gx;
+
+			for(int c=c0; c<c1; c++)
+			{
+				const uint32_t ca = a[c];
+				if(!ca)
+					continue;
+
+				const uint32_t ia = 255 - ca;
+				p[c].red   = (uint8_t)((color.red   * ca + p[c].red   * ia + 127) / 255);
+				p[c].green = (uint8_t)((color.green * ca + p[c].green * ia + 127) / 255);
+				p[c].blue  = (uint8_t)((color.blue  * ca + p[c].blue  * ia + 127) / 255);
+			}
+		}
+
+		pen += g->advance;
+	}
+}
+
+int FreeTypeFont::sprite(const char *text, const rgb24 &color, const rgb24 &background)
+{
+	const Point2I dims = measure(text);
+
+
+	if((dims.x <= 0) || (dims.y <= 0) || (dims.x > 255) || (dims.y > 255))
+		return 0;
+
+	FrameBuffer image(dims.x, dims.y);
+	image.fillScreen(background);
+	draw(image, 0, 0, color, text);
+
+	return matrix.spriteCreate((uint8_t)dims.x, (uint8_t)dims.y, image.pixels());
+}
+
+#endif // HAVE_FREETYPE
@@ -0,0 +1,64 @@
+#ifndef XPM_FTFONT_H_
+#define XPM_FTFONT_H_
+
+#ifdef HAVE_FREETYPE
+
+
+#define FTFONT_CACHE_GLYPHS		512		// rendered glyphs kept across all faces and sizes
+
+
+// Rendered glyph coverage, 0 - 255 per pixel
+struct tFTGlyph
+{
+	std::vector<uint8_t>	coverage;	// width * height
+	int16_t					width;
+	int16_t					height;
+	int16_t					left;		// from the pen position to the first column
+	int16_t					top;		// from the baseline up to the first row
+	int16_t					advance;	// pen movement in pixels
+};
+
+
+// TrueType/OpenType text through FreeType, glyphs are rasterized once and then drawn from a cache
+class FreeTypeFont
+{
+private:
+	void			*mFace;			// FT_Face, NULL while closed
+	uint32_t		 mFaceId;		// unique per opened face, part of the glyph cache key
+	uint16_t		 mSize;			// pixel height
+	int16_t			 mAscender;		// baseline below the top of a line
+	int16_t			 mLineHeight;
+
+
+	const tFTGlyph* glyph(uint32_t codepoint);
+
+
+public:
+	FreeTypeFont();
+	~FreeTypeFont();
+
+	bool open(const char *path, uint16_t size, long faceIndex = 0);
+	void close();
+	bool opened() const								{ return mFace != NULL; }
+
+	bool setSize(uint16_t size);
+	uint16_t getSize() const						{ return mSize; }
+	int16_t lineHeight() const						{ return mLineHeight; }
+
+	// UTF-8 text, '\n' starts a new line, same layout as the bitmap fonts' drawString()
+	Point2I measure(const char *text);
+	// antialiased onto the framebuffer, x and y are the top left of the first line
+	void draw(FrameBuffer &dest, int16_t x, int16_t y, const rgb24 &color, const char *text);
+	// render onto a background color into a panel sprite, draw it with the background as
+	// transparent color, returns the sprite handle or 0
+	int  sprite(const char *text, const rgb24 &color, const rgb24 &background);
+};
+
+
+// decode one UTF-8 sequence, advances text, malformed bytes decode as U+FFFD
+extern uint32_t utf8Decode(const char *&text);
+
+
+#endif // HAVE_FREETYPE
+
+#endif // XPM_FTFONT_H_
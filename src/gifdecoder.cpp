@@ -0,0 +1,525 @@
+#include <xpmcommon.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "image.h"
+#include "gifdecoder.h"
+
+
+#define GIF_LZW_CODES			4096	// 12 bit codes at most
+
+
+static std::list<GIFAnimation> gifCache;	// most recently used first
+
+
+//-----------------------------------------------------------------------------
+// Block parsing
+//-----------------------------------------------------------------------------
+static inline uint16_t le16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+// past the data sub-blocks starting at p, including their terminator
+static const uint8_t* skipBlocks(const uint8_t *p, const uint8_t *end)
+{
+	while(p < end)
+	{
+		const uint8_t length = *p++;
+		if(!length)
+			break;
+		p += length;
+	}
+
+	return std::min(p, end);
+}
+
+static void readPalette(rgb24 *dest, const uint8_t *p, int count)
+{
+	for(int i=0; i<count; i++, p += 3)
+		dest[i] = rgb24(p[0], p[1], p[2]);
+}
+
+/**
+ * Decompress one image's LZW data sub-blocks into color indices. Codes past
+ * count are dropped and a truncated stream leaves the rest of dest as is.
+ *
+ * @param p		Minimum code size byte, past the sub-block terminator on return.
+ * @return	false if the code size is invalid.
+ */
+static bool lzwDecode(uint8_t *dest, size_t count, const uint8_t *&p, const uint8_t *end)
+{
+	uint16_t	prefix[GIF_LZW_CODES];
+	uint8_t		suffix[GIF_LZW_CODES];
+	uint8_t		stack[GIF_LZW_CODES +1];
+	uint32_t	bits   = 0;
+	int			nbits  = 0;
+	size_t		block  = 0;		// bytes left in the current sub-block
+	size_t		out    = 0;
+	bool		ended  = false;	// terminator sub-block read
+
+
+	if(p >= end)
+		return false;
+
+	const int minSize = *p++;
+	if((minSize < 1) || (minSize > 8))
+		return false;
+
+	const int	clear = 1 << minSize;
+	const int	eoi   = clear +1;
+	int			size  = minSize +1;
+	int			next  = clear +2;
+	int			old   = -1;
+	uint8_t		first = 0;
+
+	for(int i=0; i<clear; i++)
+	{
+		prefix[i] = 0;
+		suffix[i] = i;
+	}
+
+	while(out < count)
+	{
+		while(!ended && (nbits < size) && (p < end))
+		{
+			if(!block)
+			{
+				if(!(block = *p++))
+					ended = true;
+				continue;
+			}
+
+			bits  |= *p++ << nbits;
+			nbits += 8;
+			block--;
+		}
+
+		if(nbits < size)
+			break;
+
+		int code = bits & ((1 << size) -1);
+		bits  >>= size;
+		nbits  -= size;
+
+		if(code == clear)
+		{
+			size = minSize +1;
+			next = clear +2;
+			old  = -1;
+			continue;
+		}
+		if(code == eoi)
+			break;
+
+		if(old < 0)
+		{
+			if(code >= clear)
+				break;
+
+			dest[out++] = first = code;
+			old = code;
+			continue;
+		}
+
+		// a code not in the table yet is the previous string plus its own first index
+		const int	in = code;
+		size_t		sp = 0;
+
+		if(code >= next)
+		{
+			if(code > next)
+				break;
+
+			stack[sp++] = first;
+			code = old;
+		}
+
+		while(code >= clear)
+		{
+			stack[sp++] = suffix[code];
+			code = prefix[code];
+		}
+
+		stack[sp++] = first = code;
+		while(sp && (out < count))
+			dest[out++] = stack[--sp];
+
+		if(next < GIF_LZW_CODES)
+		{
+			prefix[next] = old;
+			suffix[next] = first;
+			if((++next == (1 << size)) && (size < 12))
+				size++;
+		}
+
+		old = in;
+	}
+
+	if(!ended)
+		p = skipBlocks(std::min(p + block, end), end);
+	return true;
+}
+
+// area of each frame that differs from the one before, the first one's from the last
+static void changedAreas(std::vector<tGIFFrame> &frames)
+{
+	const size_t count = frames.size();
+
+
+	for(size_t i=0; i<count; i++)
+	{
+		tGIFFrame			&f    = frames[i];
+		const FrameBuffer	&prev = frames[(i + count -1) % count].image;
+		const size_t		 row  = f.image.width() * sizeof(rgb24);
+
+		f.x0 = f.image.width();
+		f.y0 = f.image.height();
+		f.x1 = -1;
+		f.y1 = -1;
+
+		for(int16_t y=0; y<f.image.height(); y++)
+		{
+			const rgb24 *a = f.image.row(y);
+			const rgb24 *b = prev.row(y);
+
+			if(!memcmp((const uint8_t *)a, (const uint8_t *)b, row))
+				continue;
+
+			int16_t x0 = 0, x1 = f.image.width() -1;
+			while(!memcmp((const uint8_t *)&a[x0], (const uint8_t *)&b[x0], sizeof(rgb24)))
+				x0++;
+			while(!memcmp((const uint8_t *)&a[x1], (const uint8_t *)&b[x1], sizeof(rgb24)))
+				x1--;
+
+			f.x0 = std::min(f.x0, x0);
+			f.x1 = std::max(f.x1, x1);
+			f.y0 = std::min(f.y0, y);
+			f.y1 = y;
+		}
+	}
+}
+
+
+
+//=============================================================================
+// GIF animation class
+//=============================================================================
+GIFAnimation::GIFAnimation()
+:	mWidth(0),
+	mHeight(0),
+	mLoops(0),
+	mMTime({0, 0}),
+	mFileSize(0)
+{
+}
+GIFAnimation::~GIFAnimation()
+{
+}
+
+void GIFAnimation::clear()
+{
+	mFrames.clear();
+	mScaled.clear();
+	mWidth    = 0;
+	mHeight   = 0;
+	mLoops    = 0;
+	mPath.clear();
+	mMTime    = {0, 0};
+	mFileSize = 0;
+}
+
+/**
+ * Decode all frames of a GIF87a or GIF89a file. Frames are composited onto
+ * a black canvas the way they show, so playing one needs no state but the
+ * frame before it.
+ *
+ * @param path	GIF file.
+ * @return	false if the file can't be read or has no frames.
+ */
+bool GIFAnimation::load(const char *path)
+{
+	struct stat	 st;
+	bool		 result = false;
+	const int	 fd     = open(path, O_RDONLY);
+
+
+	clear();
+	if(fd < 0)
+	{
+		printf("%s error: can't open GIF '%s'\n", __METHOD_NAME_C__, path);
+		return false;
+	}
+
+	if((fstat(fd, &st) != 0) || (st.st_size < 13))
+	{
+		close(fd);
+		return false;
+	}
+
+	const size_t	 size = st.st_size;
+	void			*map  = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	close(fd);
+	if(map == MAP_FAILED)
+		return false;
+
+	madvise(map, size, MADV_SEQUENTIAL);
+
+	if(!(result = decode((const uint8_t *)map, size)))
+	{
+		printf("%s error: unsupported GIF '%s'\n", __METHOD_NAME_C__, path);
+		clear();
+	} else
+	{
+		mPath     = path;
+		mMTime    = st.st_mtim;
+		mFileSize = st.st_size;
+	}
+
+	munmap(map, size);
+	return result;
+}
+
+bool GIFAnimation::current(const char *path) const
+{
+	struct stat st;
+
+
+	return (mPath == path) && (stat(path, &st) == 0) && (mMTime.tv_sec == st.st_mtim.tv_sec) &&
+		   (mMTime.tv_nsec == st.st_mtim.tv_nsec) && (mFileSize == st.st_size);
+}
+
+bool GIFAnimation::decode(const uint8_t *data, size_t size)
+{
+	const uint8_t	*end = data + size;
+	rgb24			 global[256];
+	rgb24			 local[256];
+	int				 globalCount = 0;
+	std::vector<uint8_t> indices;
+
+	// graphic control extension of the next image
+	int				 disposal    = 0;
+	int				 transparent = -1;
+	uint16_t		 delay       = 0;
+
+
+	if((size < 13) || memcmp(data, "GIF8", 4))
+		return false;
+
+	mWidth  = le16(data + 6);
+	mHeight = le16(data + 8);
+	if((mWidth <= 0) || (mHeight <= 0) || (mWidth > IMAGE_SIZE_MAX) || (mHeight > IMAGE_SIZE_MAX))
+		return false;
+
+	const uint8_t *p = data + 13;
+	if(data[10] & 0x80)
+	{
+		globalCount = 2 << (data[10] & 7);
+		if((end - p) < (globalCount * 3))
+			return false;
+
+		readPalette(global, p, globalCount);
+		p += globalCount * 3;
+	}
+
+	FrameBuffer canvas(mWidth, mHeight);
+	FrameBuffer previous;
+
+	while((p < end) && (mFrames.size() < GIF_FRAMES_MAX))
+	{
+		const uint8_t block = *p++;
+
+		// trailer
+		if(block == 0x3B)
+			break;
+
+		if(block == 0x21)
+		{
+			if(p >= end)
+				break;
+
+			const uint8_t label = *p++;
+			if((label == 0xF9) && ((end - p) >= 6) && (p[0] >= 4))
+			{
+				disposal    = (p[1] >> 2) & 7;
+				transparent = (p[1] & 1)? p[4] : -1;
+				delay       = le16(p + 2) * 10;
+				if(delay < GIF_DELAY_MIN)
+					delay = 0;
+			} else if((label == 0xFF) && ((end - p) >= 16) && (p[0] == 11) && !memcmp(p +1, "NETSCAPE2.0", 11) &&
+					  (p[12] >= 3) && (p[13] == 1))
+				mLoops = le16(p + 14);
+
+			p = skipBlocks(p, end);
+			continue;
+		}
+
+		if((block != 0x2C) || ((end - p) < 9))
+			break;
+
+		// image descriptor, optionally followed by its own palette
+		const int		 left    = le16(p);
+		const int		 top     = le16(p + 2);
+		const int		 width   = le16(p + 4);
+		const int		 height  = le16(p + 6);
+		const uint8_t	 flags   = p[8];
+		const rgb24		*palette = global;
+		int				 count   = globalCount;
+
+		p += 9;
+		if(flags & 0x80)
+		{
+			count = 2 << (flags & 7);
+			if((end - p) < (count * 3))
+				break;
+
+			readPalette(local, p, count);
+			palette = local;
+			p += count * 3;
+		}
+
+		indices.assign((size_t)width * height, 0);
+		if(!lzwDecode(indices.data(), indices.size(), p, end))
+			break;
+
+		if(disposal == 3)
+			previous.copy(canvas);
+
+		// interlaced rows come in passes of every 8th row, every 8th from 4, every 4th from 2, every 2nd from 1
+		static const int passStart[4] = { 0, 4, 2, 1 };
+		static const int passStep[4]  = { 8, 8, 4, 2 };
+		int pass = 0, row = 0;
+
+		for(int r=0; r<height; r++)
+		{
+			const uint8_t *src = &indices[(size_t)r * width];
+			int y = r;
+
+			if(flags & 0x40)
+			{
+				while(row >= height)
+					row = passStart[++pass];
+				y = row;
+				row += passStep[pass];
+			}
+
+			if((top + y) >= mHeight)
+				continue;
+
+			rgb24 *dest = canvas.row(top + y);
+			for(int x=0; (x < width) && ((left + x) < mWidth); x++)
+			{
+				if((src[x] != transparent) && (src[x] < count))
+					dest[left + x] = palette[src[x]];
+			}
+		}
+
+		mFrames.push_back(tGIFFrame());
+		mFrames.back().image.copy(canvas);
+		mFrames.back().delay = delay;
+
+		// what the next frame is drawn onto
+		if(disposal == 2)
+			canvas.fillRectangle(left, top, left + width -1, top + height -1, rgb24(0, 0, 0), rgb24(0, 0, 0));
+		else if(disposal == 3)
+			canvas.copy(previous);
+
+		disposal    = 0;
+		transparent = -1;
+		delay       = 0;
+	}
+
+	if(mFrames.empty())
+		return false;
+
+	changedAreas(mFrames);
+	return true;
+}
+
+/**
+ * Frames fitted into a target size, resampled from the decoded ones on the
+ * first call for that size.
+ *
+ * @param width		Target width, 0 together with height for the canvas size.
+ * @param height	Target height.
+ * @return	Frames, empty if nothing is loaded.
+ */
+const std::vector<tGIFFrame>& GIFAnimation::frames(int16_t width, int16_t height)
+{
+	if((!width && !height) || ((width == mWidth) && (height == mHeight)) || mFrames.empty())
+		return mFrames;
+
+	// largest size of the canvas' aspect ratio that fits
+	int w = width? width : mWidth;
+	int h = (mHeight * w) / mWidth;
+	if(height && (h > height))
+	{
+		h = height;
+		w = (mWidth * h) / mHeight;
+	}
+	w = std::max(w, 1);
+	h = std::max(h, 1);
+
+	if(!mScaled.empty() && (mScaled[0].image.width() == w) && (mScaled[0].image.height() == h))
+		return mScaled;
+
+	mScaled.resize(mFrames.size());
+	for(size_t i=0; i<mFrames.size(); i++)
+	{
+		imageResample(mScaled[i].image, mFrames[i].image, w, h);
+		mScaled[i].delay = mFrames[i].delay;
+	}
+
+	changedAreas(mScaled);
+	return mScaled;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Decoded animation cache
+//-----------------------------------------------------------------------------
+/**
+ * Look up a GIF by path, decoding it on a miss or when the file changed
+ * since. Files that don't exist on the host are expected to be on the
+ * panel's filesystem and fail silently.
+ *
+ * @return	Animation or NULL.
+ */
+GIFAnimation* gifCacheGet(const char *path)
+{
+	if(access(path, R_OK) != 0)
+		return NULL;
+
+	for(auto it = gifCache.begin(); it != gifCache.end(); ++it)
+	{
+		if(it->path() != path)
+			continue;
+
+		gifCache.splice(gifCache.begin(), gifCache, it);
+		if(!gifCache.front().current(path) && !gifCache.front().load(path))
+		{
+			gifCache.pop_front();
+			return NULL;
+		}
+		return &gifCache.front();
+	}
+
+	gifCache.emplace_front();
+	if(!gifCache.front().load(path))
+	{
+		gifCache.pop_front();
+		return NULL;
+	}
+
+	while(gifCache.size() > GIF_CACHE_ENTRIES)
+		gifCache.pop_back();
+
+	return &gifCache.front();
+}
@@ -0,0 +1,63 @@
+#ifndef XPM_GIFDECODER_H_
+#define XPM_GIFDECODER_H_
+
+
+#define GIF_FRAMES_MAX			1024	// larger animations are cut short
+#define GIF_CACHE_ENTRIES		4		// decoded animations kept by gifCacheGet()
+#define GIF_DELAY_MIN			20		// msec, shorter frame delays are taken as none like browsers do
+
+
+// Animation frame, the whole canvas as it looks while the frame shows
+struct tGIFFrame
+{
+	FrameBuffer				image;
+	uint16_t				delay;			// msec, 0 when the file gives none or less than GIF_DELAY_MIN
+	int16_t					x0, y0;			// inclusive area changed since the previous frame, the last
+	int16_t					x1, y1;			// one's for the first frame, x0 > x1 if none
+};
+
+
+// GIF decoded into pre-composited frames, disposal methods and transparency already applied
+class GIFAnimation
+{
+private:
+	std::vector<tGIFFrame>	mFrames;		// canvas size
+	std::vector<tGIFFrame>	mScaled;		// of the last frames() size other than the canvas'
+	int16_t					mWidth;
+	int16_t					mHeight;
+	uint16_t				mLoops;			// 0 forever
+	string					mPath;
+	struct timespec			mMTime;
+	off_t					mFileSize;
+
+
+	bool decode(const uint8_t *data, size_t size);
+
+
+public:
+	GIFAnimation();
+	~GIFAnimation();
+
+	// decode every frame of a GIF file, false if it isn't one or has no frames
+	bool load(const char *path);
+	void clear();
+	// the file loaded last hasn't changed since
+	bool current(const char *path) const;
+
+	int16_t width() const							{ return mWidth; }
+	int16_t height() const							{ return mHeight; }
+	uint16_t loops() const							{ return mLoops; }
+	const string& path() const						{ return mPath; }
+
+	// frames scaled into width x height keeping their aspect ratio, 0 for the canvas size, scaled
+	// once per size change
+	const std::vector<tGIFFrame>& frames(int16_t width = 0, int16_t height = 0);
+};
+
+
+// decoded animation of a file, decoded again once it changed, NULL if there is no such GIF on the
+// host, valid until GIF_CACHE_ENTRIES other files have been asked for
+GIFAnimation* gifCacheGet(const char *path);
+
+
+#endif // XPM_GIFDECODER_H_
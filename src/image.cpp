@@ -0,0 +1,611 @@
+#include <xpmcommon.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ctype.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "image.h"
+
+#ifdef HAVE_LIBPNG
+#include <png.h>
+#endif
+
+
+#define IMAGE_WEIGHT_BITS		14		// resampling weights of one output pixel sum up to 1 << bits
+
+
+ImageCache imageCache;
+
+
+//-----------------------------------------------------------------------------
+// Decoders, all of them read straight from the mapped file
+//-----------------------------------------------------------------------------
+
+// skip whitespace and comments, read an unsigned decimal
+static bool pnmNumber(const uint8_t *&p, const uint8_t *end, uint32_t &value)
+{
+	while(p < end)
+	{
+		if(*p == '#')
+		{
+			while((p < end) && (*p != '\n'))
+				p++;
+		} else if(isspace(*p))
+			p++;
+		else
+			break;
+	}
+
+	if((p >= end) || !isdigit(*p))
+		return false;
+
+	for(value = 0; (p < end) && isdigit(*p); p++)
+	{
+		value = (value * 10) + (*p - '0');
+		if(value > 65535)
+			return false;
+	}
+
+	return true;
+}
+
+// P2/P3 ASCII and P5/P6 binary gray or rgb, 8 or 16 bit samples
+static bool decodePNM(FrameBuffer &dest, const uint8_t *data, size_t size)
+{
+	const uint8_t	*end    = data + size;
+	const uint8_t	*p      = data +2;
+	const bool		 gray   = (data[1] == '2') || (data[1] == '5');
+	const bool		 binary = (data[1] == '5') || (data[1] == '6');
+	uint32_t		 width, height, maxval;
+
+
+	if(!pnmNumber(p, end, width) || !pnmNumber(p, end, height) || !pnmNumber(p, end, maxval) ||
+		!width || !height || !maxval || (width > IMAGE_SIZE_MAX) || (height > IMAGE_SIZE_MAX))
+		return false;
+
+	const size_t channels = gray? 1 : 3;
+	const size_t bytes    = (maxval > 255)? 2 : 1;
+	const size_t samples  = (size_t)width * height * channels;
+
+	// single whitespace between header and binary samples
+	if(binary && ((++p > end) || ((size_t)(end - p) < (samples * bytes))))
+		return false;
+
+	dest.resize(width, height);
+	uint8_t *out = (uint8_t *)dest.pixels();
+
+	// common case, plain rgb bytes
+	if(binary && !gray && (maxval == 255))
+	{
+		memcpy(out, p, samples);
+		return true;
+	}
+
+	for(size_t i=0; i<samples; i++)
+	{
+		uint32_t v;
+
+		if(binary)
+		{
+			v  = (bytes == 2)? ((p[0] << 8) | p[1]) : p[0];
+			p += bytes;
+		} else if(!pnmNumber(p, end, v))
+			return false;
+
+		// gray samples go to all three channels
+		v = ((std::min(v, maxval) * 255) + (maxval / 2)) / maxval;
+		for(size_t n = gray? 3 : 1; n; n--)
+			*out++ = (uint8_t)v;
+	}
+
+	return true;
+}
+
+// 8 bit value of a bit field channel
+static uint8_t bmpChannel(uint32_t value, uint32_t mask)
+{
+	if(!mask)
+		return 0;
+
+	const uint32_t shift = __builtin_ctz(mask);
+	const uint32_t max   = mask >> shift;
+
+	return (uint8_t)(((((value & mask) >> shift) * 255) + (max / 2)) / max);
+}
+
+// uncompressed 1, 4, 8 bit indexed, 16, 24 or 32 bit, bottom up or top down
+static bool decodeBMP(FrameBuffer &dest, const uint8_t *data, size_t size)
+{
+	if(size < 54)
+		return false;
+
+	const uint8_t	*h           = data + 14;
+	const uint32_t	 offset      = UInt8PToUInt32((data + 10));
+	const uint32_t	 headerSize  = UInt8PToUInt32(h);
+	const int32_t	 width       = (int32_t)UInt8PToUInt32((h + 4));
+	const int32_t	 height      = (int32_t)UInt8PToUInt32((h + 8));
+	const uint16_t	 bpp         = UInt8PToUInt16((h + 14));
+	const uint32_t	 compression = UInt8PToUInt32((h + 16));
+	const uint32_t	 colorsUsed  = UInt8PToUInt32((h + 32));
+	const bool		 topDown     = (height < 0);
+	const uint32_t	 rows        = topDown? -height : height;
+	uint32_t		 masks[3];
+
+
+	// BI_RGB, or BI_BITFIELDS with 16 or 32 bit
+	if((headerSize < 40) || ((14 + headerSize) > offset) || (width <= 0) || !rows ||
+		(width > IMAGE_SIZE_MAX) || (rows > IMAGE_SIZE_MAX) ||
+		((bpp != 1) && (bpp != 4) && (bpp != 8) && (bpp != 16) && (bpp != 24) && (bpp != 32)) ||
+		((compression != 0) && ((compression != 3) || ((bpp != 16) && (bpp != 32)))))
+	{
+		printf("%s error: unsupported bitmap, %u bit, compression %u\n", __METHOD_NAME_C__, bpp, compression);
+		return false;
+	}
+
+	const size_t pitch = ((((size_t)width * bpp) + 31) / 32) * 4;
+	if((offset > size) || ((size - offset) < (pitch * rows)))
+		return false;
+
+	// channel masks follow the 40 byte header, or are part of larger ones
+	if(compression == 3)
+	{
+		if((14 + 40 + 12) > size)
+			return false;
+		for(size_t i=0; i<3; i++)
+			masks[i] = UInt8PToUInt32((h + 40 + (i * 4)));
+	} else if(bpp == 16)
+	{
+		masks[0] = 0x7C00;	masks[1] = 0x03E0;	masks[2] = 0x001F;
+	} else
+	{
+		masks[0] = 0xFF0000;	masks[1] = 0x00FF00;	masks[2] = 0x0000FF;
+	}
+
+	// palette of blue, green, red, reserved quads
+	const uint8_t	*palette = h + headerSize;
+	size_t			 colors  = 0;
+
+	if(bpp <= 8)
+	{
+		colors = colorsUsed? std::min<size_t>(colorsUsed, 1 << bpp) : (1 << bpp);
+		if((palette + (colors * 4)) > (data + offset))
+			return false;
+	}
+
+	dest.resize(width, rows);
+
+	for(uint32_t r=0; r<rows; r++)
+	{
+		const uint8_t	*src = data + offset + (pitch * (topDown? r : (rows -1 - r)));
+		rgb24			*out = dest.row(r);
+
+		for(int32_t c=0; c<width; c++)
+		{
+			if(bpp <= 8)
+			{
+				const size_t	bit   = (size_t)c * bpp;
+				const uint32_t	index = (src[bit / 8] >> (8 - bpp - (bit % 8))) & ((1 << bpp) -1);
+
+				if(index < colors)
+					out[c] = rgb24(palette[(index * 4) +2], palette[(index * 4) +1], palette[index * 4]);
+			} else if(bpp == 24)
+			{
+				const uint8_t *px = src + (c * 3);
+				out[c] = rgb24(px[2], px[1], px[0]);
+			} else
+			{
+				const uint8_t	*px = src + (c * (bpp / 8));
+				const uint32_t	 v  = (bpp == 16)? UInt8PToUInt16(px) : UInt8PToUInt32(px);
+
+				out[c] = rgb24(bmpChannel(v, masks[0]), bmpChannel(v, masks[1]), bmpChannel(v, masks[2]));
+			}
+		}
+	}
+
+	return true;
+}
+
+#ifdef HAVE_LIBPNG
+// any PNG, alpha composed onto black
+static bool decodePNG(FrameBuffer &dest, const uint8_t *data, size_t size)
+{
+	png_image	png;
+	png_color	black = { 0, 0, 0 };
+
+
+	memset(&png, 0, sizeof(png));
+	png.version = PNG_IMAGE_VERSION;
+
+	if(!png_image_begin_read_from_memory(&png, data, size))
+	{
+		printf("%s error: %s\n", __METHOD_NAME_C__, png.message);
+		return false;
+	}
+
+	if((png.width > IMAGE_SIZE_MAX) || (png.height > IMAGE_SIZE_MAX))
+	{
+		png_image_free(&png);
+		return false;
+	}
+
+	png.format = PNG_FORMAT_RGB;
+	dest.resize(png.width, png.height);
+
+	if(!png_image_finish_read(&png, &black, dest.pixels(), 0, NULL))
+	{
+		printf("%s error: %s\n", __METHOD_NAME_C__, png.message);
+		return false;
+	}
+
+	return true;
+}
+#endif
+
+/**
+ * Decode an image file, the format is taken from its signature rather than
+ * the file name. The file is mapped rather than read, decoders convert
+ * straight from the mapping into the framebuffer.
+ *
+ * @param dest	Framebuffer resized to the image.
+ * @param path	Image file.
+ * @return	false if the file can't be read or its format isn't supported.
+ */
+bool imageLoad(FrameBuffer &dest, const char *path)
+{
+	struct stat	 st;
+	bool		 result = false;
+	const int	 fd     = open(path, O_RDONLY);
+
+
+	if(fd < 0)
+	{
+		printf("%s error: can't open image '%s'\n", __METHOD_NAME_C__, path);
+		return false;
+	}
+
+	if((fstat(fd, &st) != 0) || (st.st_size < 4))
+	{
+		close(fd);
+		return false;
+	}
+
+	const size_t	 size = st.st_size;
+	void			*map  = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	close(fd);
+	if(map == MAP_FAILED)
+		return false;
+
+	// one pass front to back
+	madvise(map, size, MADV_SEQUENTIAL);
+
+	const uint8_t *data = (const uint8_t *)map;
+
+	if((data[0] == 'P') && (data[1] >= '2') && (data[1] <= '6') && (data[1] != '4'))
+		result = decodePNM(dest, data, size);
+	else if((data[0] == 'B') && (data[1] == 'M'))
+		result = decodeBMP(dest, data, size);
+#ifdef HAVE_LIBPNG
+	else if(!memcmp(data, "\x89PNG", 4))
+		result = decodePNG(dest, data, size);
+#endif
+	else
+		printf("%s error: unsupported image format '%s'\n", __METHOD_NAME_C__, path);
+
+	munmap(map, size);
+	return result;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Area averaging resampler
+//-----------------------------------------------------------------------------
+struct tResampleAxis
+{
+	std::vector<int>		first;		// first source index per output index
+	std::vector<uint16_t>	count;		// source pixels per output index
+	std::vector<uint16_t>	weights;	// taps per output index, zero padded
+	size_t					taps;
+};
+
+/**
+ * Weights of the source pixels each output pixel covers, partially covered
+ * ones by their overlap, in 16.16 fixed point source coordinates.
+ */
+static void resampleAxis(tResampleAxis &axis, int offset, int src, int dest)
+{
+	const uint32_t one = 1 << IMAGE_WEIGHT_BITS;
+
+	axis.taps = ((src + dest -1) / dest) +1;
+	axis.first.resize(dest);
+	axis.count.resize(dest);
+	axis.weights.assign(dest * axis.taps, 0);
+
+	for(int i=0; i<dest; i++)
+	{
+		const uint64_t	 a      = ((uint64_t)i * src << 16) / dest;
+		const uint64_t	 b      = ((uint64_t)(i +1) * src << 16) / dest;
+		const uint64_t	 j0     = a >> 16;
+		uint16_t		*w      = &axis.weights[i * axis.taps];
+		uint32_t		 total  = 0;
+		size_t			 widest = 0;
+		size_t			 t;
+
+		for(t=0; (t < axis.taps) && (((j0 + t) << 16) < b); t++)
+		{
+			const uint64_t lo = std::max<uint64_t>(a, (j0 + t) << 16);
+			const uint64_t hi = std::min<uint64_t>(b, (j0 + t +1) << 16);
+
+			w[t]   = (uint16_t)(((hi - lo) * one) / (b - a));
+			total += w[t];
+			if(w[t] > w[widest])
+				widest = t;
+		}
+
+		// rounding remainder, weights always add up to one
+		w[widest]    += one - total;
+		axis.first[i] = offset + (int)j0;
+		axis.count[i] = (uint16_t)t;
+	}
+}
+
+// src area sw x sh at sx, sy into dest area dw x dh at dx, dy, horizontal pass then vertical
+static void resampleArea(FrameBuffer &dest, int dx, int dy, int dw, int dh,
+						 const FrameBuffer &src, int sx, int sy, int sw, int sh)
+{
+	const uint32_t round = 1 << (IMAGE_WEIGHT_BITS -1);
+
+	if((sw == dw) && (sh == dh))
+	{
+		for(int r=0; r<dh; r++)
+			memcpy((uint8_t *)(dest.row(dy + r) + dx), (const uint8_t *)(src.row(sy + r) + sx), dw * sizeof(rgb24));
+		return;
+	}
+
+	tResampleAxis			 ax, ay;
+	std::vector<uint8_t>	 tmp((size_t)dw * sh * 3);
+	std::vector<uint32_t>	 acc((size_t)dw * 3);
+
+	resampleAxis(ax, sx, sw, dw);
+	resampleAxis(ay, 0,  sh, dh);
+
+	for(int r=0; r<sh; r++)
+	{
+		const uint8_t	*in  = (const uint8_t *)src.row(sy + r);
+		uint8_t			*out = &tmp[(size_t)r * dw * 3];
+
+		for(int x=0; x<dw; x++, out += 3)
+		{
+			const uint16_t	*w  = &ax.weights[x * ax.taps];
+			const uint8_t	*px = in + (ax.first[x] * 3);
+			uint32_t		 s0 = round, s1 = round, s2 = round;
+
+			for(size_t t=0; t<ax.count[x]; t++, px += 3)
+			{
+				s0 += px[0] * w[t];
+				s1 += px[1] * w[t];
+				s2 += px[2] * w[t];
+			}
+
+			out[0] = s0 >> IMAGE_WEIGHT_BITS;
+			out[1] = s1 >> IMAGE_WEIGHT_BITS;
+			out[2] = s2 >> IMAGE_WEIGHT_BITS;
+		}
+	}
+
+	// whole rows at a time, keeps the vertical pass sequential in memory
+	for(int y=0; y<dh; y++)
+	{
+		const uint16_t *w = &ay.weights[y * ay.taps];
+
+		std::fill(acc.begin(), acc.end(), round);
+		for(size_t t=0; t<ay.count[y]; t++)
+		{
+			const uint8_t *in = &tmp[(size_t)(ay.first[y] + t) * dw * 3];
+
+			for(size_t i=0; i<acc.size(); i++)
+				acc[i] += in[i] * w[t];
+		}
+
+		uint8_t *out = (uint8_t *)(dest.row(dy + y) + dx);
+		for(size_t i=0; i<acc.size(); i++)
+			out[i] = acc[i] >> IMAGE_WEIGHT_BITS;
+	}
+}
+
+/**
+ * Bring an image to a target size, see imageFit. Averaging all source pixels
+ * under an output pixel keeps detail from aliasing when shrinking photos to
+ * panel size.
+ *
+ * @param dest			Resized to width x height, source size with imageFit::None.
+ * @param src			Image to resample, must not be dest.
+ * @param background	Border color of imageFit::Contain.
+ * @return	false if either size is empty.
+ */
+bool imageResample(FrameBuffer &dest, const FrameBuffer &src, int16_t width, int16_t height, imageFit fit,
+				   const rgb24 &background)
+{
+	const int sw = src.width();
+	const int sh = src.height();
+
+
+	if(!sw || !sh)
+		return false;
+
+	if(fit == imageFit::None)
+	{
+		dest.copy(src);
+		return true;
+	}
+
+	if((width <= 0) || (height <= 0))
+		return false;
+
+	dest.resize(width, height);
+
+	switch(fit)
+	{
+		case imageFit::Contain:
+		{
+			// limited by height or width, whichever is the tighter one
+			int dw = width;
+			int dh = height;
+
+			if((sw * height) <= (width * sh))
+				dw = std::max(1, ((sw * height) + (sh / 2)) / sh);
+			else
+				dh = std::max(1, ((sh * width) + (sw / 2)) / sw);
+
+			dest.fillScreen(background);
+			resampleArea(dest, (width - dw) / 2, (height - dh) / 2, dw, dh, src, 0, 0, sw, sh);
+			break;
+		}
+
+		case imageFit::Cover:
+		{
+			// centered source area of the target's aspect ratio
+			int cw = sw;
+			int ch = sh;
+
+			if((sw * height) > (width * sh))
+				cw = std::max(1, ((width * sh) + (height / 2)) / height);
+			else
+				ch = std::max(1, ((height * sw) + (width / 2)) / width);
+
+			resampleArea(dest, 0, 0, width, height, src, (sw - cw) / 2, (sh - ch) / 2, cw, ch);
+			break;
+		}
+
+		default:
+			resampleArea(dest, 0, 0, width, height, src, 0, 0, sw, sh);
+			break;
+	}
+
+	return true;
+}
+
+
+
+//=============================================================================
+// Decoded image cache class
+//=============================================================================
+ImageCache::ImageCache(size_t budget)
+:	mBudget(budget),
+	mBytes(0),
+	hits(0),
+	misses(0)
+{
+}
+ImageCache::~ImageCache()
+{
+}
+
+void ImageCache::setBudget(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(mLock);
+
+	mBudget = bytes;
+	trim();
+}
+
+void ImageCache::clear()
+{
+	std::lock_guard<std::mutex> lock(mLock);
+
+	mEntries.clear();
+	mIndex.clear();
+	mBytes = 0;
+}
+
+// drop least recently used entries over budget, the most recent one always stays
+void ImageCache::trim()
+{
+	while((mBytes > mBudget) && (mEntries.size() > 1))
+	{
+		const tEntry &e = mEntries.back();
+
+		mBytes -= e.image.size() * sizeof(rgb24);
+		mIndex.erase(e.key);
+		mEntries.pop_back();
+	}
+}
+
+/**
+ * Look up an image by path and target size, decoding it on a miss or when
+ * the file changed since it was cached. The check costs one stat() call.
+ *
+ * @param width		Target width, 0 for the panel width.
+ * @param height	Target height, 0 for the panel height.
+ * @return	Cached image or NULL.
+ */
+const FrameBuffer* ImageCache::get(const char *path, int16_t width, int16_t height, imageFit fit, const rgb24 &background)
+{
+	struct stat	st;
+	char		params[48];
+
+
+	if(stat(path, &st) != 0)
+	{
+		printf("%s error: can't open image '%s'\n", __METHOD_NAME_C__, path);
+		return NULL;
+	}
+
+	width  = width?  width  : matrix.width;
+	height = height? height : matrix.height;
+	snprintf(params, sizeof(params), "\n%d,%d,%d,%02x%02x%02x", width, height, (int)fit,
+			 background.red, background.green, background.blue);
+
+	const string key = string(path) + params;
+	std::lock_guard<std::mutex> lock(mLock);
+
+	auto it = mIndex.find(key);
+	if(it != mIndex.end())
+	{
+		tEntry &e = *it->second;
+
+		if((e.mtime.tv_sec == st.st_mtim.tv_sec) && (e.mtime.tv_nsec == st.st_mtim.tv_nsec) && (e.fileSize == st.st_size))
+		{
+			mEntries.splice(mEntries.begin(), mEntries, it->second);
+			hits++;
+			return &e.image;
+		}
+
+		// file changed
+		mBytes -= e.image.size() * sizeof(rgb24);
+		mEntries.erase(it->second);
+		mIndex.erase(it);
+	}
+
+	misses++;
+
+	FrameBuffer decoded;
+	if(!imageLoad(decoded, path))
+		return NULL;
+
+	mEntries.push_front(tEntry());
+	tEntry &e = mEntries.front();
+
+	if(fit == imageFit::None)
+		e.image.swap(decoded);
+	else if(!imageResample(e.image, decoded, width, height, fit, background))
+	{
+		mEntries.pop_front();
+		return NULL;
+	}
+
+	e.key      = key;
+	e.path     = path;
+	e.mtime    = st.st_mtim;
+	e.fileSize = st.st_size;
+	mIndex[key] = mEntries.begin();
+	mBytes += e.image.size() * sizeof(rgb24);
+
+	trim();
+	return &e.image;
+}
@@ -0,0 +1,72 @@
+#ifndef XPM_IMAGE_H_
+#define XPM_IMAGE_H_
+
+
+#define IMAGECACHE_BUDGET		(16 * 1024 * 1024)	// decoded bytes kept by default
+#define IMAGE_SIZE_MAX			4096				// larger images are rejected
+
+
+// How an image is brought to a target size
+enum class imageFit
+{
+	Stretch = 0,	// exactly the target size, aspect ratio ignored
+	Contain,		// whole image centered, aspect ratio kept, borders in the background color
+	Cover,			// fills the target, aspect ratio kept, overhanging parts cropped
+	None,			// source size, target size ignored
+};
+
+
+// decode a binary or ASCII PPM/PGM, uncompressed BMP or, when built with libpng, PNG file
+bool imageLoad(FrameBuffer &dest, const char *path);
+
+// area averaged resampling of src into width x height, may not be done in place
+bool imageResample(FrameBuffer &dest, const FrameBuffer &src, int16_t width, int16_t height,
+				   imageFit fit = imageFit::Stretch, const rgb24 &background = rgb24());
+
+
+// Decoded and resampled images by path and size, reloaded once the file's modification time or
+// size changes, least recently used entries go first once over budget
+class ImageCache
+{
+private:
+	struct tEntry
+	{
+		string				key;
+		string				path;
+		struct timespec		mtime;
+		off_t				fileSize;
+		FrameBuffer			image;
+	};
+
+	std::list<tEntry>		mEntries;		// most recently used first
+	std::unordered_map<string, std::list<tEntry>::iterator> mIndex;
+	size_t					mBudget;
+	size_t					mBytes;			// pixels of all entries
+	std::mutex				mLock;
+
+
+	void trim();
+
+
+public:
+	size_t					hits;
+	size_t					misses;			// decoded on request
+
+
+	ImageCache(size_t budget = IMAGECACHE_BUDGET);
+	~ImageCache();
+
+	void setBudget(size_t bytes);
+	size_t bytes() const							{ return mBytes; }
+	void clear();
+
+	// image at width x height, 0 for the panel size, NULL if it can't be decoded, stays valid
+	// until later get() calls evict it, e.g. into a frame with drawImage() or FrameStream::send()
+	const FrameBuffer* get(const char *path, int16_t width = 0, int16_t height = 0,
+						   imageFit fit = imageFit::Contain, const rgb24 &background = rgb24());
+};
+
+extern ImageCache imageCache;
+
+
+#endif // XPM_IMAGE_H_
@@ -3,6 +3,18 @@
 #include <getopt.h>
 #include "rpc.h"
 #include "matrix.h"
+#include "framebuffer.h"
+#include "framepalette.h"
+#include "framestream.h"
+#include "framequeue.h"
+#include "threadpool.h"
+#include "tilerender.h"
+#include "colorpipeline.h"
+#include "colortables.h"
+#include "videoplayer.h"
+#include "pixelformat.h"
+#include "benchmark.h"
+#include "ftfont.h"
 #include "scripting/scripting.h"
 
 
@@ -28,6 +40,10 @@ XpmRPC		rpc;		// Remote Procedure Call instance
 ScriptCore	scripting;	// Scripting instance, currently for Python support
 
 volatile bool gm_Exit = false;
+static rpcFrameFormat frameFormat = rpcFrameFormat::RGB888;	// direct framebuffer write wire format
+static const char *overlayFont = NULL;		// TrueType font of the direct framebuffer write overlay
+static float frameGamma = 1.0f;				// host gamma correction of direct framebuffer writes
+static const char *videoFile = NULL;		// raw rgb24 or y4m file played instead of running scripts
 
 static void signalHandler(int sig);
 static double getFramerate();
@@ -41,7 +57,12 @@ static struct option long_options[] =
 
 	// operations
 	{ "help",		no_argument,		0, 'h' },	// print help information
+	{ "benchmark",	no_argument,		0, 'b' },	// frame transport benchmark, no display panel needed
 	{ "file",		required_argument,	0, 'f' },	// script file to run instead of default
+	{ "format",		required_argument,	0, 'F' },	// direct framebuffer write wire format, rgb888/rgb565/rgb444/rgb332/indexed8/indexed4
+	{ "ttf",		required_argument,	0, 'T' },	// TrueType font for the direct framebuffer write overlay
+	{ "gamma",		required_argument,	0, 'g' },	// host gamma correction of direct framebuffer writes, e.g. 2.2
+	{ "video",		required_argument,	0, 'v' },	// raw rgb24 or y4m video file to play in a loop
 
 	// end of options
 	{ 0, 0, 0, 0 }
@@ -67,7 +88,7 @@ int main(int argc, char * const argv[])
 	
 	for(;;)
 	{
-		int chr = getopt_long(argc, argv, "hf:", long_options, &optionIndex);
+		int chr = getopt_long(argc, argv, "hbf:F:T:g:v:", long_options, &optionIndex);
 
 		// check for end of options reached
 		if(chr == -1)
@@ -84,12 +105,55 @@ int main(int argc, char * const argv[])
 				return 0;
 			}
 			
+			case 'b':
+			{
+				// frame transport benchmark
+				return runBenchmark();
+			}
+
 			case 'f':
 			{
 				// script file to run instead of default
 				scripting.file = optarg;
 				break;
 			}
+
+			case 'F':
+			{
+				// direct framebuffer write wire format
+				static const char *names[] = { "rgb888", "rgb565", "rgb444", "rgb332", "indexed8", "indexed4" };
+				size_t i;
+
+				for(i=0; (i < ARRAYSIZE(names)) && strcasecmp(optarg, names[i]); i++);
+				if(i == ARRAYSIZE(names))
+				{
+					printf("Unknown frame format '%s'.\n", optarg);
+					return -1;
+				}
+				frameFormat = (rpcFrameFormat)i;
+				break;
+			}
+
+			case 'T':
+			{
+				// overlay font, bitmap font when FreeType isn't available
+				overlayFont = optarg;
+				break;
+			}
+
+			case 'g':
+			{
+				// direct framebuffer write gamma correction
+				frameGamma = (float)atof(optarg);
+				break;
+			}
+
+			case 'v':
+			{
+				// video file playback
+				videoFile = optarg;
+				break;
+			}
 		}
 	}
 
@@ -120,6 +184,26 @@ int main(int argc, char * const argv[])
 	matrix.gifPlay();
 */	matrix.waitForVSync();
 
+	// video file playback instead of scripting, same wire format and gamma options as direct framebuffer writes
+	if(videoFile)
+	{
+		VideoPlayer		video;
+		ColorPipeline	colors;
+
+		if(!video.open(videoFile))
+			return -3;
+
+		if(!video.stream().setFormat(frameFormat))
+			printf("Display panel doesn't support the requested frame format, sending RGB888.\n");
+		colors.setGamma(frameGamma);
+		video.stream().setColorPipeline(&colors);
+
+		printf("Playing %zu frames of %dx%d at %.2f fps.\n", video.frames(), video.width(), video.height(), video.rate());
+		video.play(0);
+		printf("%zu frames played, %zu dropped.\n", video.played, video.dropped);
+		return 0;
+	}
+
 #if 0
 	// testing and debugging continous text scrolling feature
 	TextScroller &scroller = matrix.getScroller(3);
@@ -185,7 +269,8 @@ int main(int argc, char * const argv[])
 
 
 	uint8_t wheelPos=128;
-	rgb24 color;
+	std::vector<int16_t> columns;
+	std::vector<rgb24> colors;
 
 	// continous draw loop, until RPC I/O error occurs
 	while(matrix.waitForVSync())
@@ -193,17 +278,16 @@ int main(int argc, char * const argv[])
 		double framerate = getFramerate();
 
 		wheelPos += 6;
-		uint8_t cw = wheelPos;
 
 		x = matrix.width  / 2;
 		y = matrix.height / 2;
 #if 1
+		columns.clear();
 		for(; x<matrix.width; x++)
-		{
-			cw += 4;
-			colorWheel(color, cw);
-			matrix.drawFastVLine(x, y, matrix.height -1, color);
-		}
+			columns.push_back(x);
+		colors.resize(columns.size());
+		gradientRow(colors.data(), colors.size(), colorTable(colorPalette::Wheel), (uint8_t)(wheelPos + 4) << 8, 4 << 8);
+		matrix.drawVLines(columns.data(), y, matrix.height -1, colors.data(), columns.size());
 #else
 		matrix.fillRoundRectangle(x, y, matrix.width -1, matrix.height -1, 3, rgb24(0xae,0x10,0x53), rgb24((255,255,255));
 #endif
@@ -369,24 +453,38 @@ size_t strchrcount(const char *str, char chr, size_t *strlen)
  * Direct framebuffer write example, instead of using Matrix draw commands.
  * XtremePanel equivalent to fadecandy's.
  */
-static void example_DirectFBWrite()
+// colorwheel columns shader of the direct framebuffer write example
+struct tWheelShade
 {
-	// new framebuffer has been displayed
-	rgb24	color;
-	int16_t	i;
-	static	uint8_t wheelPos=128;
-//	colorWheel(color, ++wheelPos);
+	uint8_t		wheelPos;
+	int16_t		width, height;
+};
 
-	const size_t FBsize   = matrix.width * matrix.height;
-	const size_t TXStride = RPCDATA_SIZE -1;
-		  size_t FBpacks  = (FBsize*3) / TXStride;
+static void wheelShader(rgb24 *dest, int16_t x, int16_t y, int16_t count, void *user)
+{
+	const tWheelShade &wheel = *(const tWheelShade *)user;
 
-	if((FBsize*3) % TXStride)
-		++FBpacks;
+	// white border outline
+	if(!y || (y == (wheel.height -1)))
+	{
+		std::fill(dest, dest + count, rgb24(255, 255, 255));
+		return;
+	}
 
-	// allocate local framebuffer
-	rgb24 *framebuffer = new rgb24[FBpacks * (TXStride / 3)];
+	gradientRow(dest, count, colorTable(colorPalette::Wheel), (uint8_t)(wheel.wheelPos + ((x +1) * 4)) << 8, 4 << 8);
+	if(!x)
+		dest[0] = rgb24(255, 255, 255);
+	if((x + count) == wheel.width)
+		dest[count -1] = rgb24(255, 255, 255);
+}
 
+static void example_DirectFBWrite()
+{
+	// new framebuffer has been displayed
+	rgb24	color;
+	static	tWheelShade wheel = { 128, 0, 0 };
+	char	fpsText[16] = "";
+//	colorWheel(color, ++wheelPos);
 
 	// stop GIF playback, stop text scrollers, etc..
 	matrix.gifStop();
@@ -395,72 +493,77 @@ static void example_DirectFBWrite()
 	matrix.fillScreen(rgb24(0, 0, 0));
 	matrix.waitForVSync();
 
+	// frames streamed as deltas by a worker thread, drawing the next one overlaps the transfer
+	matrix.setRenderAhead(2);
+	FrameStream &stream = matrix.getFrameQueue()->stream();
+
+	// reduced bit depth wire format when requested and supported
+	if(!stream.setFormat(frameFormat))
+		printf("Display panel doesn't support the requested frame format, sending RGB888.\n");
+	printf("Pixel format conversion using %s kernels.\n", pixelFormatKernels());
+
+	// color correction of every streamed frame
+	ColorPipeline colors;
+	colors.setGamma(frameGamma);
+	stream.setColorPipeline(&colors);
+	printf("Color correction using %s kernels.\n", colorPipelineKernels());
+
+	// per pixel content rendered by a thread pool, joined before the frame is submitted
+	TileRenderer renderer;
+	renderer.start();
+	wheel.width  = matrix.width;
+	wheel.height = matrix.height;
+	printf("Rendering on %zu threads.\n", renderer.pool().threads());
+
+#ifdef HAVE_FREETYPE
+	FreeTypeFont ttf;
+	if(overlayFont && !ttf.open(overlayFont, 9))
+		printf("Frame rate overlay uses the bitmap font.\n");
+#endif
+
 
 	// main loop
 	while(!gm_Exit && rpc.ok())
 	{
+		// waits only while two frames are in flight already
+		FrameBuffer *frame = matrix.beginFrame();
+		if(!frame)
+			break;
+
 		double fps;
 		if(getFramerate(fps))
 		{
 			// report current frame rate every second
 			printf("\rFrame update rate %0.3f", fps);
 			fflush(stdout);
+			snprintf(fpsText, sizeof(fpsText), "%.0f fps", fps);
 		}
 		
 #if 1
-		// colorwheel in smooth moving columns
-		wheelPos += 8;
-		uint8_t cw = wheelPos;
-		for(int16_t x=0; x<matrix.width; x++)
-		{
-			cw += 4;
-			colorWheel(color, cw);
-			for(int16_t y=0; y<matrix.height; y++)
-			{
-				framebuffer[(matrix.width * y) + x] = color;
-			}
-		}
+		// colorwheel in smooth moving columns with a white border, shaded tile by tile on all cores
+		wheel.wheelPos += 8;
+		renderer.render(*frame, wheelShader, &wheel);
 #else
-		colorWheel(color, ++wheelPos);
+		colorWheel(color, ++wheel.wheelPos);
 		// fill entire display with colorwheel value
-		for(int16_t x=0; i<FBsize; i++)
-			framebuffer[x] = color;
+		frame->fillScreen(color);
 #endif
 
-		// make border outline white
-		color = {255, 255, 255};
-		for(i=0; i<matrix.width; i++)
-		{
-			// top and bottom rows
-			framebuffer[i] = color;
-			framebuffer[matrix.width * (matrix.height -1) +i] = color;
-		}
-		for(i=0; i<matrix.height; i++)
-		{
-			// left and right columns
-			framebuffer[(matrix.width * i)] = color;
-			framebuffer[(matrix.width * i) + (matrix.width -1)] = color;
-		}
-
-		uint8_t *data = (uint8_t *)framebuffer;
-
-		// transfer framebuffer
-		for(size_t i=0; i<FBpacks; i++)
+		// frame rate overlay, rendered on the host into the same frame
+#ifdef HAVE_FREETYPE
+		if(ttf.opened())
+			ttf.draw(*frame, 2, 1, rgb24(255, 255, 255), fpsText);
+		else
+#endif
 		{
-			uint8_t flags = 0;
-			if(i > 0)
-				flags |= 0x10;	// append flag
-			if(i+1 == FBpacks)
-				flags |= 0x20;	// swapBuffers flag
-//			flags |= 0x80;		// raster debug visual aid enable flag, unique colors per raster segment(21 pixels) draw
-			rpc.sendTypeFrame(flags, &data[i * TXStride], TXStride);
+			frame->setFont(font3x5);
+			frame->drawString(2, 2, rgb24(255, 255, 255), rgb24(0, 0, 0), fpsText);
 		}
 
-		// frame swap detection (vertical synchronization), different from matrix.waitForVSync() cause of direct framebuffer writing done above
-		size_t fbswaps = matrix.bufferswaps;
-		while(!gm_Exit && rpc.poll(5) && rpc.ok() && (fbswaps == matrix.bufferswaps));
+		// queue framebuffer, the worker sends it once the panel swapped to the previous one
+		matrix.submitFrame();
 	}
 
-	delete[] framebuffer;
+	matrix.setRenderAhead(0);
 }
 
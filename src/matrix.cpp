@@ -1,6 +1,19 @@
 #include <xpmcommon.h>
 #include "rpc.h"
 #include "matrix.h"
+#include "framebuffer.h"
+#include "framepalette.h"
+#include "framestream.h"
+#include "frameencoder.h"
+#include "framequeue.h"
+#include "framescheduler.h"
+#include "displaylist.h"
+#include "sprite.h"
+#include "fonts.h"
+#include "pixelformat.h"
+#include "colortables.h"
+#include "image.h"
+#include "gifdecoder.h"
 
 
 //=============================================================================
@@ -8,9 +21,27 @@
 //=============================================================================
 LEDMatrix::LEDMatrix()
 :	mGIF({0, 0, 0, rpcGIFState::Stop}),
+	mHostGIF({NULL, 0, 0, 0, 0, 0, false}),
+	mShadow(NULL),
+	mShadowFront(NULL),
+	mEncoder(NULL),
+	mQueue(NULL),
+	mScheduler(NULL),
+	mCommandBuffer(false),
+	mCopyElision(true),
+	mCopyPending(false),
+	mFrameDrawn(false),
+	mFrameFormat(rpcFrameFormat::RGB888),
+	mRecord(NULL),
+	mFont(font3x5),
+	mFontChanged(false),
+	mFrameText(false),
+	mFrameFence(false),
+	mListRecord({NULL, NULL, font3x5, false}),
 	width(0),
 	height(0),
-	bufferswaps(0)
+	bufferswaps(0),
+	culledCommands(0)
 {
 	size_t i;
 
@@ -24,7 +55,15 @@ LEDMatrix::LEDMatrix()
 }
 LEDMatrix::~LEDMatrix()
 {
-	
+	setRenderAhead(0);
+	delete mScheduler;
+	displayListEnd();
+	for(size_t i=0; i<mLists.size(); i++)
+		delete mLists[i];
+	for(size_t i=0; i<mSprites.size(); i++)
+		delete mSprites[i];
+
+	setShadow(false);
 }
 
 bool LEDMatrix::prepare()
@@ -41,6 +80,13 @@ bool LEDMatrix::prepare()
 	for(size_t i=0; i<MATRIX_SCROLLERS; i++)
 		getScroller(i).prepare();
 
+	// size shadow framebuffers if they were enabled before the resolution was known
+	if(mShadow)
+	{
+		mShadow->resize(width, height);
+		mShadowFront->resize(width, height);
+	}
+
 	// done
 	return result;
 }
@@ -83,14 +129,34 @@ void LEDMatrix::setBrightness(uint8_t foreground, uint8_t background)
 	rpc.send(rpcType::Display, rpcDisplay::Brightness, data, sizeof(data));
 }
 
+bool LEDMatrix::setFrameFormat(rpcFrameFormat format)
+{
+	if(format == mFrameFormat)
+		return true;
+
+	if(!rpc.hasCapability(pixelFormatCapability(format)))
+		return false;
+
+	uint8_t i = (uint8_t)format;
+	if(!rpc.send(rpcType::Display, rpcDisplay::FrameFormat, &i, sizeof(i)))
+		return false;
+
+	mFrameFormat = format;
+	return true;
+}
+
 void LEDMatrix::swapBuffers(bool copy)
 {
-	uint8_t i = 0;
+	// a host GIF frame due by now goes out with this one
+	gifService(clock_getnstime(CLOCK_MONOTONIC));
 
-	
-	if(copy)	i |= 0x01;
-	
-	rpc.send(rpcType::Display, rpcDisplay::SwapBuffers, &i, sizeof(i));
+	if(mEncoder)
+	{
+		encodeFrame();
+		return;
+	}
+
+	sendSwap(copy);
 }
 
 bool LEDMatrix::waitForVSync(size_t times, bool copy)
@@ -98,9 +164,17 @@ bool LEDMatrix::waitForVSync(size_t times, bool copy)
 	// spin while polling RPC for requested vertical syncs
 	while(times)
 	{
-		uint8_t i = (copy)? 1:0;
-		if(!rpc.send(rpcType::Display, rpcDisplay::SwapBuffers, &i, sizeof(i)))
-			return false;
+		gifService(clock_getnstime(CLOCK_MONOTONIC));
+
+		if(mEncoder)
+		{
+			if(!encodeFrame())
+				return false;
+		} else
+		{
+			if(!sendSwap(copy))
+				return false;
+		}
 		
 		size_t swaps = bufferswaps;
 		while(rpc.ok() && (swaps == bufferswaps))
@@ -112,29 +186,199 @@ bool LEDMatrix::waitForVSync(size_t times, bool copy)
 	return true;
 }
 
-bool LEDMatrix::safeSleep(size_t msec)
+// swap framebuffers, a requested copy is held back until the next frame turns out to need it
+bool LEDMatrix::sendSwap(bool copy)
 {
-	int64_t ts;
+	// nothing drawn since the last swap, the drawing buffer is still missing its copy
+	resolveCopy(false);
 
+	if(!flushCommands())
+		return false;
 
-	while(msec && !gm_Exit)
+	const bool	elide = copy && mCopyElision && rpc.hasCapability(RPCCAP_COPYBUFFER);
+	uint8_t		i     = (copy && !elide)? 0x01 : 0x00;
+
+	if(!rpc.send(rpcType::Display, rpcDisplay::SwapBuffers, &i, sizeof(i)))
+		return false;
+
+	// the shadow copies right away, the panel catches up before anything reads its drawing buffer
+	shadowSwap(copy);
+
+	mCopyPending = elide;
+	mFrameDrawn  = false;
+	return true;
+}
+
+// first drawing of a frame, copy the displayed buffer over unless the drawing covers it anyway
+void LEDMatrix::resolveCopy(bool covered)
+{
+	if(!mCopyPending || mListRecord.list)
+		return;
+
+	mCopyPending = false;
+	if(covered)
+		return;
+
+	uint8_t i = 0;
+
+	rpc.record(mRecord);
+	rpc.send(rpcType::Display, rpcDisplay::CopyBuffer, &i, sizeof(i));
+	rpc.record(NULL);
+}
+
+// drawing into the frame, list recordings don't draw it
+void LEDMatrix::frameDrawing(bool covered)
+{
+	resolveCopy(covered);
+	mFrameDrawn = mFrameDrawn || !mListRecord.list;
+}
+
+/**
+ * Start a frame from the displayed one moved by an offset, so scrolled
+ * content only needs what moved into view drawn. Pixels nothing moves onto
+ * stay as displayed, anything drawn into the frame before is overwritten.
+ *
+ * @param dx	Horizontal offset, positive moves the content right.
+ * @param dy	Vertical offset, positive moves the content down.
+ * @return	false if the panel doesn't support it or on device error.
+ */
+bool LEDMatrix::shiftBuffer(int16_t dx, int16_t dy)
+{
+	// display lists only hold drawing commands
+	if(!rpc.hasCapability(RPCCAP_SHIFTBUFFER) || mListRecord.list)
+		return false;
+
+	// takes the place of a held back swap copy
+	mCopyPending = false;
+	mFrameDrawn  = true;
+	if(mShadow)
+	{
+		mShadow->copy(*mShadowFront);
+		mShadow->drawImage(dx, dy, *mShadowFront);
+	}
+
+	struct
+	{
+		int16_t  dx, dy;
+	} PACKED p = // parameters
+	{
+		dx, dy
+	};
+
+	rpc.record(mRecord);
+	bool result = rpc.send(rpcType::Display, rpcDisplay::ShiftBuffer, &p, sizeof(p));
+	rpc.record(NULL);
+
+	return result;
+}
+
+bool LEDMatrix::safeSleep(size_t msec)
+{
+	return sleepUntil(clock_getnstime(CLOCK_MONOTONIC) + ((int64_t)msec * 1000000LL));
+}
+
+/**
+ * Service the panel until an absolute monotonic time. Remaining time is
+ * recomputed from the clock after every poll, so slicing the wait doesn't
+ * accumulate rounding errors, and the last partial millisecond is slept
+ * since a zero poll timeout would block indefinitely. Host GIF frames
+ * falling due meanwhile are drawn and swapped in on time, unless drawing
+ * has started on a frame; they then go out with that frame's swap.
+ *
+ * @param deadline	clock_getnstime(CLOCK_MONOTONIC) time to return at.
+ * @return	false on device error.
+ */
+bool LEDMatrix::sleepUntil(int64_t deadline)
+{
+	for(int64_t now; !gm_Exit && ((now = clock_getnstime(CLOCK_MONOTONIC)) < deadline);)
 	{
 		if(!rpc.ok())
 			return false;
-		
-		ts = clock_getnstime(CLOCK_MONOTONIC);		// get a nanosecond time stamp
-		rpc.poll((msec < 250)? msec : 250);			// prevent possibly taking twice as long as requested
-		ts = clock_getnstime(CLOCK_MONOTONIC) - ts;	// get differential in nanoseconds
 
-		// convert differential to milliseconds and decrement milliseconds remaining
-		ts   /= 1000000;
-		msec -= ((size_t)ts > msec)? msec : (size_t)ts;
-		
+		// a partly drawn frame isn't swapped in
+		if(!mFrameDrawn && gifService(now))
+		{
+			swapBuffers(true);
+			continue;
+		}
+
+		const bool		gif  = !mFrameDrawn && mHostGIF.animation && (mGIF.state == rpcGIFState::Play) && (mHostGIF.due > now);
+		const int64_t	left = (gif? std::min(deadline, mHostGIF.due) : deadline) - now;
+
+		if(left >= 1000000LL)
+		{
+			rpc.poll((unsigned int)std::min<int64_t>(left / 1000000LL, 250));
+			continue;
+		}
+
+		struct timespec ts = { 0, (long)std::max<int64_t>(left, 0) };
+		nanosleep(&ts, NULL);
+	}
+
+	return rpc.ok();
+}
+
+/**
+ * Insert a fence into the command stream. While the frame encoder or the
+ * command buffer hold back the frame's drawing commands the fence is held
+ * with them, in order, and goes out with the next buffer swap.
+ * 
+ * @return	Fence tag, 0 when the display has no fence support.
+ */
+uint32_t LEDMatrix::fence()
+{
+	// display lists don't hold fences, a replayed tag would be echoed again
+	std::vector<uint8_t> *record = (mListRecord.list)? frameRecord() : mRecord;
+
+
+	rpc.record(record);
+	uint32_t fence = rpc.fenceInsert();
+	rpc.record(NULL);
+
+	mFrameFence = mFrameFence || (fence && (record == &mFramePackets));
+	return fence;
+}
+
+/**
+ * Block until the panel has executed everything sent before the fence,
+ * without swapping framebuffers.
+ * 
+ * @param	fence	Tag returned by fence().
+ * @param	msec	Give up after this many milliseconds.
+ * @return	True when the fence was reached, false on timeout or for the
+ * 			unsupported fence 0.
+ */
+bool LEDMatrix::waitForFence(uint32_t fence, size_t msec)
+{
+	const int64_t deadline = clock_getnstime(CLOCK_MONOTONIC) + (int64_t)msec * 1000000LL;
+
+
+	if(!fence)
+		return false;
+
+	while(!rpc.fenceReached(fence))
+	{
+		if(gm_Exit || !rpc.ok() || (clock_getnstime(CLOCK_MONOTONIC) >= deadline))
+			return false;
+
+		rpc.poll(5);
 	}
 
 	return true;
 }
 
+/**
+ * Bound the command queue depth, blocking until no more than the passed
+ * count of fences are still in flight.
+ */
+bool LEDMatrix::waitForFences(uint32_t pending, size_t msec)
+{
+	if(rpc.fencesPending() <= pending)
+		return true;
+
+	return waitForFence(rpc.fenceLast() - pending, msec);
+}
+
 void LEDMatrix::setMode(eDisplayState mode)
 {
 	uint8_t i = (uint8_t)mode;
@@ -143,10 +387,680 @@ void LEDMatrix::setMode(eDisplayState mode)
 }
 
 
+//-----------------------------------------------------------------------------
+// Shadow framebuffer functions
+//-----------------------------------------------------------------------------
+
+/**
+ * Enable or disable keeping host copies of the panel's framebuffers. Once
+ * enabled every drawing function is also rasterized on the host, except for
+ * text in the panel fonts while fontdata.h only holds stand-in glyphs.
+ * 
+ * @return	True when shadowing is enabled.
+ */
+bool LEDMatrix::setShadow(bool enable)
+{
+	if(!enable)
+	{
+		setFrameEncoder(false);
+		delete mShadow;
+		delete mShadowFront;
+		mShadow      = NULL;
+		mShadowFront = NULL;
+		return false;
+	}
+
+	if(!mShadow)
+	{
+		mShadow      = new FrameBuffer(width, height);
+		mShadowFront = new FrameBuffer(width, height);
+	}
+
+	return true;
+}
+
+/**
+ * Enable or disable the per frame encoder, which sends each frame as its
+ * drawing commands, fill regions or framebuffer segments, whichever takes
+ * the fewest packets. Enabling it also enables the shadow framebuffers.
+ * 
+ * The encoder is owned by LEDMatrix. It is created here when enabled and
+ * deleted when disabled, also by setShadow(false) and the destructor, so a
+ * pointer from getFrameEncoder() stays valid only until then.
+ * 
+ * @return	True when the encoder is enabled.
+ */
+bool LEDMatrix::setFrameEncoder(bool enable)
+{
+	if(!enable)
+	{
+		if(!mEncoder)
+			return false;
+
+		delete mEncoder;
+		mEncoder = NULL;
+		mFontChanged = false;
+		mFrameText   = false;
+
+		// commands drawn since the last swap still belong on the panel
+		if(!mCommandBuffer)
+		{
+			rpc.replay(mFramePackets);
+			mFramePackets.clear();
+			mFrameFence = false;
+		}
+		if(!mListRecord.list)
+			mRecord = frameRecord();
+		return false;
+	}
+
+	if(!mEncoder)
+	{
+		setShadow(true);
+		mEncoder = new FrameEncoder();
+		if(!mListRecord.list)
+			mRecord = frameRecord();
+	}
+
+	return true;
+}
+
+/**
+ * Stream host rendered frames from a worker thread, see FrameQueue. The
+ * application renders the next frames while earlier ones are transferred
+ * and waiting for the panel's swap.
+ *
+ * @param depth	Frames rendered ahead, 1 - FRAMEQUEUE_DEPTH_MAX, 0 to stop.
+ * @return	True while rendering ahead.
+ */
+bool LEDMatrix::setRenderAhead(size_t depth)
+{
+	if(mQueue)
+	{
+		mQueue->stop();
+		delete mQueue;
+		mQueue = NULL;
+	}
+
+	if(!depth)
+		return false;
+
+	mQueue = new FrameQueue();
+	return mQueue->start(depth);
+}
+
+FrameBuffer* LEDMatrix::beginFrame(size_t msec)
+{
+	return (mQueue)? mQueue->beginFrame(msec) : NULL;
+}
+
+bool LEDMatrix::submitFrame()
+{
+	return mQueue && mQueue->submitFrame();
+}
+
+/**
+ * Pace frames at a fixed rate, see FrameScheduler, waitFrame() then waits
+ * for the next frame slot instead of just returning.
+ *
+ * @param fps	Target frame rate, 0 to stop pacing.
+ */
+void LEDMatrix::setFrameRate(double fps)
+{
+	if(!mScheduler)
+		mScheduler = new FrameScheduler();
+
+	mScheduler->setRate(fps);
+}
+
+size_t LEDMatrix::waitFrame()
+{
+	if(!mScheduler)
+		return (rpc.ok() && !gm_Exit)? 1 : 0;
+
+	return mScheduler->waitFrame();
+}
+
+bool LEDMatrix::setCommandBuffer(bool enable)
+{
+	if(mCommandBuffer == enable)
+		return enable;
+
+	if(!enable)
+		flushCommands();
+
+	mCommandBuffer = enable;
+	if(!mListRecord.list)
+		mRecord = frameRecord();
+
+	return enable;
+}
+
+// send held back drawing commands as Packed commands
+bool LEDMatrix::flushCommands()
+{
+	if(!mCommandBuffer || mFramePackets.empty())
+		return true;
+
+	rpc.batchBegin();
+	bool result = rpc.replay(mFramePackets);
+	rpc.batchEnd();
+
+	mFramePackets.clear();
+	mFontChanged = false;
+	mFrameText   = false;
+	mFrameFence  = false;
+	return result;
+}
+
+void LEDMatrix::displayListBegin()
+{
+	if(mListRecord.list)
+		return;
+
+	mListRecord.list        = new DisplayList();
+	mListRecord.shadow      = mShadow;
+	mListRecord.font        = mFont;
+	mListRecord.fontChanged = mFontChanged;
+
+	// drawing functions only record, the shadow catches up when the list is called
+	mRecord = &mListRecord.list->packets();
+	mShadow = NULL;
+	rpc.listRecording(true);
+}
+
+/**
+ * Finish recording a display list and store it on the panel if possible.
+ * 
+ * @return	Handle for displayListCall(), 0 if no list was being recorded.
+ */
+int LEDMatrix::displayListEnd()
+{
+	DisplayList	*list = mListRecord.list;
+	size_t		 i;
+
+
+	if(!list)
+		return 0;
+
+	mRecord      = frameRecord();
+	mShadow      = mListRecord.shadow;
+	mFont        = mListRecord.font;
+	mFontChanged = mListRecord.fontChanged;
+	mListRecord.list = NULL;
+	rpc.listRecording(false);
+
+	// reuse the lowest free handle
+	for(i=0; (i < mLists.size()) && mLists[i]; i++);
+	if(i == mLists.size())
+		mLists.push_back(NULL);
+	mLists[i] = list;
+
+	// lists the panel can't store are replayed from the host when called
+	list->upload(i +1);
+
+	return i +1;
+}
+
+bool LEDMatrix::displayListCall(int handle)
+{
+	if((handle < 1) || ((size_t)handle > mLists.size()) || !mLists[handle -1])
+		return false;
+
+	DisplayList					*list    = mLists[handle -1];
+	const std::vector<uint8_t>	&packets = list->packets();
+
+
+	frameDrawing(false);
+	if(mShadow)
+		mShadow->replay(packets, &mSprites);
+
+	// the list leaves its last font selected
+	for(size_t offset = 0; (offset + RPCDATA_SIZE) <= packets.size(); offset += RPCDATA_SIZE)
+	{
+		if(packets[offset] != (uint8_t)rpcType::Drawing)
+			continue;
+
+		if(packets[offset +1] == (uint8_t)rpcDrawing::SetFont)
+		{
+			mFont        = (fontChoices)packets[offset + RPCC_SIZE];
+			mFontChanged = mFontChanged || (mRecord != NULL);
+		} else
+		if((packets[offset +1] == (uint8_t)rpcDrawing::DrawChar) || (packets[offset +1] == (uint8_t)rpcDrawing::DrawString))
+			mFrameText = mFrameText || (mRecord == &mFramePackets);
+	}
+
+	rpc.record(mRecord);
+	bool result = list->call();
+	rpc.record(NULL);
+
+	return result;
+}
+
+void LEDMatrix::displayListFree(int handle)
+{
+	if((handle < 1) || ((size_t)handle > mLists.size()))
+		return;
+
+	delete mLists[handle -1];
+	mLists[handle -1] = NULL;
+}
+
+/**
+ * Keep a sprite by the lowest free handle and store it on the panel if possible.
+ *
+ * @return	Handle for spriteDraw(), 0 if the sprite is too large.
+ */
+static int spriteAdd(std::vector<Sprite *> &sprites, Sprite *sprite, bool assigned)
+{
+	size_t i;
+
+
+	if(!assigned)
+	{
+		delete sprite;
+		return 0;
+	}
+
+	for(i=0; (i < sprites.size()) && sprites[i]; i++);
+	if(i == sprites.size())
+		sprites.push_back(NULL);
+	sprites[i] = sprite;
+
+	// sprites the panel can't store are drawn from the host
+	sprite->upload(i +1);
+
+	return i +1;
+}
+
+int LEDMatrix::spriteCreate(uint8_t width, uint8_t height, const uint8_t *bits)
+{
+	Sprite *sprite = new Sprite();
+
+	return spriteAdd(mSprites, sprite, sprite->assign(width, height, bits));
+}
+
+int LEDMatrix::spriteCreate(uint8_t width, uint8_t height, const rgb24 *pixels)
+{
+	Sprite *sprite = new Sprite();
+
+	return spriteAdd(mSprites, sprite, sprite->assign(width, height, pixels));
+}
+
+bool LEDMatrix::spriteDraw(int handle, int16_t x, int16_t y, const rgb24& color, bool transparent)
+{
+	if((handle < 1) || ((size_t)handle > mSprites.size()) || !mSprites[handle -1])
+		return false;
+
+	const Sprite *sprite = mSprites[handle -1];
+
+
+	if(mRecord && (mRecord == &mFramePackets) && offPanel(x, y, x + sprite->width() -1, y + sprite->height() -1))
+	{
+		culledCommands++;
+		return true;
+	}
+
+	frameDrawing(false);
+	if(mShadow)
+		sprite->draw(*mShadow, x, y, color, transparent);
+
+	rpc.record(mRecord);
+	bool result = sprite->blit(x, y, color, transparent);
+	rpc.record(NULL);
+
+	return result;
+}
+
+void LEDMatrix::spriteFree(int handle)
+{
+	if((handle < 1) || ((size_t)handle > mSprites.size()))
+		return;
+
+	delete mSprites[handle -1];
+	mSprites[handle -1] = NULL;
+}
+
+bool LEDMatrix::drawImage(int16_t x, int16_t y, const FrameBuffer &image)
+{
+	return drawImage(x, y, image, 0, 0, image.width() -1, image.height() -1);
+}
+
+/**
+ * Draw part of a host image, e.g. what changed since its previous version.
+ *
+ * @param x0	Inclusive image area left column.
+ * @param y0	Inclusive image area top row.
+ * @param x1	Inclusive image area right column.
+ * @param y1	Inclusive image area bottom row.
+ * @return	false on device error.
+ */
+bool LEDMatrix::drawImage(int16_t x, int16_t y, const FrameBuffer &image, int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+	x0 = std::max<int16_t>(x0, 0);
+	y0 = std::max<int16_t>(y0, 0);
+	x1 = std::min<int16_t>(x1, image.width()  -1);
+	y1 = std::min<int16_t>(y1, image.height() -1);
+	if((x0 > x1) || (y0 > y1))
+		return true;
+
+	if(mRecord && (mRecord == &mFramePackets) && offPanel(x + x0, y + y0, x + x1, y + y1))
+	{
+		culledCommands++;
+		return true;
+	}
+
+	frameDrawing(false);
+	if(mShadow)
+	{
+		mShadow->setClip(x + x0, y + y0, x + x1, y + y1);
+		mShadow->drawImage(x, y, image);
+		mShadow->resetClip();
+	}
+
+	// on panel part only, rows in pieces blitSpans() can take
+	const int	c0     = std::max<int>(x0, -x);
+	const int	r0     = std::max<int>(y0, -y);
+	const int	c1     = (width  > 0)? std::min<int>(x1 +1, width  - x) : (x1 +1);
+	const int	r1     = (height > 0)? std::min<int>(y1 +1, height - y) : (y1 +1);
+	const bool	batch  = rpc.batching();
+	bool		result = true;
+
+	rpc.record(mRecord);
+	if(!batch)
+		rpc.batchBegin();
+
+	for(int r=r0; result && (r < r1); r++)
+	{
+		for(int c=c0; result && (c < c1); c += 255)
+			result = blitSpans(x + c, y + r, (uint8_t)std::min(c1 - c, 255), 1, rpcBitmapFormat::RGB24,
+							   (const uint8_t *)(image.row(r) + c), rgb24(), false);
+	}
+
+	if(!batch)
+		rpc.batchEnd();
+	rpc.record(NULL);
+
+	return result;
+}
+
+// send the shadow framebuffer through the encoder, leaves the frame in both panel framebuffers
+bool LEDMatrix::encodeFrame()
+{
+	// text the shadow doesn't have only reaches the panel with the draw list
+	bool result = mEncoder->encode(*mShadow, &mFramePackets, mFrameText && !bitmapFontsExact());
+
+	// recorded font changes only reach the panel with the draw list
+	if(mFontChanged && (mEncoder->encoding != FrameEncoding::DrawList))
+	{
+		uint8_t i = (uint8_t)mFont;
+		rpc.send(rpcType::Drawing, rpcDrawing::SetFont, &i, sizeof(i));
+	}
+
+	// as do recorded fences, they follow the frame instead
+	if(mFrameFence && (mEncoder->encoding != FrameEncoding::DrawList))
+	{
+		for(size_t offset = 0; (offset + RPCDATA_SIZE) <= mFramePackets.size(); offset += RPCDATA_SIZE)
+		{
+			if((mFramePackets[offset] == (uint8_t)rpcType::System) && (mFramePackets[offset +1] == (uint8_t)rpcSystem::Fence))
+				result = rpc.send(rpcType::System, rpcSystem::Fence, &mFramePackets[offset + RPCC_SIZE], sizeof(uint32_t)) && result;
+		}
+	}
+	mFontChanged = false;
+	mFrameText   = false;
+	mFrameFence  = false;
+	mFrameDrawn  = false;
+	mFramePackets.clear();
+
+	shadowSwap(true);
+	return result;
+}
+
+// mirror a framebuffer swap, without copy the drawing buffer gets the previously displayed frame
+void LEDMatrix::shadowSwap(bool copy)
+{
+	if(!mShadow)
+		return;
+
+	if(copy)
+		mShadowFront->copy(*mShadow);
+	else
+		mShadowFront->swap(*mShadow);
+}
+
+
 //-----------------------------------------------------------------------------
 // Drawing functions
 //-----------------------------------------------------------------------------
 
+// bounding box of a drawing command, false for commands without one, x1 < x0 if it draws nothing
+bool LEDMatrix::commandBounds(rpcDrawing cmd, const uint8_t *params, int &x0, int &y0, int &x1, int &y1) const
+{
+	int16_t v[6];
+
+
+	memcpy(v, params, sizeof(v));
+	switch(cmd)
+	{
+		case rpcDrawing::DrawPixel:
+			x0 = x1 = v[0];
+			y0 = y1 = v[1];
+			break;
+		case rpcDrawing::DrawFastVLine:
+			x0 = x1 = v[0];
+			y0 = std::min(v[1], v[2]);
+			y1 = std::max(v[1], v[2]);
+			break;
+		case rpcDrawing::DrawFastHLine:
+			x0 = std::min(v[0], v[1]);
+			x1 = std::max(v[0], v[1]);
+			y0 = y1 = v[2];
+			break;
+		case rpcDrawing::DrawCircle:
+		case rpcDrawing::FillCircle:
+			x0 = v[0] - (uint16_t)v[2];
+			x1 = v[0] + (uint16_t)v[2];
+			y0 = v[1] - (uint16_t)v[2];
+			y1 = v[1] + (uint16_t)v[2];
+			break;
+		case rpcDrawing::DrawEllipse:
+			x0 = v[0] - (uint16_t)v[2];
+			x1 = v[0] + (uint16_t)v[2];
+			y0 = v[1] - (uint16_t)v[3];
+			y1 = v[1] + (uint16_t)v[3];
+			break;
+		case rpcDrawing::DrawTriangle:
+		case rpcDrawing::FillTriangle:
+			x0 = std::min(v[0], std::min(v[2], v[4]));
+			x1 = std::max(v[0], std::max(v[2], v[4]));
+			y0 = std::min(v[1], std::min(v[3], v[5]));
+			y1 = std::max(v[1], std::max(v[3], v[5]));
+			break;
+		case rpcDrawing::DrawLine:
+		case rpcDrawing::DrawRectangle:
+		case rpcDrawing::FillRectangle:
+		case rpcDrawing::DrawRoundRectangle:
+		case rpcDrawing::FillRoundRectangle:
+			x0 = std::min(v[0], v[2]);
+			x1 = std::max(v[0], v[2]);
+			y0 = std::min(v[1], v[3]);
+			y1 = std::max(v[1], v[3]);
+			break;
+		case rpcDrawing::DrawChar:
+		{
+			const tBitmapFont *font = getBitmapFont(mFont);
+
+			// stand-in glyphs don't tell where the panel's ink is, keep the whole cell
+			if(!font || !bitmapFontsExact())
+			{
+				const Point2I cell = getFontStringDims(mFont, " ");
+				x0 = v[0];
+				y0 = v[1];
+				x1 = x0 + cell.x -1;
+				y1 = y0 + cell.y -1;
+				break;
+			}
+
+			// ink box of the glyph rather than its cell, blank glyphs give an empty box
+			const tGlyphMetrics &ink = font->metric((char)params[(sizeof(int16_t) *2) + sizeof(rgb24)]);
+			x0 = v[0] + ink.left;
+			y0 = v[1] + ink.top;
+			x1 = x0 + ink.width -1;
+			y1 = y0 + ink.height -1;
+			break;
+		}
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Drop a drawing command that ends up off-panel or draws nothing and clip
+ * axis aligned ones to the panel. Anything recorded before a full panel
+ * fill is discarded.
+ * 
+ * @param cmd		Drawing command.
+ * @param params	Command parameters, clipped in place.
+ * @return	true if the command is to be dropped.
+ */
+bool LEDMatrix::cull(rpcDrawing cmd, uint8_t *params)
+{
+	int		x0, y0, x1, y1;
+	int16_t	v[4];
+
+
+	if((width <= 0) || (height <= 0))
+		return false;
+
+	// covered panel, with or without a rectangle's outline in view
+	if(coversPanel(cmd, params))
+		discardFrameCommands();
+
+	if(!commandBounds(cmd, params, x0, y0, x1, y1))
+		return false;
+
+	if((x1 < x0) || (y1 < y0) || offPanel(x0, y0, x1, y1))
+		return true;
+
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min(x1, width -1);
+	y1 = std::min(y1, height -1);
+
+	switch(cmd)
+	{
+		case rpcDrawing::DrawFastVLine:
+			v[0] = (int16_t)y0;
+			v[1] = (int16_t)y1;
+			memcpy(&params[sizeof(int16_t)], v, sizeof(int16_t) *2);
+			break;
+		case rpcDrawing::DrawFastHLine:
+			v[0] = (int16_t)x0;
+			v[1] = (int16_t)x1;
+			memcpy(params, v, sizeof(int16_t) *2);
+			break;
+		case rpcDrawing::FillRectangle:
+		{
+			// only a solid rectangle clips without losing its outline
+			if(memcmp(&params[sizeof(int16_t) *4], &params[sizeof(int16_t) *4 + sizeof(rgb24)], sizeof(rgb24)))
+				break;
+
+			v[0] = (int16_t)x0;
+			v[1] = (int16_t)y0;
+			v[2] = (int16_t)x1;
+			v[3] = (int16_t)y1;
+			memcpy(params, v, sizeof(v));
+			break;
+		}
+		default:
+			break;
+	}
+
+	return false;
+}
+
+// command paints every pixel of the panel
+bool LEDMatrix::coversPanel(rpcDrawing cmd, const uint8_t *params) const
+{
+	int x0, y0, x1, y1;
+
+
+	if(cmd == rpcDrawing::FillScreen)
+		return true;
+
+	if((cmd != rpcDrawing::FillRectangle) || (width <= 0) || (height <= 0) ||
+		!commandBounds(cmd, params, x0, y0, x1, y1))
+		return false;
+
+	return (x0 <= 0) && (y0 <= 0) && (x1 >= (width -1)) && (y1 >= (height -1));
+}
+
+// drop every recorded drawing command of the frame, a full panel fill is about to cover them
+void LEDMatrix::discardFrameCommands()
+{
+	std::vector<uint8_t>	fences;
+	bool					font = false;
+
+
+	for(size_t offset = 0; (offset + RPCDATA_SIZE) <= mFramePackets.size(); offset += RPCDATA_SIZE)
+	{
+		// fences keep their place ahead of the fill
+		if((mFramePackets[offset] == (uint8_t)rpcType::System) && (mFramePackets[offset +1] == (uint8_t)rpcSystem::Fence))
+			fences.insert(fences.end(), &mFramePackets[offset], &mFramePackets[offset + RPCDATA_SIZE]);
+
+		if(mFramePackets[offset] != (uint8_t)rpcType::Drawing)
+			continue;
+
+		const rpcDrawing cmd = (rpcDrawing)mFramePackets[offset +1];
+		if((cmd == rpcDrawing::SetFont) || (cmd == rpcDrawing::DisplayList))
+			font = true;
+		else
+			culledCommands++;
+	}
+	mFramePackets.swap(fences);
+	mFrameText = false;
+
+	// panel still has to end up with the current font
+	if(font)
+	{
+		uint8_t i = (uint8_t)mFont;
+
+		rpc.record(&mFramePackets);
+		rpc.send(rpcType::Drawing, rpcDrawing::SetFont, &i, sizeof(i));
+		rpc.record(NULL);
+	}
+}
+
+// send a drawing command, or append it to the active recording
+bool LEDMatrix::submit(rpcDrawing cmd, const void *params, size_t size)
+{
+	uint8_t buffer[RPCPL_SIZE];
+
+
+	// frames held back for a buffer swap only keep what ends up visible
+	if(mRecord && (mRecord == &mFramePackets))
+	{
+		memset(buffer, 0, sizeof(buffer));
+		memcpy(buffer, params, size);
+		if(cull(cmd, buffer))
+		{
+			culledCommands++;
+			return true;
+		}
+		params = buffer;
+	}
+
+	frameDrawing(coversPanel(cmd, (const uint8_t *)params));
+
+	rpc.record(mRecord);
+	bool result = rpc.send(rpcType::Drawing, cmd, params, size);
+	rpc.record(NULL);
+
+	return result;
+}
+
 void LEDMatrix::drawPixel(int16_t x, int16_t y, const rgb24& color)
 {
 	struct
@@ -158,7 +1072,10 @@ void LEDMatrix::drawPixel(int16_t x, int16_t y, const rgb24& color)
 		x, y, color
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::DrawPixel, &p, sizeof(p));
+	if(mShadow)
+		mShadow->drawPixel(x, y, color);
+
+	submit(rpcDrawing::DrawPixel, &p, sizeof(p));
 }
 
 void LEDMatrix::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24& color)
@@ -184,7 +1101,10 @@ void LEDMatrix::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const r
 		x0, y0, x1, y1, color
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::DrawLine, &p, sizeof(p));
+	if(mShadow)
+		mShadow->drawLine(x0, y0, x1, y1, color);
+
+	submit(rpcDrawing::DrawLine, &p, sizeof(p));
 }
 
 void LEDMatrix::drawFastVLine(int16_t x, int16_t y0, int16_t y1, const rgb24& color)
@@ -198,7 +1118,10 @@ void LEDMatrix::drawFastVLine(int16_t x, int16_t y0, int16_t y1, const rgb24& co
 		x, y0, y1, color
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::DrawFastVLine, &p, sizeof(p));
+	if(mShadow)
+		mShadow->drawFastVLine(x, y0, y1, color);
+
+	submit(rpcDrawing::DrawFastVLine, &p, sizeof(p));
 }
 
 void LEDMatrix::drawFastHLine(int16_t x0, int16_t x1, int16_t y, const rgb24& color)
@@ -212,7 +1135,10 @@ void LEDMatrix::drawFastHLine(int16_t x0, int16_t x1, int16_t y, const rgb24& co
 		x0, x1, y, color
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::DrawFastHLine, &p, sizeof(p));
+	if(mShadow)
+		mShadow->drawFastHLine(x0, x1, y, color);
+
+	submit(rpcDrawing::DrawFastHLine, &p, sizeof(p));
 }
 
 void LEDMatrix::drawCircle(int16_t x, int16_t y, uint16_t radius, const rgb24& color)
@@ -226,7 +1152,10 @@ void LEDMatrix::drawCircle(int16_t x, int16_t y, uint16_t radius, const rgb24& c
 		x, y, radius, color
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::DrawCircle, &p, sizeof(p));
+	if(mShadow)
+		mShadow->drawCircle(x, y, radius, color);
+
+	submit(rpcDrawing::DrawCircle, &p, sizeof(p));
 }
 
 void LEDMatrix::fillCircle(int16_t x, int16_t y, uint16_t radius, const rgb24& outlineColor, const rgb24& fillColor)
@@ -240,7 +1169,10 @@ void LEDMatrix::fillCircle(int16_t x, int16_t y, uint16_t radius, const rgb24& o
 		x, y, radius, outlineColor, fillColor
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::FillCircle, &p, sizeof(p));
+	if(mShadow)
+		mShadow->fillCircle(x, y, radius, outlineColor, fillColor);
+
+	submit(rpcDrawing::FillCircle, &p, sizeof(p));
 }
 
 void LEDMatrix::drawEllipse(int16_t x, int16_t y, uint16_t radiusX, uint16_t radiusY, const rgb24& color)
@@ -254,7 +1186,10 @@ void LEDMatrix::drawEllipse(int16_t x, int16_t y, uint16_t radiusX, uint16_t rad
 		x, y, radiusX, radiusY, color
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::DrawEllipse, &p, sizeof(p));
+	if(mShadow)
+		mShadow->drawEllipse(x, y, radiusX, radiusY, color);
+
+	submit(rpcDrawing::DrawEllipse, &p, sizeof(p));
 }
 
 void LEDMatrix::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, const rgb24& color)
@@ -268,7 +1203,10 @@ void LEDMatrix::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int
 		x0, y0, x1, y1, x2, y2, color
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::DrawTriangle, &p, sizeof(p));
+	if(mShadow)
+		mShadow->drawTriangle(x0, y0, x1, y1, x2, y2, color);
+
+	submit(rpcDrawing::DrawTriangle, &p, sizeof(p));
 }
 
 void LEDMatrix::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, const rgb24& outlineColor, const rgb24& fillColor)
@@ -282,7 +1220,10 @@ void LEDMatrix::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int
 		x0, y0, x1, y1, x2, y2, outlineColor, fillColor
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::FillTriangle, &p, sizeof(p));
+	if(mShadow)
+		mShadow->fillTriangle(x0, y0, x1, y1, x2, y2, outlineColor, fillColor);
+
+	submit(rpcDrawing::FillTriangle, &p, sizeof(p));
 }
 
 void LEDMatrix::drawRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24& color)
@@ -296,7 +1237,10 @@ void LEDMatrix::drawRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, co
 		x0, y0, x1, y1, color
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::DrawRectangle, &p, sizeof(p));
+	if(mShadow)
+		mShadow->drawRectangle(x0, y0, x1, y1, color);
+
+	submit(rpcDrawing::DrawRectangle, &p, sizeof(p));
 }
 
 void LEDMatrix::fillRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24& outlineColor, const rgb24& fillColor)
@@ -310,7 +1254,10 @@ void LEDMatrix::fillRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, co
 		x0, y0, x1, y1, outlineColor, fillColor
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::FillRectangle, &p, sizeof(p));
+	if(mShadow)
+		mShadow->fillRectangle(x0, y0, x1, y1, outlineColor, fillColor);
+
+	submit(rpcDrawing::FillRectangle, &p, sizeof(p));
 }
 
 void LEDMatrix::drawRoundRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t radius, const rgb24& outlineColor)
@@ -324,7 +1271,10 @@ void LEDMatrix::drawRoundRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y
 		x0, y0, x1, y1, radius, outlineColor
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::DrawRoundRectangle, &p, sizeof(p));
+	if(mShadow)
+		mShadow->drawRoundRectangle(x0, y0, x1, y1, radius, outlineColor);
+
+	submit(rpcDrawing::DrawRoundRectangle, &p, sizeof(p));
 }
 
 void LEDMatrix::fillRoundRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t radius, const rgb24& outlineColor, const rgb24& fillColor)
@@ -338,12 +1288,18 @@ void LEDMatrix::fillRoundRectangle(int16_t x0, int16_t y0, int16_t x1, int16_t y
 		x0, y0, x1, y1, radius, outlineColor, fillColor
 	};
 	
-	rpc.send(rpcType::Drawing, rpcDrawing::FillRoundRectangle, &p, sizeof(p));
+	if(mShadow)
+		mShadow->fillRoundRectangle(x0, y0, x1, y1, radius, outlineColor, fillColor);
+
+	submit(rpcDrawing::FillRoundRectangle, &p, sizeof(p));
 }
 
 void LEDMatrix::fillScreen(const rgb24& color)
 {
-	rpc.send(rpcType::Drawing, rpcDrawing::FillScreen, &color, sizeof(color));
+	if(mShadow)
+		mShadow->fillScreen(color);
+
+	submit(rpcDrawing::FillScreen, &color, sizeof(color));
 }
 
 void LEDMatrix::drawChar(int16_t x, int16_t y, const rgb24& charColor, char character)
@@ -358,14 +1314,31 @@ void LEDMatrix::drawChar(int16_t x, int16_t y, const rgb24& charColor, char char
 		x, y, charColor, character
 	};
 
-	rpc.send(rpcType::Drawing, rpcDrawing::DrawChar, &p, sizeof(p));
+	if(mShadow)
+		mShadow->drawChar(x, y, charColor, character);
+	mFrameText = mFrameText || (mRecord == &mFramePackets);
+
+	submit(rpcDrawing::DrawChar, &p, sizeof(p));
 }
 
 void LEDMatrix::drawString(int16_t x, int16_t y, const rgb24& charColor, const rgb24& backColor, const char text[])
 {
 	// TODO: avoid transfering duplicate strings
+	if(mRecord && (mRecord == &mFramePackets))
+	{
+		const Point2I dims = getFontStringDims(mFont, text);
+		if(!dims.x || offPanel(x, y, x + dims.x -1, y + dims.y -1))
+		{
+			culledCommands++;
+			return;
+		}
+	}
+
 
-	if(!rpc.transfer(DRAWSTRING_SLOT, (uint8_t *)text, strlen(text)))
+	rpc.record(mRecord);
+	bool sent = rpc.transfer(DRAWSTRING_SLOT, (uint8_t *)text, strlen(text));
+	rpc.record(NULL);
+	if(!sent)
 		return;
 
 	struct
@@ -378,66 +1351,262 @@ void LEDMatrix::drawString(int16_t x, int16_t y, const rgb24& charColor, const r
 		x, y, charColor, backColor, DRAWSTRING_SLOT
 	};
 
-	rpc.send(rpcType::Drawing, rpcDrawing::DrawString, &p, sizeof(p));
+	if(mShadow)
+		mShadow->drawString(x, y, charColor, backColor, text);
+	mFrameText = mFrameText || (mRecord == &mFramePackets);
+
+	submit(rpcDrawing::DrawString, &p, sizeof(p));
 }
 
+void LEDMatrix::drawMonoBitmap(int16_t x, int16_t y, uint8_t width, uint8_t height, const rgb24& bitmapColor, const uint8_t *bitmap)
+{
+	const size_t	size = (size_t)((width + 7) / 8) * height;
+	uint8_t			data[IOBUFFERS_SSIZE];
+
 
-//-----------------------------------------------------------------------------
-// Font functions
-//-----------------------------------------------------------------------------
+	if(!size)
+		return;
+
+	if(mRecord && (mRecord == &mFramePackets) && offPanel(x, y, x + width -1, y + height -1))
+	{
+		culledCommands++;
+		return;
+	}
+
+	if(mShadow)
+		mShadow->drawMonoBitmap(x, y, width, height, bitmapColor, bitmap);
+
+	// bitmaps the transfer slot can't hold and older firmware draw as spans
+	if(!rpc.hasCapability(RPCCAP_SPRITES) || ((sizeof(tRPCMonoBitmap) + size) > std::min<size_t>(sizeof(data), gm_IOBuffers[DRAWSTRING_SLOT].size)))
+	{
+		frameDrawing(false);
+		rpc.record(mRecord);
+		blitSpans(x, y, width, height, rpcBitmapFormat::Mono, bitmap, bitmapColor, false);
+		rpc.record(NULL);
+		return;
+	}
+
+	tRPCMonoBitmap	header = { width, height, { bitmapColor.red, bitmapColor.green, bitmapColor.blue } };
+
+	memcpy(data, &header, sizeof(header));
+	memcpy(&data[sizeof(header)], bitmap, size);
+
+	rpc.record(mRecord);
+	bool sent = rpc.transfer(DRAWSTRING_SLOT, data, sizeof(header) + size);
+	rpc.record(NULL);
+	if(!sent)
+		return;
+
+	struct
+	{
+		int16_t  x, y;
+		uint8_t  buffer;
+	} PACKED p = // parameters
+	{
+		x, y, DRAWSTRING_SLOT
+	};
 
-// cheating for now, but it works
-static const Point2I fonttable[FONT_MAXINDEX +1] =
+	submit(rpcDrawing::DrawMonoBitmap, &p, sizeof(p));
+}
+
+// full parameters of a batch entry, shared coordinates filled in
+static inline void batchEntry(rpcDrawing cmd, const int16_t *coords, const int16_t *shared, int16_t *v)
 {
-	// width, height
-	{ 4,  6 },	// apple3x5 / font3x5
-	{ 5,  7 },	// apple5x7 / font5x7
-	{ 6, 10 },	// apple6x10 / font6x10
-	{ 8, 13 },	// apple8x13 / font8x13
-	{ 6, 11 },	// gohufont6x11 / gohufont11
-	{ 6, 11 }	// gohufont6x11b / gohufont11b
-};
+	if(!shared)
+		memcpy(v, coords, ((cmd == rpcDrawing::DrawPixel)? 2 : ((cmd == rpcDrawing::DrawLine)? 4 : 3)) * sizeof(int16_t));
+	else if(cmd == rpcDrawing::DrawFastVLine)
+	{
+		v[0] = coords[0];
+		v[1] = shared[0];
+		v[2] = shared[1];
+	} else
+	{
+		v[0] = shared[0];
+		v[1] = shared[1];
+		v[2] = coords[0];
+	}
+}
 
+void LEDMatrix::drawPixels(const int16_t *points, const rgb24 *colors, size_t count, bool oneColor)
+{
+	drawBatch(rpcDrawing::DrawPixel, points, NULL, colors, count, oneColor);
+}
 
-void LEDMatrix::setFont(fontChoices newFont)
+void LEDMatrix::drawVLines(const int16_t *xs, int16_t y0, int16_t y1, const rgb24 *colors, size_t count, bool oneColor)
 {
-	uint8_t i = (uint8_t)newFont;
-	rpc.send(rpcType::Drawing, rpcDrawing::SetFont, &i, sizeof(i));
+	const int16_t shared[2] = { y0, y1 };
+
+	drawBatch(rpcDrawing::DrawFastVLine, xs, shared, colors, count, oneColor);
 }
 
-Point2I LEDMatrix::getFontStringDims(fontChoices font, const char *text)
+void LEDMatrix::drawSpans(const int16_t *spans, const rgb24 *colors, size_t count, bool oneColor)
+{
+	drawBatch(rpcDrawing::DrawFastHLine, spans, NULL, colors, count, oneColor);
+}
+
+void LEDMatrix::drawLines(const int16_t *lines, const rgb24 *colors, size_t count, bool oneColor)
 {
-	Point2I	result; // defaults to 0,0
-	size_t	fontnum	= (size_t)font;
-	size_t	length;
-	size_t	lines	= 1 + strchrcount(text, '\n', &length);
+	drawBatch(rpcDrawing::DrawLine, lines, NULL, colors, count, oneColor);
+}
+
+/**
+ * Draw many primitives of one kind. Entries are packed into DrawBatch packets,
+ * without the per command header and color of Packed commands when the color
+ * or coordinates are shared. Recordings and older firmware get the single
+ * commands, batched into Packed commands.
+ *
+ * @param cmd		DrawPixel, DrawLine, DrawFastVLine or DrawFastHLine.
+ * @param coords	int16 coordinates per entry in the command's parameter order, less the shared ones.
+ * @param shared	DrawFastVLine y0, y1 or DrawFastHLine x0, x1 common to all entries, or NULL.
+ * @param colors	rgb24 per entry, or one for all.
+ * @param count		entries.
+ * @param oneColor	colors holds a single color.
+ */
+void LEDMatrix::drawBatch(rpcDrawing cmd, const int16_t *coords, const int16_t *shared, const rgb24 *colors, size_t count, bool oneColor)
+{
+	const size_t	params = (cmd == rpcDrawing::DrawPixel)? 2 : ((cmd == rpcDrawing::DrawLine)? 4 : 3);
+	const size_t	stride = shared? 1 : params;
+	int16_t			v[6] = {0, 0, 0, 0, 0, 0};
+
 
+	if(!count || !coords || !colors)
+		return;
 
-	if(length && (fontnum <= FONT_MAXINDEX))
+	// recordings inspect and replay single commands, older firmware gets them as Packed commands
+	if(mRecord || !rpc.hasCapability(RPCCAP_DRAWBATCH))
 	{
-		result    = fonttable[fontnum];
-		result.x *= (int16_t)length;
-		result.y *= (int16_t)lines;
+		const bool batch = !mRecord && !rpc.batching();
+
+		if(batch)
+			rpc.batchBegin();
+
+		for(size_t i = 0; i < count; i++, coords += stride)
+		{
+			const rgb24 &color = colors[oneColor? 0 : i];
+
+			batchEntry(cmd, coords, shared, v);
+			switch(cmd)
+			{
+				case rpcDrawing::DrawPixel:		drawPixel(v[0], v[1], color); break;
+				case rpcDrawing::DrawLine:		drawLine(v[0], v[1], v[2], v[3], color); break;
+				case rpcDrawing::DrawFastVLine:	drawFastVLine(v[0], v[1], v[2], color); break;
+				case rpcDrawing::DrawFastHLine:	drawFastHLine(v[0], v[1], v[2], color); break;
+				default: break;
+			}
+		}
+
+		if(batch)
+			rpc.batchEnd();
+		return;
 	}
 
-	return result;
+	tRPCDrawBatch	header =
+	{
+		(uint8_t)cmd, 0, (uint8_t)((oneColor? RPCBATCH_FLAG_COLOR : 0) | (shared? RPCBATCH_FLAG_SHARED : 0)),
+		{ shared? shared[0] : (int16_t)0, shared? shared[1] : (int16_t)0 },
+		{ colors[0].red, colors[0].green, colors[0].blue }
+	};
+	const size_t	entry = (stride * sizeof(int16_t)) + (oneColor? 0 : sizeof(rgb24));
+	uint8_t			data[RPCPL_SIZE];
+	size_t			size = sizeof(header);
+
+
+	frameDrawing(false);
+
+	for(size_t i = 0; i < count; i++, coords += stride)
+	{
+		const rgb24 &color = colors[oneColor? 0 : i];
+		int			 x0, y0, x1, y1;
+
+		batchEntry(cmd, coords, shared, v);
+		if(mShadow)
+		{
+			switch(cmd)
+			{
+				case rpcDrawing::DrawPixel:		mShadow->drawPixel(v[0], v[1], color); break;
+				case rpcDrawing::DrawLine:		mShadow->drawLine(v[0], v[1], v[2], v[3], color); break;
+				case rpcDrawing::DrawFastVLine:	mShadow->drawFastVLine(v[0], v[1], v[2], color); break;
+				case rpcDrawing::DrawFastHLine:	mShadow->drawFastHLine(v[0], v[1], v[2], color); break;
+				default: break;
+			}
+		}
+
+		if(commandBounds(cmd, (const uint8_t *)v, x0, y0, x1, y1) && offPanel(x0, y0, x1, y1))
+		{
+			culledCommands++;
+			continue;
+		}
+
+		// packet full, send it and start the next one with the same header
+		if((size + entry) > sizeof(data))
+		{
+			memcpy(data, &header, sizeof(header));
+			rpc.send(rpcType::Drawing, rpcDrawing::DrawBatch, data, size, true);
+			header.count = 0;
+			size = sizeof(header);
+		}
+
+		memcpy(&data[size], coords, stride * sizeof(int16_t));
+		size += stride * sizeof(int16_t);
+		if(!oneColor)
+		{
+			memcpy(&data[size], &color, sizeof(rgb24));
+			size += sizeof(rgb24);
+		}
+		header.count++;
+	}
+
+	if(header.count)
+	{
+		memcpy(data, &header, sizeof(header));
+		rpc.send(rpcType::Drawing, rpcDrawing::DrawBatch, data, size, true);
+	}
 }
 
+
+//-----------------------------------------------------------------------------
+// Font functions
+//-----------------------------------------------------------------------------
+
+void LEDMatrix::setFont(fontChoices newFont)
+{
+	uint8_t i = (uint8_t)newFont;
+	if(mShadow)
+		mShadow->setFont(newFont);
+
+	mFont        = newFont;
+	mFontChanged = mFontChanged || (mRecord != NULL);
+
+	submit(rpcDrawing::SetFont, &i, sizeof(i));
+}
+
+Point2I LEDMatrix::getFontStringDims(fontChoices font, const char *text)
+{
+	return measureText(font, text);
+}
+
+/**
+ * Count characters and lines of a font needed to fill an area, partially
+ * visible ones included.
+ */
 Point2I LEDMatrix::getFontCharsInRect(fontChoices font, const Point2I &dims)
 {
-	Point2I result; // defaults to 0,0
-	size_t	fontnum	= (size_t)font;
+	const tBitmapFont	*desc = getBitmapFont(font);
+	Point2I				 result; // defaults to 0,0
+	int					 advance;
 
-	
-	if(fontnum <= FONT_MAXINDEX)
-	{
-		result.x = dims.x / fonttable[fontnum].x;
-		result.y = dims.y / fonttable[fontnum].y;
 
-		if(dims.x % fonttable[fontnum].x)	result.x++;
-		if(dims.y % fonttable[fontnum].y)	result.y++;
-	}
-	
+	if(!desc)
+		return result;
+
+	// narrowest glyph fits the most characters
+	advance = desc->width;
+	for(int i=0; i<FONT_GLYPHCOUNT; i++)
+		advance = std::min<int>(advance, desc->metrics[i].advance);
+
+	result.x = (dims.x + advance -1) / advance;
+	result.y = (dims.y + desc->height -1) / desc->height;
+
 	return result;
 }
 
@@ -448,6 +1617,27 @@ Point2I LEDMatrix::getFontCharsInRect(fontChoices font, const Point2I &dims)
 
 void LEDMatrix::gifLoad(const char *filepath)
 {
+	// animation frames draw on top of what's displayed
+	resolveCopy(false);
+
+	// files on the host are decoded once and streamed, others are on the panel's filesystem
+	const bool panelGIF = !mHostGIF.animation;
+	if((mHostGIF.animation = gifCacheGet(filepath)))
+	{
+		// one loaded on the panel earlier would go on playing underneath
+		if(panelGIF && (mGIF.state != rpcGIFState::Stop))
+		{
+			uint8_t control = (uint8_t)rpcGIFState::Stop & RPCGIF_MASK_STATE;
+			rpc.send(rpcType::Drawing, rpcDrawing::GIFAnimation, &control, sizeof(control));
+		}
+
+		mHostGIF.frame = 0;
+		mHostGIF.loops = 0;
+		mHostGIF.due   = clock_getnstime(CLOCK_MONOTONIC);
+		mHostGIF.whole = true;
+		return;
+	}
+
 	if(!rpc.transfer(DRAWSTRING_SLOT, (uint8_t *)filepath, strlen(filepath)))
 		return;
 
@@ -466,9 +1656,18 @@ void LEDMatrix::gifLoad(const char *filepath)
 
 void LEDMatrix::gifPlay(uint16_t interval)
 {
+	resolveCopy(false);
+
 	mGIF.state		= rpcGIFState::Play;
 	mGIF.interval	= interval;
 
+	if(mHostGIF.animation)
+	{
+		mHostGIF.due   = clock_getnstime(CLOCK_MONOTONIC);
+		mHostGIF.whole = true;
+		return;
+	}
+
 	struct
 	{
 		uint8_t   control;
@@ -487,6 +1686,7 @@ void LEDMatrix::gifStop()
 {
 	mGIF.state = rpcGIFState::Stop;
 	
+	// the panel may still be playing a GIF from its filesystem loaded earlier
 	struct
 	{
 		uint8_t   control;
@@ -507,6 +1707,12 @@ void LEDMatrix::gifPosition(int16_t x, int16_t y)
 	if(mGIF.state == rpcGIFState::Stop)
 		return;
 
+	if(mHostGIF.animation)
+	{
+		mHostGIF.whole = true;
+		return;
+	}
+
 	struct
 	{
 		uint8_t   control;
@@ -520,6 +1726,51 @@ void LEDMatrix::gifPosition(int16_t x, int16_t y)
 	rpc.send(rpcType::Drawing, rpcDrawing::GIFAnimation, &p, sizeof(p));
 }
 
+void LEDMatrix::gifSize(int16_t width, int16_t height)
+{
+	mHostGIF.width  = std::max<int16_t>(width,  0);
+	mHostGIF.height = std::max<int16_t>(height, 0);
+	mHostGIF.whole  = true;
+}
+
+/**
+ * Draw the next frame of a host decoded GIF once it is due. Only the area
+ * that changed since the previous frame is drawn, so frames are never
+ * skipped; a late frame restarts the schedule from now instead.
+ *
+ * @param now	clock_getnstime(CLOCK_MONOTONIC) time.
+ * @return	true if anything was drawn.
+ */
+bool LEDMatrix::gifService(int64_t now)
+{
+	// not while recording display lists or rendering ahead
+	if(!mHostGIF.animation || (mGIF.state != rpcGIFState::Play) || (now < mHostGIF.due) || mListRecord.list ||
+		(mQueue && mQueue->running()))
+		return false;
+
+	const std::vector<tGIFFrame> &frames = mHostGIF.animation->frames(mHostGIF.width, mHostGIF.height);
+	if(mHostGIF.frame >= frames.size())
+		mHostGIF.frame = 0;
+
+	const tGIFFrame	&f     = frames[mHostGIF.frame];
+	const bool		 drawn = mHostGIF.whole || (f.x0 <= f.x1);
+
+	if(mHostGIF.whole)
+		drawImage(mGIF.x, mGIF.y, f.image);
+	else if(drawn)
+		drawImage(mGIF.x, mGIF.y, f.image, f.x0, f.y0, f.x1, f.y1);
+
+	const int64_t delay = (f.delay? f.delay : mGIF.interval) * 1000000LL;
+	mHostGIF.due   = ((mHostGIF.due + delay) > now)? (mHostGIF.due + delay) : (now + delay);
+	mHostGIF.whole = false;
+
+	// the last frame of the last loop stays up
+	if((++mHostGIF.frame == frames.size()) && mHostGIF.animation->loops() && (++mHostGIF.loops >= mHostGIF.animation->loops()))
+		mGIF.state = rpcGIFState::Stop;
+
+	return drawn;
+}
+
 
 
 //=============================================================================
@@ -631,7 +1882,7 @@ void TextScroller::syncRing(bool isCB)
 		
 		ring.pos		= 0;
 		ring.room		= IOBUFFERS_LSIZE;
-		ring.civ		= LEDMatrix::getFontCharsInRect(scrollFont, dims).x;
+		ring.civ		= LEDMatrix::getFontCharsInRect(scrollFont, dims).x +1;	// plus the one scrolling in
 		ring.enabled	= true;
 
 		// prevent having to refill too often to avoid wasting USB through put
@@ -772,6 +2023,15 @@ void TextScroller::stopScrollText(void)
 
 void TextScroller::setScrollBoundary(int x0, int y0, int x1, int y1)
 {
+	// keep within the panel, it also bounds the characters in view
+	if((matrix.width > 0) && (matrix.height > 0))
+	{
+		x0 = std::max(x0, 0);
+		y0 = std::max(y0, 0);
+		x1 = std::min(x1, matrix.width -1);
+		y1 = std::min(y1, matrix.height -1);
+	}
+
 	int16_t params[4] =
 	{
 		(int16_t)x0, (int16_t)y0, (int16_t)x1, (int16_t)y1
@@ -823,26 +2083,8 @@ void TextScroller::appendText(const char *text)
 // Other misc. graphics related functions
 //=============================================================================
 
+// table lookup, see colortables.cpp
 void colorWheel(rgb24 &color, uint8_t WheelPos)
 {
-  if(WheelPos < 85)
-  {
-    color.red   = WheelPos * 3;
-    color.green = 255 - WheelPos * 3;
-    color.blue  = 0;
-    return;
-  } else if(WheelPos < 170)
-  {
-    WheelPos   -=  85;
-    color.red   = 255 - WheelPos * 3;
-    color.green = 0;
-    color.blue  = WheelPos * 3;
-    return;
-  } else
-  {
-    WheelPos   -= 170;
-    color.red   = 0;
-    color.green = WheelPos * 3;
-    color.blue  = 255 - WheelPos * 3;
-  }
+	color = colorTable(colorPalette::Wheel)[WheelPos];
 }
@@ -63,6 +63,15 @@ enum eDisplayState
 };
 
 
+class FrameBuffer;
+class FrameEncoder;
+class FrameQueue;
+class FrameScheduler;
+class DisplayList;
+class Sprite;
+class GIFAnimation;
+
+
 // Text Sroller class
 class TextScroller
 {
@@ -139,6 +148,41 @@ private:
 		uint16_t	interval;
 		rpcGIFState state;
 	}				mGIF;
+	struct
+	{
+		GIFAnimation	*animation;	// decoded on the host, NULL while the panel plays from its filesystem
+		int16_t			width;		// size frames are fitted into, 0 for the GIF's own
+		int16_t			height;
+		size_t			frame;		// next frame to show
+		uint16_t		loops;		// completed so far
+		int64_t			due;		// clock_getnstime(CLOCK_MONOTONIC) time the next frame shows
+		bool			whole;		// next frame draws all of itself rather than what changed
+	}				mHostGIF;
+	FrameBuffer		*mShadow;		// host copy of the panel's drawing framebuffer, NULL when disabled
+	FrameBuffer		*mShadowFront;	// host copy of the panel's displayed framebuffer
+	FrameEncoder	*mEncoder;		// frame cost model encoder, NULL when drawing commands are sent directly
+	FrameQueue		*mQueue;		// asynchronous host rendered frames, NULL when not rendering ahead
+	FrameScheduler	*mScheduler;	// frame pacing, NULL until a frame rate is set
+	bool			mCommandBuffer;	// drawing commands are held back until the next buffer swap
+	bool			mCopyElision;	// buffer swaps defer their copy until the next frame turns out to need it
+	bool			mCopyPending;	// drawing buffer has yet to receive a copy of the displayed buffer
+	bool			mFrameDrawn;	// drawn to since the last buffer swap, host GIF frames wait for it
+	rpcFrameFormat	mFrameFormat;	// pixel format the panel expects framebuffer packets in
+	std::vector<uint8_t>  mFramePackets;	// drawing commands recorded since the last buffer swap
+	std::vector<uint8_t> *mRecord;		// recording drawing commands go to, NULL to send them
+	fontChoices		mFont;
+	bool			mFontChanged;	// font set while recording
+	bool			mFrameText;		// text the panel renders itself recorded since the last swap
+	bool			mFrameFence;	// fence recorded since the last swap
+	std::vector<DisplayList *> mLists;	// display lists by handle -1, NULL when freed
+	std::vector<Sprite *> mSprites;		// sprites by handle -1, NULL when freed
+	struct
+	{
+		DisplayList		*list;		// display list being recorded, NULL if none
+		FrameBuffer		*shadow;	// shadow framebuffer held back while recording
+		fontChoices		font;
+		bool			fontChanged;
+	}				mListRecord;
 
 
 	void displaySwapped()
@@ -146,12 +190,31 @@ private:
 		bufferswaps++;
 	}
 	void handleRPCDrawing(rpcDrawing cmd, uint8_t *data, size_t size);
+	void shadowSwap(bool copy);
+	bool encodeFrame();
+	bool sendSwap(bool copy);
+	void resolveCopy(bool covered);
+	void frameDrawing(bool covered);
+	bool gifService(int64_t now);
+	bool coversPanel(rpcDrawing cmd, const uint8_t *params) const;
+	bool flushCommands();
+	std::vector<uint8_t>* frameRecord()				{ return (mEncoder || mCommandBuffer)? &mFramePackets : NULL; }
+	bool commandBounds(rpcDrawing cmd, const uint8_t *params, int &x0, int &y0, int &x1, int &y1) const;
+	bool offPanel(int x0, int y0, int x1, int y1) const
+	{
+		return (width > 0) && (height > 0) && ((x1 < 0) || (y1 < 0) || (x0 >= width) || (y0 >= height));
+	}
+	bool cull(rpcDrawing cmd, uint8_t *params);
+	void discardFrameCommands();
+	bool submit(rpcDrawing cmd, const void *params, size_t size);
+	void drawBatch(rpcDrawing cmd, const int16_t *coords, const int16_t *shared, const rgb24 *colors, size_t count, bool oneColor);
 
 	
 public:
 	int16_t				width;			// LED matrix width in pixels/LEDs
 	int16_t				height;			// LED matrix height in pixels/LEDs
 	volatile size_t		bufferswaps;	// count of times display swapped framebuffers
+	size_t				culledCommands;	// drawing commands dropped as invisible or overdrawn within a frame
 
 
 	LEDMatrix();
@@ -173,6 +236,50 @@ public:
 
 	TextScroller& getScroller(size_t index) { return mScrollers[index]; }
 
+	// host side shadow framebuffers, mirror all drawing functions (scroller text excluded)
+	bool setShadow(bool enable);
+	FrameBuffer* getShadow()								{ return mShadow; }
+	FrameBuffer* getShadowFront()							{ return mShadowFront; }
+
+	// per frame encoder picking drawing commands, fill regions or framebuffer segments, whichever
+	// sends the fewest packets, enables the shadow framebuffers and makes buffer swaps always copy
+	bool setFrameEncoder(bool enable);
+	const FrameEncoder* getFrameEncoder() const				{ return mEncoder; }
+
+	// per frame command buffer, drops drawing commands that end up off-panel or overdrawn by a
+	// full panel fill and sends the rest batched on the next buffer swap
+	bool setCommandBuffer(bool enable);
+	bool getCommandBuffer() const							{ return mCommandBuffer; }
+
+	// host rendered frames streamed by a worker thread, depth frames can be submitted ahead of the
+	// one displayed, 0 stops, drawing functions shouldn't be used meanwhile
+	bool setRenderAhead(size_t depth);
+	FrameQueue* getFrameQueue()								{ return mQueue; }
+	// frame to render into, blocks up to msec only with depth frames in flight, NULL on timeout
+	FrameBuffer* beginFrame(size_t msec = 1000);
+	// queue the frame from beginFrame() without waiting for it to be sent
+	bool submitFrame();
+
+	// display lists, drawing functions between begin and end are recorded rather than drawn and
+	// replayed by handle later on, scroller and GIF functions are never recorded
+	void displayListBegin();
+	int  displayListEnd();
+	bool displayListCall(int handle);
+	void displayListFree(int handle);
+
+	// sprites, bitmaps uploaded once and drawn by handle, mono rows of (width +7) / 8 bytes with the
+	// most significant bit leftmost, 0 if too large, see RPCSPR_MAXSIZE
+	int  spriteCreate(uint8_t width, uint8_t height, const uint8_t *bits);
+	int  spriteCreate(uint8_t width, uint8_t height, const rgb24 *pixels);
+	// mono sprites draw set bits in color, rgb24 sprites skip pixels equal to color when transparent
+	bool spriteDraw(int handle, int16_t x, int16_t y, const rgb24& color, bool transparent = false);
+	void spriteFree(int handle);
+
+	// host images, e.g. from imageCache, sent as spans of equal pixels, the frame encoder sends
+	// framebuffer segments instead when that takes fewer packets
+	bool drawImage(int16_t x, int16_t y, const FrameBuffer &image);
+	bool drawImage(int16_t x, int16_t y, const FrameBuffer &image, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
 
 	// display control
 	void setBrightness(uint8_t foreground, uint8_t background);
@@ -180,9 +287,32 @@ public:
 		{ setBrightness(brightness, brightness); }
 	void swapBuffers(bool copy = true);
 	bool waitForVSync(size_t times = 1, bool copy = true);
+	// skip swap copies the next frame doesn't read, needs firmware support, enabled by default
+	bool setCopyElision(bool enable)						{ return (mCopyElision = enable); }
+	// the drawing buffer is about to be overwritten completely by other means, e.g. a frame stream
+	void frameOverwritten()									{ mCopyPending = false; }
+	// start the frame from the displayed one moved by dx, dy, false if the panel can't
+	bool shiftBuffer(int16_t dx, int16_t dy);
+	// pixel format of framebuffer packets, false if the panel doesn't support it
+	bool setFrameFormat(rpcFrameFormat format);
+	rpcFrameFormat getFrameFormat() const					{ return mFrameFormat; }
 	bool safeSleep(size_t msec);
+	// safeSleep() until a clock_getnstime(CLOCK_MONOTONIC) time
+	bool sleepUntil(int64_t deadline);
+
+	// frame pacing, waitFrame() returns the frame slots elapsed since the previous frame, more
+	// than 1 when overrunning frames were dropped, 0 on error
+	void setFrameRate(double fps);
+	size_t waitFrame();
+	const FrameScheduler* getScheduler() const				{ return mScheduler; }
 	void setMode(eDisplayState mode);
 
+	// command stream fences
+	uint32_t fence();
+	bool fenceReached(uint32_t fence) const			{ return rpc.fenceReached(fence); }
+	bool waitForFence(uint32_t fence, size_t msec = 1000);
+	bool waitForFences(uint32_t pending, size_t msec = 1000);
+
 	// drawing functions
 	void drawPixel(int16_t x, int16_t y, const rgb24& color);
 	void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const rgb24& color);
@@ -210,7 +340,14 @@ public:
 	inline void drawString(int16_t x, int16_t y, const rgb24& charColor, const char text[])
 		{ drawString(x, y, charColor, charColor, text); }
 	void drawString(int16_t x, int16_t y, const rgb24& charColor, const rgb24& backColor, const char text[]);
-//	void drawMonoBitmap(int16_t x, int16_t y, uint8_t width, uint8_t height, const rgb24& bitmapColor, const uint8_t *bitmap);
+	void drawMonoBitmap(int16_t x, int16_t y, uint8_t width, uint8_t height, const rgb24& bitmapColor, const uint8_t *bitmap);
+
+	// batch drawing, count primitives from packed int16 coordinates, colors holds one rgb24 per
+	// primitive or a single one for all of them when oneColor is set
+	void drawPixels(const int16_t *points, const rgb24 *colors, size_t count, bool oneColor = false);	// x, y
+	void drawVLines(const int16_t *xs, int16_t y0, int16_t y1, const rgb24 *colors, size_t count, bool oneColor = false);
+	void drawSpans(const int16_t *spans, const rgb24 *colors, size_t count, bool oneColor = false);		// x0, x1, y
+	void drawLines(const int16_t *lines, const rgb24 *colors, size_t count, bool oneColor = false);	// x0, y0, x1, y1
 
 
 	// fonts
@@ -223,6 +360,9 @@ public:
 	void gifPlay(uint16_t interval = 100); // 100ms default
 	void gifStop();
 	void gifPosition(int16_t x, int16_t y);
+	// GIFs found on the host are decoded and streamed by it, fitted into width x height keeping
+	// their aspect ratio, 0 for their own size
+	void gifSize(int16_t width, int16_t height);
 };
 
 extern LEDMatrix matrix;
@@ -0,0 +1,374 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "pixelformat.h"
+#include "simd.h"
+
+#if defined(XPM_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+
+// Vector kernels convert whole blocks and return how many pixels, or for RGB444 how many
+// source bytes, they covered, the scalar loops finish the rest
+typedef size_t (*tPixelKernel)(const uint8_t *src, size_t count, uint8_t *dest);
+
+struct tPixelKernels
+{
+	const char		*name;
+	tPixelKernel	rgb565;
+	tPixelKernel	rgb444;		// counts source bytes, always even
+	tPixelKernel	rgb332;
+};
+
+
+//-----------------------------------------------------------------------------
+// NEON kernels
+//-----------------------------------------------------------------------------
+#if defined(XPM_SIMD_NEON)
+
+static size_t neonRGB565(const uint8_t *src, size_t count, uint8_t *dest)
+{
+	size_t i = 0;
+
+	for(; (i + 16) <= count; i += 16, src += 48, dest += 32)
+	{
+		uint8x16x3_t px = vld3q_u8(src);
+
+		// shift-right-insert keeps the top bits already in place
+		uint16x8_t lo = vshll_n_u8(vget_low_u8(px.val[0]), 8);
+		lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(px.val[1]), 8), 5);
+		lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(px.val[2]), 8), 11);
+
+		uint16x8_t hi = vshll_n_u8(vget_high_u8(px.val[0]), 8);
+		hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(px.val[1]), 8), 5);
+		hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(px.val[2]), 8), 11);
+
+		vst1q_u8(dest,      vreinterpretq_u8_u16(lo));
+		vst1q_u8(dest + 16, vreinterpretq_u8_u16(hi));
+	}
+
+	return i;
+}
+
+static size_t neonRGB444(const uint8_t *src, size_t count, uint8_t *dest)
+{
+	size_t i = 0;
+
+	for(; (i + 32) <= count; i += 32, src += 32, dest += 16)
+	{
+		uint8x16x2_t bytes = vld2q_u8(src);
+		vst1q_u8(dest, vsriq_n_u8(bytes.val[0], bytes.val[1], 4));
+	}
+
+	return i;
+}
+
+static size_t neonRGB332(const uint8_t *src, size_t count, uint8_t *dest)
+{
+	size_t i = 0;
+
+	for(; (i + 16) <= count; i += 16, src += 48, dest += 16)
+	{
+		uint8x16x3_t px = vld3q_u8(src);
+		uint8x16_t   v  = vsriq_n_u8(px.val[0], px.val[1], 3);
+
+		vst1q_u8(dest, vsriq_n_u8(v, px.val[2], 6));
+	}
+
+	return i;
+}
+
+static const tPixelKernels sNEON = { "NEON", neonRGB565, neonRGB444, neonRGB332 };
+
+#endif // XPM_SIMD_NEON
+
+
+//-----------------------------------------------------------------------------
+// SSE2, SSSE3 and AVX2 kernels, the latter two picked at runtime
+//-----------------------------------------------------------------------------
+#if defined(XPM_SIMD_SSE2)
+
+// pshufb masks gathering one channel of 16 pixels from three 16 byte loads
+struct tDeinterleave
+{
+	__m128i			mask[3][3];		// [channel][load]
+
+	tDeinterleave()
+	{
+		uint8_t m[3][3][16];
+
+		memset(m, 0x80, sizeof(m));
+		for(int c=0; c<3; c++)
+		{
+			for(int p=0; p<16; p++)
+			{
+				const int k = (p * 3) + c;
+				m[c][k / 16][p] = k % 16;
+			}
+		}
+
+		for(int c=0; c<3; c++)
+			for(int l=0; l<3; l++)
+				mask[c][l] = _mm_loadu_si128((const __m128i *)m[c][l]);
+	}
+};
+static const tDeinterleave sDeinterleave;
+
+__attribute__((target("ssse3")))
+static inline void deinterleave(const uint8_t *src, __m128i &r, __m128i &g, __m128i &b)
+{
+	const __m128i in0 = _mm_loadu_si128((const __m128i *)src);
+	const __m128i in1 = _mm_loadu_si128((const __m128i *)(src + 16));
+	const __m128i in2 = _mm_loadu_si128((const __m128i *)(src + 32));
+	__m128i *channel[3] = { &r, &g, &b };
+
+	for(int c=0; c<3; c++)
+	{
+		*channel[c] = _mm_or_si128(_mm_or_si128(
+			_mm_shuffle_epi8(in0, sDeinterleave.mask[c][0]),
+			_mm_shuffle_epi8(in1, sDeinterleave.mask[c][1])),
+			_mm_shuffle_epi8(in2, sDeinterleave.mask[c][2]));
+	}
+}
+
+static size_t sse2RGB444(const uint8_t *src, size_t count, uint8_t *dest)
+{
+	const __m128i	high = _mm_set1_epi16(0x00F0);
+	size_t			i = 0;
+
+	// byte pairs as 16 bit lanes, high nibble of the low byte and of the high byte
+	for(; (i + 32) <= count; i += 32, src += 32, dest += 16)
+	{
+		__m128i a = _mm_loadu_si128((const __m128i *)src);
+		__m128i b = _mm_loadu_si128((const __m128i *)(src + 16));
+
+		a = _mm_or_si128(_mm_and_si128(a, high), _mm_srli_epi16(a, 12));
+		b = _mm_or_si128(_mm_and_si128(b, high), _mm_srli_epi16(b, 12));
+		_mm_storeu_si128((__m128i *)dest, _mm_packus_epi16(a, b));
+	}
+
+	return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t ssse3RGB565(const uint8_t *src, size_t count, uint8_t *dest)
+{
+	const __m128i	zero = _mm_setzero_si128();
+	const __m128i	mr   = _mm_set1_epi16(0x00F8);
+	const __m128i	mg   = _mm_set1_epi16(0x00FC);
+	size_t			i = 0;
+
+	for(; (i + 16) <= count; i += 16, src += 48, dest += 32)
+	{
+		__m128i r, g, b;
+
+		deinterleave(src, r, g, b);
+		for(int half=0; half<2; half++)
+		{
+			__m128i r16 = (half)? _mm_unpackhi_epi8(r, zero) : _mm_unpacklo_epi8(r, zero);
+			__m128i g16 = (half)? _mm_unpackhi_epi8(g, zero) : _mm_unpacklo_epi8(g, zero);
+			__m128i b16 = (half)? _mm_unpackhi_epi8(b, zero) : _mm_unpacklo_epi8(b, zero);
+			__m128i v   = _mm_or_si128(_mm_or_si128(
+				_mm_slli_epi16(_mm_and_si128(r16, mr), 8),
+				_mm_slli_epi16(_mm_and_si128(g16, mg), 3)),
+				_mm_srli_epi16(b16, 3));
+
+			_mm_storeu_si128((__m128i *)(dest + (half * 16)), v);
+		}
+	}
+
+	return i;
+}
+
+__attribute__((target("ssse3")))
+static size_t ssse3RGB332(const uint8_t *src, size_t count, uint8_t *dest)
+{
+	const __m128i	mr = _mm_set1_epi8((char)0xE0);
+	const __m128i	mg = _mm_set1_epi8(0x1C);
+	const __m128i	mb = _mm_set1_epi8(0x03);
+	size_t			i = 0;
+
+	// no 8 bit shifts, 16 bit shifts masked afterwards
+	for(; (i + 16) <= count; i += 16, src += 48, dest += 16)
+	{
+		__m128i r, g, b;
+
+		deinterleave(src, r, g, b);
+		_mm_storeu_si128((__m128i *)dest, _mm_or_si128(_mm_or_si128(
+			_mm_and_si128(r, mr),
+			_mm_and_si128(_mm_srli_epi16(g, 3), mg)),
+			_mm_and_si128(_mm_srli_epi16(b, 6), mb)));
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t avx2RGB565(const uint8_t *src, size_t count, uint8_t *dest)
+{
+	const __m256i	mr = _mm256_set1_epi16(0x00F8);
+	const __m256i	mg = _mm256_set1_epi16(0x00FC);
+	size_t			i = 0;
+
+	for(; (i + 16) <= count; i += 16, src += 48, dest += 32)
+	{
+		__m128i r, g, b;
+
+		deinterleave(src, r, g, b);
+
+		const __m256i r16 = _mm256_cvtepu8_epi16(r);
+		const __m256i g16 = _mm256_cvtepu8_epi16(g);
+		const __m256i b16 = _mm256_cvtepu8_epi16(b);
+
+		_mm256_storeu_si256((__m256i *)dest, _mm256_or_si256(_mm256_or_si256(
+			_mm256_slli_epi16(_mm256_and_si256(r16, mr), 8),
+			_mm256_slli_epi16(_mm256_and_si256(g16, mg), 3)),
+			_mm256_srli_epi16(b16, 3)));
+	}
+
+	return i;
+}
+
+__attribute__((target("avx2")))
+static size_t avx2RGB444(const uint8_t *src, size_t count, uint8_t *dest)
+{
+	const __m256i	high = _mm256_set1_epi16(0x00F0);
+	size_t			i = 0;
+
+	for(; (i + 64) <= count; i += 64, src += 64, dest += 32)
+	{
+		__m256i a = _mm256_loadu_si256((const __m256i *)src);
+		__m256i b = _mm256_loadu_si256((const __m256i *)(src + 32));
+
+		a = _mm256_or_si256(_mm256_and_si256(a, high), _mm256_srli_epi16(a, 12));
+		b = _mm256_or_si256(_mm256_and_si256(b, high), _mm256_srli_epi16(b, 12));
+
+		// packus works per 128 bit lane, restore the quadword order
+		_mm256_storeu_si256((__m256i *)dest, _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+	}
+
+	return i + sse2RGB444(src, count - i, dest);
+}
+
+static const tPixelKernels sSSE2  = { "SSE2",  NULL,        sse2RGB444, NULL };
+static const tPixelKernels sSSSE3 = { "SSSE3", ssse3RGB565, sse2RGB444, ssse3RGB332 };
+static const tPixelKernels sAVX2  = { "AVX2",  avx2RGB565,  avx2RGB444, ssse3RGB332 };
+
+#endif // XPM_SIMD_SSE2
+
+
+static const tPixelKernels sScalar = { "scalar", NULL, NULL, NULL };
+
+static const tPixelKernels& kernels()
+{
+#if defined(XPM_SIMD_NEON)
+	return sNEON;
+#elif defined(XPM_SIMD_SSE2)
+	static const tPixelKernels &picked =
+		(__builtin_cpu_supports("avx2"))?	sAVX2 :
+		(__builtin_cpu_supports("ssse3"))?	sSSSE3 : sSSE2;
+
+	return picked;
+#else
+	return sScalar;
+#endif
+}
+
+
+//=============================================================================
+// Framebuffer wire format conversion
+//=============================================================================
+size_t pixelFormatSize(rpcFrameFormat format, size_t count)
+{
+	switch(format)
+	{
+		case rpcFrameFormat::RGB565:	return count * 2;
+		case rpcFrameFormat::RGB444:	return ((count * 3) +1) / 2;
+		case rpcFrameFormat::RGB332:	return count;
+		case rpcFrameFormat::Indexed8:	return count;
+		case rpcFrameFormat::Indexed4:	return (count +1) / 2;
+		default:						return count * sizeof(rgb24);
+	}
+}
+
+uint32_t pixelFormatCapability(rpcFrameFormat format)
+{
+	switch(format)
+	{
+		case rpcFrameFormat::RGB565:	return RPCCAP_FB_RGB565;
+		case rpcFrameFormat::RGB444:	return RPCCAP_FB_RGB444;
+		case rpcFrameFormat::RGB332:	return RPCCAP_FB_RGB332;
+		case rpcFrameFormat::Indexed8:
+		case rpcFrameFormat::Indexed4:	return RPCCAP_FB_INDEXED;
+		default:						return 0;
+	}
+}
+
+size_t pixelFormatColors(rpcFrameFormat format)
+{
+	switch(format)
+	{
+		case rpcFrameFormat::Indexed8:	return 256;
+		case rpcFrameFormat::Indexed4:	return 16;
+		default:						return 0;
+	}
+}
+
+void pixelFormatConvert(rpcFrameFormat format, const rgb24 *src, size_t count, uint8_t *dest)
+{
+	const tPixelKernels	&k     = kernels();
+	const uint8_t		*bytes = (const uint8_t *)src;
+	size_t				 i     = 0;
+
+
+	switch(format)
+	{
+		case rpcFrameFormat::RGB565:
+			if(k.rgb565)
+				i = k.rgb565(bytes, count, dest);
+
+			for(; i<count; i++)
+			{
+				const uint16_t v = ((src[i].red & 0xF8) << 8) | ((src[i].green & 0xFC) << 3) | (src[i].blue >> 3);
+				dest[i * 2]    = v;
+				dest[i * 2 +1] = v >> 8;
+			}
+			break;
+
+		case rpcFrameFormat::RGB444:
+		{
+			// the nibble stream doesn't care about pixel boundaries
+			const size_t size = count * sizeof(rgb24);
+
+			if(k.rgb444)
+				i = k.rgb444(bytes, size, dest);
+
+			for(; (i +1) < size; i += 2)
+				dest[i / 2] = (bytes[i] & 0xF0) | (bytes[i +1] >> 4);
+			if(i < size)
+				dest[i / 2] = bytes[i] & 0xF0;
+			break;
+		}
+
+		case rpcFrameFormat::RGB332:
+			if(k.rgb332)
+				i = k.rgb332(bytes, count, dest);
+
+			for(; i<count; i++)
+				dest[i] = (src[i].red & 0xE0) | ((src[i].green & 0xE0) >> 3) | (src[i].blue >> 6);
+			break;
+
+		case rpcFrameFormat::RGB888:
+			memcpy(dest, src, count * sizeof(rgb24));
+			break;
+
+		default:
+			// indexed formats need a palette, see FramePalette::map()
+			break;
+	}
+}
+
+const char* pixelFormatKernels()
+{
+	return kernels().name;
+}
@@ -0,0 +1,29 @@
+#ifndef XPM_PIXELFORMAT_H_
+#define XPM_PIXELFORMAT_H_
+
+
+// Framebuffer wire format conversion, see rpcFrameFormat for the layouts
+
+// bytes count pixels take in the given format
+size_t pixelFormatSize(rpcFrameFormat format, size_t count);
+
+// formats resolving through a palette, see FramePalette
+static inline bool pixelFormatIndexed(rpcFrameFormat format)
+{
+	return (format == rpcFrameFormat::Indexed8) || (format == rpcFrameFormat::Indexed4);
+}
+
+// palette entries an indexed format addresses, 0 for direct color formats
+size_t pixelFormatColors(rpcFrameFormat format);
+
+// capability bit the panel reports for the given format, 0 for the native RGB888
+uint32_t pixelFormatCapability(rpcFrameFormat format);
+
+// convert count pixels into the given direct color format, dest holds pixelFormatSize() bytes
+void pixelFormatConvert(rpcFrameFormat format, const rgb24 *src, size_t count, uint8_t *dest);
+
+// vector kernels picked for the host CPU, for information
+const char* pixelFormatKernels();
+
+
+#endif // XPM_PIXELFORMAT_H_
@@ -14,7 +14,16 @@ XPMUSBInterface		mDevice;
 
 XpmRPC::XpmRPC()
 :	mBatch(false),
-	mOK(true)
+	mBatchType(rpcType::Drawing),
+	mBatchSize(0),
+	mBatchCount(0),
+	mBatchTotal(0),
+	mOK(true),
+	mCaps(0),
+	mFenceIssued(0),
+	mFenceReached(0),
+	mRecord(NULL),
+	mListRecording(false)
 {
 	memset(rpcDataTX, 0, sizeof(rpcDataTX));
 	memset(rpcDataRX, 0, sizeof(rpcDataRX));
@@ -34,6 +43,10 @@ bool XpmRPC::prepare()
 	if(!send(rpcType::System, rpcSystem::Version, NULL, 0))
 		return false;
 
+	// request feature bits, older firmware won't reply and leaves them cleared
+	if(!send(rpcType::System, rpcSystem::Capabilities, NULL, 0))
+		return false;
+
 	// succcess
 	return true;
 }
@@ -45,10 +58,41 @@ bool XpmRPC::prepare()
 
 bool XpmRPC::send(rpcType type, uint8_t cmd, const uint8_t *data, size_t size, bool clean, const uint8_t *data2, size_t size2)
 {
+	std::lock_guard<std::recursive_mutex> lock(mLock);
+
 	// reject over max payload size
 	if((size + size2) > RPCPL_SIZE)
 		return false;
 
+	// gather packable commands into the pending Packed command
+	if(mBatch && !mRecord)
+	{
+		uint8_t packed = packedSize(type, cmd);
+
+		if((packed != 0xFF) && !size2)
+		{
+			if(mBatchCount && ((type != mBatchType) || ((mBatchSize + 1 + packed) > RPCPL_SIZE)))
+				batchFlush();
+
+			if(size > packed)
+				size = packed;
+
+			mBatchType = type;
+			mBatchData[mBatchSize++] = cmd;
+			if(size)
+				memcpy(&mBatchData[mBatchSize], data, size);
+			if(size < packed)
+				memset(&mBatchData[mBatchSize + size], 0, packed - size);
+			mBatchSize += packed;
+			mBatchCount++;
+			mBatchTotal++;
+			return true;
+		}
+
+		// keep command order
+		batchFlush();
+	}
+
 	// set command bytes
 	rpcDataTX[0] = (uint8_t)type;
 	rpcDataTX[1] = (uint8_t)cmd;
@@ -62,6 +106,13 @@ bool XpmRPC::send(rpcType type, uint8_t cmd, const uint8_t *data, size_t size, b
 	if(clean && ((size + size2) < RPCPL_SIZE))
 		memset(&rpcDataTX[RPCC_SIZE + (size + size2)], 0, RPCPL_SIZE - (size + size2));
 
+	// defer packet into the active recording
+	if(mRecord)
+	{
+		mRecord->insert(mRecord->end(), rpcDataTX, rpcDataTX + sizeof(rpcDataTX));
+		return true;
+	}
+
 	if(!mDevice.write(rpcDataTX, sizeof(rpcDataTX)))
 	{
 //		printf("device I/O error: (%d) %s\n", errno, strerror(errno));
@@ -75,10 +126,19 @@ bool XpmRPC::send(rpcType type, uint8_t cmd, const uint8_t *data, size_t size, b
 
 bool XpmRPC::sendTypeFrame(uint8_t flags, const uint8_t *data, size_t size)
 {
+	std::lock_guard<std::recursive_mutex> lock(mLock);
+
 	// reject over max payload size
 	if(size > (RPCDATA_SIZE -1))
 		return false;
 
+	// framebuffer packets can't be part of a display list
+	if(mListRecording)
+		return false;
+
+	if(mBatch)
+		batchFlush();
+
 	// set command byte
 	rpcDataTX[0] = (uint8_t)rpcType::Framebuffer | flags;
 
@@ -99,6 +159,8 @@ bool XpmRPC::sendTypeFrame(uint8_t flags, const uint8_t *data, size_t size)
 
 bool XpmRPC::transfer(uint8_t slot, const uint8_t *src, size_t size)
 {
+	std::lock_guard<std::recursive_mutex> lock(mLock);
+
 	tRPCXfer xfer;
 
 	if(slot >= IOBUFFERS_COUNT)
@@ -134,6 +196,8 @@ bool XpmRPC::transfer(uint8_t slot, const uint8_t *src, size_t size)
 
 int XpmRPC::poll(unsigned int timeout)
 {
+	std::lock_guard<std::recursive_mutex> lock(mLock);
+
 	int proccount = 0;
 
 	
@@ -182,6 +246,21 @@ void XpmRPC::onSystem(rpcSystem cmd, uint8_t *data, size_t size)
 			// do something with response
 			break;
 		}
+		case rpcSystem::Capabilities:
+		{
+			memcpy(&mCaps, data, sizeof(mCaps));
+			break;
+		}
+		case rpcSystem::Fence:
+		{
+			uint32_t fence;
+
+			// panel has executed everything sent before this fence
+			memcpy(&fence, data, sizeof(fence));
+			if((int32_t)(fence - mFenceReached) > 0)
+				mFenceReached = fence;
+			break;
+		}
 		default:
 			break;
 	}
@@ -263,31 +342,143 @@ void XpmRPC::onDisplay(rpcDisplay cmd, uint8_t *data, size_t size)
 
 
 
-// command batching place holders
+//-----------------------------------------------------------------------------
+// Command batching
+//-----------------------------------------------------------------------------
+
+/**
+ * Payload size of a command inside a Packed command.
+ * 
+ * @return	Size in bytes, 0xFF if the command can't be packed.
+ */
+uint8_t XpmRPC::packedSize(rpcType type, uint8_t cmd)
+{
+	const tRPCPacked *table;
+
+
+	switch(type)
+	{
+		case rpcType::Display:	table = m_RPCP_Display;	break;
+		case rpcType::Drawing:	table = m_RPCP_Drawing;	break;
+		default:
+			return 0xFF;
+	}
+
+	for(; table->size; table++)
+	{
+		if(table->cmd == cmd)
+			return table->size;
+	}
+
+	return 0xFF;
+}
+
 void XpmRPC::batchBegin()
 {
+	std::lock_guard<std::recursive_mutex> lock(mLock);
+
 	if(mBatch)
 		return;
 	
-	mBatch = true;
+	mBatch      = true;
+	mBatchTotal = 0;
 }
 
+/**
+ * Send the pending Packed command and stop batching.
+ * 
+ * @return	Number of commands packed since batchBegin().
+ */
 int XpmRPC::batchEnd()
 {
+	std::lock_guard<std::recursive_mutex> lock(mLock);
+
 	if(!mBatch)
 		return 0;
 
+	batchFlush();
 	mBatch = false;
-	return 0;
+	return (int)mBatchTotal;
 }
 
 int XpmRPC::batchFlush()
 {
-	return 0;
+	int count = (int)mBatchCount;
+
+
+	if(!count)
+		return 0;
+
+	// a lone command goes out as itself
+	mBatch = false;
+	if(count == 1)
+		send(mBatchType, mBatchData[0], &mBatchData[1], mBatchSize -1, true);
+	else
+		send(mBatchType, 0 /* Packed */, mBatchData, mBatchSize, true);
+	mBatch = true;
+
+	mBatchSize  = 0;
+	mBatchCount = 0;
+	return count;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Command stream fences
+//-----------------------------------------------------------------------------
+
+/**
+ * Insert a tagged marker into the command stream. The panel echoes it back
+ * once every command sent before it has executed, see fenceReached().
+ * 
+ * @return	Fence tag to poll or wait on, 0 when the firmware has no fence
+ * 			support (no RPCCAP_FENCE in its Capabilities reply) or the send failed.
+ */
+uint32_t XpmRPC::fenceInsert()
+{
+	uint32_t fence = mFenceIssued + 1;
+
+
+	if(!hasCapability(RPCCAP_FENCE))
+		return 0;
+
+	if(!send(rpcType::System, rpcSystem::Fence, &fence, sizeof(fence)))
+		return 0;
+
+	mFenceIssued = fence;
+	return fence;
+}
+
+
+
+//-----------------------------------------------------------------------------
+// Command recording
+//-----------------------------------------------------------------------------
+
+/**
+ * Send previously recorded packets again, into the active recording if any,
+ * else batched when batching is active.
+ * 
+ * @param packets	Packet stream captured while record() was active.
+ * @return	false on device I/O error.
+ */
+bool XpmRPC::replay(const std::vector<uint8_t> &packets)
+{
+	for(size_t offset = 0; (offset + RPCDATA_SIZE) <= packets.size(); offset += RPCDATA_SIZE)
+	{
+		const uint8_t *packet = &packets[offset];
+
+		if(!send((rpcType)packet[0], packet[1], &packet[RPCC_SIZE], RPCPL_SIZE))
+			return false;
+	}
+
+	return true;
 }
 
 
 
+
 //-----------------------------------------------------------------------------
 // System functions
 //-----------------------------------------------------------------------------
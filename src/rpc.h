@@ -37,6 +37,62 @@ struct tSerialXfer
   // rest data..
 };
 
+struct tRPCFrameSegment
+{
+  uint16_t  index;      // segment number of RPCFB_SEGMENT_SIZE bytes into the framebuffer, or RPCFB_SEGMENT_NONE
+  // rest segment data..
+};
+
+struct tRPCFrameCompressed
+{
+  uint16_t  index;      // first segment number | RPCFB_SEGMENT_COMPRESSED
+  uint8_t   count;      // consecutive segments the tokens decode into
+  // rest compressed tokens..
+};
+
+struct tRPCDisplayList
+{
+  uint8_t   op;         // rpcDisplayListOp
+  uint8_t   handle;     // display list identifier, 1 - RPCDL_HANDLES
+  uint8_t   slot;       // I/O buffer holding list data for Store and Append
+};
+
+struct tRPCMonoBitmap
+{
+  uint8_t   width;      // bitmap size in pixels
+  uint8_t   height;
+  uint8_t   color[3];   // rgb24 of set bits, clear bits are left untouched
+  // rest rows of (width +7) / 8 bytes, most significant bit leftmost..
+};
+
+struct tRPCBitmap
+{
+  uint8_t   format;     // rpcBitmapFormat
+  uint8_t   width;      // bitmap size in pixels
+  uint8_t   height;
+  // rest pixel data, mono rows as tRPCMonoBitmap or rgb24 pixels..
+};
+
+struct tRPCSprite
+{
+  uint8_t   op;         // rpcSpriteOp
+  uint8_t   handle;     // sprite identifier, 1 - RPCSPR_HANDLES
+  uint8_t   slot;       // I/O buffer holding sprite data for Store and Append
+  int16_t   x, y;       // Blit position of the top left pixel
+  uint8_t   flags;      // Blit RPCSPR_FLAG_*
+  uint8_t   color[3];   // Blit rgb24, mono set bits color or the transparent key color
+};
+
+struct tRPCDrawBatch
+{
+  uint8_t   cmd;        // rpcDrawing of every entry, DrawPixel, DrawLine, DrawFastVLine or DrawFastHLine
+  uint8_t   count;      // entries following
+  uint8_t   flags;      // RPCBATCH_FLAG_*
+  int16_t   shared[2];  // RPCBATCH_FLAG_SHARED coordinates, y0, y1 of DrawFastVLine or x0, x1 of DrawFastHLine
+  uint8_t   color[3];   // RPCBATCH_FLAG_COLOR rgb24 of all entries
+  // rest entries, the command's coordinates less shared ones, followed by rgb24 unless shared..
+};
+
 struct tRemoteEvent
 {
   uint8_t   command;        // new and current command
@@ -68,8 +124,24 @@ enum class rpcSystem
   Version,                       // Query firmware version
   Ping,                          // Ping? Pong!
   Timestamp,                     // Set current date and time via unix timestamp
+  Capabilities,                  // Query firmware feature bits
+  Fence,                         // Echo tag once all prior commands have executed
 };
 
+// System -> Capabilities reply bits, missing reply (older firmware) means none
+#define RPCCAP_FENCE          0x00000001    // Fence command is echoed with its tag
+#define RPCCAP_FB_SEGMENTS    0x00000002    // Framebuffer packets accept RPCFB_FLAG_ADDRESS
+#define RPCCAP_DISPLAYLIST    0x00000004    // Drawing -> DisplayList command is supported
+#define RPCCAP_COPYBUFFER     0x00000008    // Display -> CopyBuffer command is supported
+#define RPCCAP_FB_RGB565      0x00000010    // Display -> FrameFormat accepts rpcFrameFormat::RGB565
+#define RPCCAP_FB_RGB444      0x00000020    // Display -> FrameFormat accepts rpcFrameFormat::RGB444
+#define RPCCAP_FB_RGB332      0x00000040    // Display -> FrameFormat accepts rpcFrameFormat::RGB332
+#define RPCCAP_FB_INDEXED     0x00000080    // Display -> FrameFormat accepts the indexed formats, palette segments
+#define RPCCAP_FB_COMPRESSED  0x00000100    // Framebuffer packets accept RPCFB_SEGMENT_COMPRESSED segments
+#define RPCCAP_SPRITES        0x00000200    // Drawing -> Sprite command and DrawMonoBitmap are supported
+#define RPCCAP_DRAWBATCH      0x00000400    // Drawing -> DrawBatch command is supported
+#define RPCCAP_SHIFTBUFFER    0x00000800    // Display -> ShiftBuffer command is supported
+
 // Input/Output commands
 enum class rpcIO
 {
@@ -105,6 +177,9 @@ enum class rpcDisplay
   Brightness,                    // Set display brightness
   SwapBuffers,                   // Make drawn framebuffer active
   Mode,                          // Display operation mode
+  CopyBuffer,                    // Copy displayed framebuffer into drawing framebuffer
+  FrameFormat,                   // Pixel format of framebuffer packet payloads, rpcFrameFormat
+  ShiftBuffer,                   // Copy displayed framebuffer into drawing framebuffer moved by an offset
 };
 static const tRPCPacked m_RPCP_Display[] =
 {
@@ -112,6 +187,9 @@ static const tRPCPacked m_RPCP_Display[] =
   { (uint8_t)rpcDisplay::Brightness,   2 },
   { (uint8_t)rpcDisplay::SwapBuffers,  1 },
   { (uint8_t)rpcDisplay::Mode,         1},
+  { (uint8_t)rpcDisplay::CopyBuffer,   1 },
+  { (uint8_t)rpcDisplay::FrameFormat,  1 },
+  { (uint8_t)rpcDisplay::ShiftBuffer,  sizeof(int16_t)*2 },
   {0, 0} // end of list
 };
 
@@ -152,6 +230,9 @@ enum class rpcDrawing
   DrawString,
   DrawMonoBitmap,
   GIFAnimation,
+  DisplayList,                   // Store or replay a list of packed drawing commands
+  Sprite,                        // Store or blit a bitmap kept on the panel
+  DrawBatch,                     // Many pixels or lines of one kind in a single packet
 
 };
 static const tRPCPacked m_RPCP_Drawing[] =
@@ -188,6 +269,8 @@ static const tRPCPacked m_RPCP_Drawing[] =
   { (uint8_t)rpcDrawing::DrawString,          sizeof(int16_t)*2 + sizeof(rgb24)*2 + 1 },
   { (uint8_t)rpcDrawing::DrawMonoBitmap,      sizeof(int16_t)*2 + 1 },
   { (uint8_t)rpcDrawing::GIFAnimation,        2 + sizeof(int16_t)*2 },
+  { (uint8_t)rpcDrawing::DisplayList,         sizeof(tRPCDisplayList) },
+  { (uint8_t)rpcDrawing::Sprite,              sizeof(tRPCSprite) },
 
   {0, 0} // end of list
 };
@@ -200,6 +283,11 @@ enum rpcScrollState
   ScrollState_Append
 };
 
+// Display -> ShiftBuffer
+// Parameters are int16 dx, dy. Displayed pixel x, y lands on drawing buffer pixel x + dx, y + dy,
+// drawing buffer pixels nothing lands on get the displayed pixel at their own position.
+
+
 // Drawing -> GIFAnimation
 #define RPCGIF_FLAG_LOAD      0x80    // Load GIF from filesystem flag
 #define RPCGIF_FLAG_POS       0x40    // Set GIFPlayer position flag
@@ -215,11 +303,92 @@ enum class rpcGIFState
 };
 
 
+// Drawing -> DisplayList
+// List data is a Packed drawing command payload of any length, except DrawString entries are
+// followed by a length byte and the string, which is placed into the entry's buffer slot first.
+#define RPCDL_HANDLES         16      // display lists the panel can hold
+#define RPCDL_MAXSIZE         1024    // largest display list data in bytes
+
+enum class rpcDisplayListOp
+{
+  Free = 0,                       // Release list storage
+  Store,                          // Replace list data with buffer slot contents
+  Append,                         // Append buffer slot contents to list data
+  Call,                           // Execute list
+};
+
+
+// Drawing -> DrawMonoBitmap
+// Parameters are the position and a buffer slot holding tRPCMonoBitmap followed by its rows.
+
+// Drawing -> Sprite
+// Sprite data is tRPCBitmap followed by its pixel data, stored once and blitted by handle.
+#define RPCSPR_HANDLES        16      // sprites the panel can hold
+#define RPCSPR_MAXSIZE        2048    // largest sprite data in bytes, including tRPCBitmap
+#define RPCSPR_FLAG_KEY       0x01    // Blit skips rgb24 pixels equal to the color
+
+enum class rpcBitmapFormat
+{
+  Mono = 0,                       // 1 bit per pixel, set bits drawn in the blit color
+  RGB24,                          // rgb24 per pixel
+};
+
+enum class rpcSpriteOp
+{
+  Free = 0,                       // Release sprite storage
+  Store,                          // Replace sprite data with buffer slot contents
+  Append,                         // Append buffer slot contents to sprite data
+  Blit,                           // Draw sprite
+};
+
+
+// Drawing -> DrawBatch
+// Variable length and never packed, tRPCDrawBatch followed by count entries.
+#define RPCBATCH_FLAG_COLOR   0x01    // all entries use the header color, entries hold coordinates only
+#define RPCBATCH_FLAG_SHARED  0x02    // DrawFastVLine entries hold x only, DrawFastHLine entries y only
+
+
 
 #define RPCDATA_SIZE  64                          // storage buffer size in bytes
 #define RPCC_SIZE     2                           // command size in bytes
 #define RPCPL_SIZE    (RPCDATA_SIZE - RPCC_SIZE)  // payload size in bytes
 
+// Framebuffer packets, flags share the type byte
+#define RPCFB_FLAG_APPEND     0x10    // Continue at the raster position the previous packet ended
+#define RPCFB_FLAG_SWAP       0x20    // Swap framebuffers after this packet
+#define RPCFB_FLAG_ADDRESS    0x40    // Payload starts with tRPCFrameSegment, swap copies displayed into drawing buffer
+#define RPCFB_FLAG_DEBUG      0x80    // Raster debug visual aid, unique colors per raster segment
+#define RPCFB_RASTER_SIZE     (RPCDATA_SIZE -1)                           // sequential raster payload size in bytes
+#define RPCFB_SEGMENT_SIZE    60                                          // addressed segment payload size in bytes
+#define RPCFB_SEGMENT_NONE    0xFFFF                                      // addressed packet without segment data
+#define RPCFB_SEGMENT_PALETTE 0x8000                                      // segment index flag, payload goes into the drawing buffer's palette
+#define RPCFB_PALETTE_SIZE    256                                         // palette entries, rgb24 each
+#define RPCFB_SEGMENT_COMPRESSED 0x4000                                   // segment index flag, payload is tRPCFrameCompressed
+#define RPCFB_COMPRESSED_SIZE (RPCFB_RASTER_SIZE - sizeof(tRPCFrameCompressed))  // compressed token bytes per packet
+#define RPCFB_LITERAL_MAX     0x80                                        // longest literal token in bytes
+#define RPCFB_MATCH_MIN       4                                           // shortest match token in bytes
+#define RPCFB_MATCH_MAX       (RPCFB_MATCH_MIN + 0x7F)                    // longest match token in bytes
+
+// Compressed segment tokens decode in order into the segments' bytes, never across a segment boundary
+//   0x00 - 0x7F  literal, (token +1) bytes follow
+//   0x80 - 0xFF  match, uint16 distance follows, (token - 0x80 + RPCFB_MATCH_MIN) bytes are copied
+//                from distance bytes back, overlapping and reaching into earlier segments of this frame
+
+// Display -> FrameFormat, pixel layout of framebuffer packet payloads, raster positions and
+// segments count bytes of this layout, the panel resets to RGB888
+// Indexed formats resolve through a palette double buffered along with the framebuffer, its
+// bytes are addressed as segments RPCFB_SEGMENT_PALETTE | n, palette only updates take effect
+// with the next swap and recolor the whole frame
+enum class rpcFrameFormat
+{
+  RGB888 = 0,                    // 3 bytes per pixel, red green blue
+  RGB565,                        // 2 bytes per pixel, little endian rrrrrggg gggbbbbb
+  RGB444,                        // 3 bytes per 2 pixels, nibbles r0 g0 b0 r1 g1 b1 high nibble first
+  RGB332,                        // 1 byte per pixel, rrrgggbb
+  Indexed8,                      // 1 byte per pixel, palette index
+  Indexed4,                      // 2 pixels per byte, palette index high nibble first, first 16 entries
+};
+
 
 
 // Remote Procedure Call class
@@ -229,7 +398,18 @@ private:
 	uint8_t		rpcDataTX[RPCDATA_SIZE];
 	uint8_t		rpcDataRX[RPCDATA_SIZE];
 	bool		mBatch;
+	rpcType		mBatchType;		// command type of the pending Packed command
+	uint8_t		mBatchData[RPCPL_SIZE];	// pending Packed command payload
+	size_t		mBatchSize;
+	size_t		mBatchCount;	// commands in pending Packed command
+	size_t		mBatchTotal;	// commands packed since batchBegin()
 	bool		mOK;
+	uint32_t	mCaps;			// firmware capability bits, RPCCAP_*
+	uint32_t	mFenceIssued;	// last fence tag inserted into the command stream
+	uint32_t	mFenceReached;	// last fence tag echoed back by the panel
+	std::vector<uint8_t> *mRecord;	// packets deferred here instead of sent, see record()
+	bool		mListRecording;	// a display list is being recorded, framebuffer packets are refused
+	std::recursive_mutex mLock;		// serializes device I/O between threads
 
 
 	void onSystem	(rpcSystem	cmd, uint8_t *data, size_t size);
@@ -248,6 +428,9 @@ public:
 	bool prepare();
 	
 	bool ok()		{ return mOK; }
+	// held across several calls to keep them together, e.g. a whole frame
+	std::recursive_mutex& mutex()			{ return mLock; }
+	bool hasCapability(uint32_t cap) const	{ return (mCaps & cap) == cap; }
 
 	bool send(rpcType type, uint8_t cmd, const uint8_t *data, size_t size, bool clean = false, const uint8_t *data2 = NULL, size_t size2 = 0);
 	template<typename T1>
@@ -266,9 +449,25 @@ public:
 
 	int  poll(unsigned int timeout = 50);
 
-	// command batching
+	// command batching, packable Display and Drawing commands are combined into Packed commands
 	void batchBegin();
 	int  batchEnd();
+	bool batching() const						{ return mBatch; }
+
+	// payload size of a command inside a Packed command, 0xFF if it can't be packed
+	static uint8_t packedSize(rpcType type, uint8_t cmd);
+
+	// command recording
+	void record(std::vector<uint8_t> *packets)	{ mRecord = packets; }
+	bool recording() const						{ return mRecord != NULL; }
+	void listRecording(bool active)				{ mListRecording = active; }
+	bool replay(const std::vector<uint8_t> &packets);
+
+	// command stream fences
+	uint32_t fenceInsert();
+	bool     fenceReached(uint32_t fence) const	{ return fence && ((int32_t)(mFenceReached - fence) >= 0); }
+	uint32_t fencesPending() const				{ return mFenceIssued - mFenceReached; }
+	uint32_t fenceLast() const					{ return mFenceIssued; }
 
 	// system procedures
 	void resetClient();
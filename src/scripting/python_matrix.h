@@ -1,5 +1,14 @@
 #include "rpc.h"
 #include "matrix.h"
+#include "framebuffer.h"
+#include "framepalette.h"
+#include "framestream.h"
+#include "frameencoder.h"
+#include "framescheduler.h"
+#include "colortables.h"
+#include "image.h"
+#include "videoplayer.h"
+#include "virtualcanvas.h"
 
 /*
  * SmartMatrix wrapper library exposure to Python environment.
@@ -50,6 +59,52 @@ Abort:
 }
 
 
+// read only buffer protocol object, e.g. str, bytearray or array.array
+static bool parseBuffer(const void *&data, size_t &size, PyObject *src, const char *name)
+{
+	Py_ssize_t length = 0;
+
+	if(PyObject_AsReadBuffer(src, &data, &length) < 0)
+		return false;
+
+	size = (size_t)length;
+	if(size)
+		return true;
+
+	PyErr_Format(PyExc_ValueError, "%s: empty buffer", name);
+	return false;
+}
+
+// batch colors, a single rgb24 for all entries or a buffer of count rgb24 byte triples
+static bool parseBatchColors(const rgb24 *&colors, rgb24 &one, bool &oneColor, PyObject *src, size_t count, const char *name)
+{
+	const void	*data;
+	size_t		 size;
+
+
+	if((oneColor = PyObject_HasAttrString(src, "value")))
+	{
+		colors = &one;
+		if(parseRGB24(one, src))
+			return true;
+
+		PyErr_Format(PyExc_ValueError, "%s: invalid rgb24 color", name);
+		return false;
+	}
+
+	if(!parseBuffer(data, size, src, name))
+		return false;
+
+	if(size < (count * sizeof(rgb24)))
+	{
+		PyErr_Format(PyExc_ValueError, "%s: not enough colors", name);
+		return false;
+	}
+
+	colors = (const rgb24 *)data;
+	return true;
+}
+
 
 //=============================================================================
 // Text Scroller hooks
@@ -399,6 +454,194 @@ static PyObject *Matrix_getScroller(tMatrixObject *self, PyObject *args)
 	return self->scrollers[scroller];
 }
 
+static PyObject *Matrix_setShadow(tMatrixObject *self, PyObject *args)
+{
+	int			enable;
+
+
+	if(!PyArg_ParseTuple(args, "i:setShadow", &enable))
+		return NULL;
+
+	return Py_BuildValue("N", PyBool_FromLong(self->matrix->setShadow((bool)enable)));
+}
+
+static PyObject *Matrix_getShadowPixel(tMatrixObject *self, PyObject *args)
+{
+	int16_t		x, y;
+
+
+	if(!PyArg_ParseTuple(args, "hh:getShadowPixel", &x, &y))
+		return NULL;
+
+	FrameBuffer *shadow = self->matrix->getShadow();
+	if(!shadow)
+	{
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	rgb24 color = shadow->getPixel(x, y);
+	return Py_BuildValue("[i,i,i]", color.red, color.green, color.blue);
+}
+
+static PyObject *Matrix_setFrameEncoder(tMatrixObject *self, PyObject *args)
+{
+	int			enable;
+
+
+	if(!PyArg_ParseTuple(args, "i:setFrameEncoder", &enable))
+		return NULL;
+
+	return Py_BuildValue("N", PyBool_FromLong(self->matrix->setFrameEncoder((bool)enable)));
+}
+
+static PyObject *Matrix_getFrameEncoding(tMatrixObject *self)
+{
+	const FrameEncoder *encoder = self->matrix->getFrameEncoder();
+
+	return Py_BuildValue("i", (encoder)? (int)encoder->encoding : (int)FrameEncoding::None);
+}
+
+static PyObject *Matrix_setCopyElision(tMatrixObject *self, PyObject *args)
+{
+	int			enable;
+
+
+	if(!PyArg_ParseTuple(args, "i:setCopyElision", &enable))
+		return NULL;
+
+	return Py_BuildValue("N", PyBool_FromLong(self->matrix->setCopyElision((bool)enable)));
+}
+
+static PyObject *Matrix_setCommandBuffer(tMatrixObject *self, PyObject *args)
+{
+	int			enable;
+
+
+	if(!PyArg_ParseTuple(args, "i:setCommandBuffer", &enable))
+		return NULL;
+
+	return Py_BuildValue("N", PyBool_FromLong(self->matrix->setCommandBuffer((bool)enable)));
+}
+
+static PyObject *Matrix_getCulledCommands(tMatrixObject *self)
+{
+	return Py_BuildValue("k", (unsigned long)self->matrix->culledCommands);
+}
+
+static PyObject *Matrix_displayListBegin(tMatrixObject *self)
+{
+	self->matrix->displayListBegin();
+	
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *Matrix_displayListEnd(tMatrixObject *self)
+{
+	return Py_BuildValue("i", self->matrix->displayListEnd());
+}
+
+static PyObject *Matrix_displayListCall(tMatrixObject *self, PyObject *args)
+{
+	int			handle;
+
+
+	if(!PyArg_ParseTuple(args, "i:displayListCall", &handle))
+		return NULL;
+
+	return Py_BuildValue("N", PyBool_FromLong(self->matrix->displayListCall(handle)));
+}
+
+static PyObject *Matrix_displayListFree(tMatrixObject *self, PyObject *args)
+{
+	int			handle;
+
+
+	if(!PyArg_ParseTuple(args, "i:displayListFree", &handle))
+		return NULL;
+
+	self->matrix->displayListFree(handle);
+	
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *Matrix_spriteCreate(tMatrixObject *self, PyObject *args)
+{
+	uint8_t		width, height;
+	const char	*data;
+	int			size;
+	int			mono = 0;
+
+
+	if(!PyArg_ParseTuple(args, "bbs#|i:spriteCreate", &width, &height, &data, &size, &mono))
+		return NULL;
+
+	// mono rows of (width +7) / 8 bytes, else rgb24 pixels
+	const size_t expected = mono? ((size_t)((width + 7) / 8) * height) : ((size_t)width * height * sizeof(rgb24));
+	if((size_t)size < expected)
+	{
+		PyErr_SetString(PyExc_ValueError, "spriteCreate: not enough bitmap data");
+		return NULL;
+	}
+
+	if(mono)
+		return Py_BuildValue("i", self->matrix->spriteCreate(width, height, (const uint8_t *)data));
+
+	return Py_BuildValue("i", self->matrix->spriteCreate(width, height, (const rgb24 *)data));
+}
+
+static PyObject *Matrix_spriteDraw(tMatrixObject *self, PyObject *args)
+{
+	int			handle;
+	int16_t		x, y;
+	PyObject	*rgb;
+	int			transparent = 0;
+
+
+	if(!PyArg_ParseTuple(args, "ihhO|i:spriteDraw", &handle, &x, &y, &rgb, &transparent))
+		return NULL;
+
+	rgb24 color;
+	if(!parseRGB24(color, rgb))
+		return Py_BuildValue("N", PyBool_FromLong(false));
+
+	return Py_BuildValue("N", PyBool_FromLong(self->matrix->spriteDraw(handle, x, y, color, (bool)transparent)));
+}
+
+static PyObject *Matrix_imageSprite(tMatrixObject *self, PyObject *args)
+{
+	const char	*path;
+	int16_t		 width  = 0;
+	int16_t		 height = 0;
+	int			 fit    = (int)imageFit::Contain;
+
+
+	if(!PyArg_ParseTuple(args, "s|hhi:imageSprite", &path, &width, &height, &fit))
+		return NULL;
+
+	const FrameBuffer *image = imageCache.get(path, width, height, (imageFit)fit);
+	if(!image || (image->width() > 255) || (image->height() > 255))
+		return Py_BuildValue("i", 0);
+
+	return Py_BuildValue("i", self->matrix->spriteCreate((uint8_t)image->width(), (uint8_t)image->height(), image->pixels()));
+}
+
+static PyObject *Matrix_spriteFree(tMatrixObject *self, PyObject *args)
+{
+	int			handle;
+
+
+	if(!PyArg_ParseTuple(args, "i:spriteFree", &handle))
+		return NULL;
+
+	self->matrix->spriteFree(handle);
+	
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 
 //-----------------------------------------------------------------------------
 // display control
@@ -495,6 +738,48 @@ static PyObject *Matrix_safeSleep(tMatrixObject *self, PyObject *args)
 	return Py_BuildValue("N", PyBool_FromLong(result));
 }
 
+static PyObject *Matrix_setFrameRate(tMatrixObject *self, PyObject *args)
+{
+	float		fps;
+
+
+	if(!PyArg_ParseTuple(args, "f:setFrameRate", &fps))
+		return NULL;
+
+	self->matrix->setFrameRate(fps);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *Matrix_waitFrame(tMatrixObject *self)
+{
+	size_t slots = self->matrix->waitFrame();
+
+	if(gm_Exit)
+		PyErr_SetInterrupt();
+
+	return Py_BuildValue("k", slots);
+}
+
+static PyObject *Matrix_getFrameStats(tMatrixObject *self)
+{
+	const FrameScheduler *scheduler = self->matrix->getScheduler();
+
+	if(!scheduler)
+	{
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	return Py_BuildValue("{s:k,s:k,s:k,s:d,s:d}",
+		"frames",	scheduler->frames,
+		"dropped",	scheduler->dropped,
+		"missed",	scheduler->missed,
+		"lateness",	scheduler->lateness / 1000000000.0,
+		"worst",	scheduler->worst / 1000000000.0);
+}
+
 static PyObject *Matrix_setMode(tMatrixObject *self, PyObject *args)
 {
 	int			mode;
@@ -509,6 +794,39 @@ static PyObject *Matrix_setMode(tMatrixObject *self, PyObject *args)
 	return Py_None;
 }
 
+static PyObject *Matrix_fence(tMatrixObject *self)
+{
+	return Py_BuildValue("k", (unsigned long)self->matrix->fence());
+}
+
+static PyObject *Matrix_fenceReached(tMatrixObject *self, PyObject *args)
+{
+	unsigned long	fence;
+
+
+	if(!PyArg_ParseTuple(args, "k:fenceReached", &fence))
+		return NULL;
+
+	return Py_BuildValue("N", PyBool_FromLong(self->matrix->fenceReached((uint32_t)fence)));
+}
+
+static PyObject *Matrix_waitForFence(tMatrixObject *self, PyObject *args)
+{
+	unsigned long	fence;
+	float			secs = 1.0f;
+
+
+	if(!PyArg_ParseTuple(args, "k|f:waitForFence", &fence, &secs))
+		return NULL;
+
+	bool result = self->matrix->waitForFence((uint32_t)fence, (size_t)abs(secs * 1000.0f + 0.5f));
+
+	if(gm_Exit)
+		PyErr_SetInterrupt();
+
+	return Py_BuildValue("N", PyBool_FromLong(result));
+}
+
 
 //-----------------------------------------------------------------------------
 // drawing functions
@@ -817,6 +1135,129 @@ static PyObject *Matrix_drawChar(tMatrixObject *self, PyObject *args)
 	return Py_None;
 }
 
+static PyObject *Matrix_drawMonoBitmap(tMatrixObject *self, PyObject *args)
+{
+	int16_t		x, y;
+	uint8_t		width, height;
+	PyObject	*rgb;
+	const char	*bitmap;
+	int			size;
+
+
+	if(!PyArg_ParseTuple(args, "hhbbOs#:drawMonoBitmap", &x, &y, &width, &height, &rgb, &bitmap, &size))
+		return NULL;
+
+	if((size_t)size < ((size_t)((width + 7) / 8) * height))
+	{
+		PyErr_SetString(PyExc_ValueError, "drawMonoBitmap: not enough bitmap data");
+		return NULL;
+	}
+
+	rgb24 color;
+	if(parseRGB24(color, rgb))
+		self->matrix->drawMonoBitmap(x, y, width, height, color, (const uint8_t *)bitmap);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+// image file through the decoded image cache, by default fit to the panel
+static PyObject *Matrix_drawImage(tMatrixObject *self, PyObject *args)
+{
+	const char	*path;
+	int16_t		 x      = 0;
+	int16_t		 y      = 0;
+	int16_t		 width  = 0;
+	int16_t		 height = 0;
+	int			 fit    = (int)imageFit::Contain;
+
+
+	if(!PyArg_ParseTuple(args, "s|hhhhi:drawImage", &path, &x, &y, &width, &height, &fit))
+		return NULL;
+
+	const FrameBuffer *image = imageCache.get(path, width, height, (imageFit)fit);
+
+	return Py_BuildValue("N", PyBool_FromLong(image && self->matrix->drawImage(x, y, *image)));
+}
+
+// blocks while playing, the panel shows nothing else meanwhile
+static PyObject *Matrix_playVideo(tMatrixObject *self, PyObject *args)
+{
+	const char	*path;
+	int			 loops = 1;
+	double		 fps   = 0;
+	VideoPlayer	 video;
+
+
+	if(!PyArg_ParseTuple(args, "s|id:playVideo", &path, &loops, &fps))
+		return NULL;
+
+	if(!video.open(path, 0, 0, fps))
+		return Py_BuildValue("N", PyBool_FromLong(false));
+
+	return Py_BuildValue("N", PyBool_FromLong(video.play(std::max(loops, 0))));
+}
+
+// batch drawing, coordinates are native int16 buffers such as array.array('h'), colors a single
+// rgb24 or a buffer of rgb24 byte triples per entry
+static PyObject *Matrix_drawBatch(tMatrixObject *self, PyObject *args, rpcDrawing cmd, const char *format, const char *name)
+{
+	PyObject		*coords, *rgb;
+	int16_t			 shared[2] = {0, 0};
+	const void		*data;
+	size_t			 size;
+	const rgb24		*colors;
+	rgb24			 one;
+	bool			 oneColor;
+
+
+	const bool vlines = (cmd == rpcDrawing::DrawFastVLine);
+	if(vlines? !PyArg_ParseTuple(args, format, &coords, &shared[0], &shared[1], &rgb) : !PyArg_ParseTuple(args, format, &coords, &rgb))
+		return NULL;
+
+	if(!parseBuffer(data, size, coords, name))
+		return NULL;
+
+	// coordinates per entry
+	const size_t stride = vlines? 1 : ((cmd == rpcDrawing::DrawPixel)? 2 : ((cmd == rpcDrawing::DrawLine)? 4 : 3));
+	const size_t count  = size / (stride * sizeof(int16_t));
+
+	if(!parseBatchColors(colors, one, oneColor, rgb, count, name))
+		return NULL;
+
+	switch(cmd)
+	{
+		case rpcDrawing::DrawPixel:		self->matrix->drawPixels((const int16_t *)data, colors, count, oneColor); break;
+		case rpcDrawing::DrawFastVLine:	self->matrix->drawVLines((const int16_t *)data, shared[0], shared[1], colors, count, oneColor); break;
+		case rpcDrawing::DrawFastHLine:	self->matrix->drawSpans((const int16_t *)data, colors, count, oneColor); break;
+		case rpcDrawing::DrawLine:		self->matrix->drawLines((const int16_t *)data, colors, count, oneColor); break;
+		default: break;
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *Matrix_drawPixels(tMatrixObject *self, PyObject *args)
+{
+	return Matrix_drawBatch(self, args, rpcDrawing::DrawPixel, "OO:drawPixels", "drawPixels");
+}
+
+static PyObject *Matrix_drawVLines(tMatrixObject *self, PyObject *args)
+{
+	return Matrix_drawBatch(self, args, rpcDrawing::DrawFastVLine, "OhhO:drawVLines", "drawVLines");
+}
+
+static PyObject *Matrix_drawSpans(tMatrixObject *self, PyObject *args)
+{
+	return Matrix_drawBatch(self, args, rpcDrawing::DrawFastHLine, "OO:drawSpans", "drawSpans");
+}
+
+static PyObject *Matrix_drawLines(tMatrixObject *self, PyObject *args)
+{
+	return Matrix_drawBatch(self, args, rpcDrawing::DrawLine, "OO:drawLines", "drawLines");
+}
+
 static PyObject *Matrix_drawString(tMatrixObject *self, PyObject *args)
 {
 	Py_ssize_t	argc = PyTuple_Size(args);
@@ -955,6 +1396,20 @@ static PyObject *Matrix_gifPosition(tMatrixObject *self, PyObject *args)
 	return Py_None;
 }
 
+static PyObject *Matrix_gifSize(tMatrixObject *self, PyObject *args)
+{
+	int16_t		width, height;
+
+
+	if(!PyArg_ParseTuple(args, "hh:gifSize", &width, &height))
+		return NULL;
+
+	self->matrix->gifSize(width, height);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 
 
 //-----------------------------------------------------------------------------
@@ -964,13 +1419,34 @@ static PyMethodDef Matrix_methods[] =
 {
 	// utility
 	{ "getScroller",		(PyCFunction)Matrix_getScroller,		METH_VARARGS, "Retrieve specified text scroller object." },
+	{ "setShadow",			(PyCFunction)Matrix_setShadow,			METH_VARARGS, "Enable or disable the host side copy of the drawing framebuffer." },
+	{ "getShadowPixel",		(PyCFunction)Matrix_getShadowPixel,		METH_VARARGS, "Get a pixel value from the host side framebuffer copy." },
+	{ "setFrameEncoder",	(PyCFunction)Matrix_setFrameEncoder,	METH_VARARGS, "Enable or disable per frame encoding of drawing into the cheapest packet stream." },
+	{ "getFrameEncoding",	(PyCFunction)Matrix_getFrameEncoding,	METH_NOARGS,  "Get the encoding used for the last frame, one of the ENCODING_ constants." },
+	{ "setCopyElision",		(PyCFunction)Matrix_setCopyElision,		METH_VARARGS, "Enable or disable skipping buffer swap copies the next frame covers anyway." },
+	{ "setCommandBuffer",	(PyCFunction)Matrix_setCommandBuffer,	METH_VARARGS, "Hold drawing back until the next buffer swap, dropping what ends up invisible." },
+	{ "getCulledCommands",	(PyCFunction)Matrix_getCulledCommands,	METH_NOARGS,  "Get the number of drawing commands dropped as invisible or overdrawn." },
+	{ "displayListBegin",	(PyCFunction)Matrix_displayListBegin,	METH_NOARGS,  "Start recording drawing functions into a display list." },
+	{ "displayListEnd",		(PyCFunction)Matrix_displayListEnd,		METH_NOARGS,  "Finish recording a display list, returns its handle." },
+	{ "displayListCall",	(PyCFunction)Matrix_displayListCall,	METH_VARARGS, "Draw a display list by handle." },
+	{ "displayListFree",	(PyCFunction)Matrix_displayListFree,	METH_VARARGS, "Release a display list by handle." },
+	{ "spriteCreate",		(PyCFunction)Matrix_spriteCreate,		METH_VARARGS, "Upload a rgb24 or mono bitmap, returns its handle." },
+	{ "spriteDraw",			(PyCFunction)Matrix_spriteDraw,			METH_VARARGS, "Draw a sprite by handle." },
+	{ "spriteFree",			(PyCFunction)Matrix_spriteFree,			METH_VARARGS, "Release a sprite by handle." },
+	{ "imageSprite",		(PyCFunction)Matrix_imageSprite,		METH_VARARGS, "Upload a cached image file as sprite, returns its handle or 0." },
 	
 	// display control
 	{ "setBrightness",		(PyCFunction)Matrix_setBrightness,		METH_VARARGS, "Set display brightness level for foreground and background graphics layers." },
 	{ "swapBuffers",		(PyCFunction)Matrix_swapBuffers,		METH_VARARGS, "Swap both drawing and displayed framebuffers." },
 	{ "waitForVSync",		(PyCFunction)Matrix_waitForVSync,		METH_VARARGS, "Block call until display raster vertical retrace." },
 	{ "safeSleep",			(PyCFunction)Matrix_safeSleep,			METH_VARARGS, "Safely delay code execution and still service matrix operations." },
+	{ "setFrameRate",		(PyCFunction)Matrix_setFrameRate,		METH_VARARGS, "Set the target frame rate waitFrame() paces to, 0 to stop pacing." },
+	{ "waitFrame",			(PyCFunction)Matrix_waitFrame,			METH_NOARGS,  "Service the display until the next frame slot, returns the slots elapsed, more than 1 when frames were dropped." },
+	{ "getFrameStats",		(PyCFunction)Matrix_getFrameStats,		METH_NOARGS,  "Get frame pacing statistics, frames, dropped and missed counts, last and worst lateness in seconds." },
 	{ "setMode",			(PyCFunction)Matrix_setMode,			METH_VARARGS, "Set display operation mode state." },
+	{ "fence",				(PyCFunction)Matrix_fence,				METH_NOARGS,  "Insert a fence into the command stream and return its tag, 0 if the display has no fence support." },
+	{ "fenceReached",		(PyCFunction)Matrix_fenceReached,		METH_VARARGS, "Check if the display has executed everything before the fence." },
+	{ "waitForFence",		(PyCFunction)Matrix_waitForFence,		METH_VARARGS, "Block call until the fence is reached or the timeout in seconds expires." },
 
 	// drawing functions
 	{ "drawPixel",			(PyCFunction)Matrix_drawPixel,			METH_VARARGS, "Set a pixel value." },
@@ -989,6 +1465,13 @@ static PyMethodDef Matrix_methods[] =
 	{ "fillScreen",			(PyCFunction)Matrix_fillScreen,			METH_VARARGS, "Fill entire screen." },
 	{ "drawChar",			(PyCFunction)Matrix_drawChar,			METH_VARARGS, "Draw a single character." },
 	{ "drawString",			(PyCFunction)Matrix_drawString,			METH_VARARGS, "Draw a string of characters." },
+	{ "drawMonoBitmap",		(PyCFunction)Matrix_drawMonoBitmap,		METH_VARARGS, "Draw a 1 bit per pixel bitmap." },
+	{ "drawImage",			(PyCFunction)Matrix_drawImage,			METH_VARARGS, "Draw a PNG, PPM or BMP file, decoded once and cached." },
+	{ "playVideo",			(PyCFunction)Matrix_playVideo,			METH_VARARGS, "Play a raw rgb24 or y4m video file loops times, 0 endlessly." },
+	{ "drawPixels",			(PyCFunction)Matrix_drawPixels,			METH_VARARGS, "Draw pixels from an int16 buffer of x, y pairs." },
+	{ "drawVLines",			(PyCFunction)Matrix_drawVLines,			METH_VARARGS, "Draw vertical lines from y0 to y1 at an int16 buffer of x positions." },
+	{ "drawSpans",			(PyCFunction)Matrix_drawSpans,			METH_VARARGS, "Draw horizontal spans from an int16 buffer of x0, x1, y triples." },
+	{ "drawLines",			(PyCFunction)Matrix_drawLines,			METH_VARARGS, "Draw lines from an int16 buffer of x0, y0, x1, y1 quadruples." },
 
 	// fonts
 	{ "setFont",			(PyCFunction)Matrix_setFont,			METH_VARARGS, "Change font to draw text strings with." },
@@ -1000,6 +1483,7 @@ static PyMethodDef Matrix_methods[] =
 	{ "gifPlay",			(PyCFunction)Matrix_gifPlay,			METH_VARARGS, "Start GIF animation." },
 	{ "gifStop",			(PyCFunction)Matrix_gifStop,			METH_NOARGS,  "Stop GIF animation." },
 	{ "gifPosition",		(PyCFunction)Matrix_gifPosition,		METH_VARARGS, "Change GIF animation offset position." },
+	{ "gifSize",			(PyCFunction)Matrix_gifSize,			METH_VARARGS, "Fit host decoded GIF animations into width x height, 0, 0 for their own size." },
 
 	{ NULL, NULL, 0, NULL }
 };
@@ -1058,15 +1542,450 @@ static PyTypeObject tMatrixObjectType =
 
 
 
+//=============================================================================
+// Virtual canvas hooks
+//=============================================================================
+
+struct tCanvasObject
+{
+	PyObject_HEAD
+	VirtualCanvas	*canvas;
+};
+
+
+static PyObject *Canvas_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+	tCanvasObject *self = NULL;
+
+	// allocate ourselves
+	if((self = (tCanvasObject *)type->tp_alloc(type, 0)))
+		self->canvas = NULL;
+
+	return (PyObject *)self;
+}
+
+static int Canvas_init(tCanvasObject *self, PyObject *args, PyObject *kwds)
+{
+	static const char *kwlist[] = {"width", "height", NULL};
+	int16_t width, height;
+
+
+	if(!PyArg_ParseTupleAndKeywords(args, kwds, "hh", (char **)kwlist, &width, &height) ||
+		(width < 0) || (height < 0))
+		return -1;
+
+	delete self->canvas;
+	self->canvas = new VirtualCanvas(width, height);
+	return 0;
+}
+
+static void Canvas_dealloc(tCanvasObject *self)
+{
+	delete self->canvas;
+
+	// deallocate ourselves
+	self->ob_type->tp_free((PyObject *)self);
+}
+
+static PyObject* Canvas_getter(tCanvasObject *self, void *closure)
+{
+	switch((ssize_t)closure)
+	{
+		case 0:	return Py_BuildValue("h", self->canvas->width());
+		case 1:	return Py_BuildValue("h", self->canvas->height());
+		case 2:	return Py_BuildValue("h", self->canvas->x());
+		case 3:	return Py_BuildValue("h", self->canvas->y());
+		default:
+			break;
+	}
+
+	return NULL;
+}
+
+
+//-----------------------------------------------------------------------------
+// canvas content, drawing invalidates what is shown
+//-----------------------------------------------------------------------------
+
+static PyObject *Canvas_fillScreen(tCanvasObject *self, PyObject *args)
+{
+	PyObject	*rgb;
+
+
+	if(!PyArg_ParseTuple(args, "O:fillScreen", &rgb))
+		return NULL;
+
+	rgb24 color;
+	if(parseRGB24(color, rgb))
+	{
+		self->canvas->canvas().fillScreen(color);
+		self->canvas->invalidate();
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *Canvas_drawString(tCanvasObject *self, PyObject *args)
+{
+	int16_t		 x, y;
+	PyObject	*rgb1, *rgb2 = NULL;
+	const char	*text;
+	int			 font = font5x7;
+
+
+	if(!PyArg_ParseTuple(args, "hhOs|Oi:drawString", &x, &y, &rgb1, &text, &rgb2, &font))
+		return NULL;
+
+	rgb24 colorFG, colorBG;
+	if(parseRGB24(colorFG, rgb1) && (!rgb2 || parseRGB24(colorBG, rgb2)))
+	{
+		self->canvas->canvas().setFont((fontChoices)font);
+		self->canvas->canvas().drawString(x, y, colorFG, rgb2? colorBG : colorFG, text);
+		self->canvas->invalidate();
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+// image file through the decoded image cache, by default at its own size
+static PyObject *Canvas_drawImage(tCanvasObject *self, PyObject *args)
+{
+	const char	*path;
+	int16_t		 x      = 0;
+	int16_t		 y      = 0;
+	int16_t		 width  = 0;
+	int16_t		 height = 0;
+	int			 fit    = (int)imageFit::None;
+
+
+	if(!PyArg_ParseTuple(args, "s|hhhhi:drawImage", &path, &x, &y, &width, &height, &fit))
+		return NULL;
+
+	const FrameBuffer *image = imageCache.get(path, width, height, (imageFit)fit);
+	if(image)
+	{
+		self->canvas->canvas().drawImage(x, y, *image);
+		self->canvas->invalidate();
+	}
+
+	return Py_BuildValue("N", PyBool_FromLong(image != NULL));
+}
+
+// whole canvas from a buffer of rgb24 byte triples, e.g. a chart rendered by the script
+static PyObject *Canvas_setPixels(tCanvasObject *self, PyObject *args)
+{
+	PyObject	*src;
+	const void	*data;
+	size_t		 size;
+
+
+	if(!PyArg_ParseTuple(args, "O:setPixels", &src) || !parseBuffer(data, size, src, "setPixels"))
+		return NULL;
+
+	FrameBuffer &canvas = self->canvas->canvas();
+	if(size < (canvas.size() * sizeof(rgb24)))
+	{
+		PyErr_Format(PyExc_ValueError, "setPixels: not enough pixels");
+		return NULL;
+	}
+
+	memcpy((uint8_t *)canvas.pixels(), data, canvas.size() * sizeof(rgb24));
+	self->canvas->invalidate();
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+
+//-----------------------------------------------------------------------------
+// viewport
+//-----------------------------------------------------------------------------
+
+static PyObject *Canvas_setWrap(tCanvasObject *self, PyObject *args)
+{
+	int			wrap;
+
+
+	if(!PyArg_ParseTuple(args, "i:setWrap", &wrap))
+		return NULL;
+
+	self->canvas->setWrap((bool)wrap);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *Canvas_scrollTo(tCanvasObject *self, PyObject *args)
+{
+	int16_t		x, y;
+
+
+	if(!PyArg_ParseTuple(args, "hh:scrollTo", &x, &y))
+		return NULL;
+
+	self->canvas->scrollTo(x, y);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *Canvas_scroll(tCanvasObject *self, PyObject *args)
+{
+	int16_t		dx, dy;
+
+
+	if(!PyArg_ParseTuple(args, "hh:scroll", &dx, &dy))
+		return NULL;
+
+	self->canvas->scroll(dx, dy);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *Canvas_invalidate(tCanvasObject *self)
+{
+	self->canvas->invalidate();
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *Canvas_damage(tCanvasObject *self, PyObject *args)
+{
+	int16_t		x0, y0, x1, y1;
+
+
+	if(!PyArg_ParseTuple(args, "hhhh:damage", &x0, &y0, &x1, &y1))
+		return NULL;
+
+	self->canvas->damage(x0, y0, x1, y1);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *Canvas_show(tCanvasObject *self)
+{
+	return Py_BuildValue("N", PyBool_FromLong(self->canvas->show()));
+}
+
+
+//-----------------------------------------------------------------------------
+
+
+static PyMethodDef Canvas_methods[] =
+{
+	// canvas content
+	{ "fillScreen",		(PyCFunction)Canvas_fillScreen,		METH_VARARGS, "Fill the entire canvas." },
+	{ "drawString",		(PyCFunction)Canvas_drawString,		METH_VARARGS, "Draw a string of characters, optionally with background color and font." },
+	{ "drawImage",		(PyCFunction)Canvas_drawImage,		METH_VARARGS, "Draw a PNG, PPM or BMP file, decoded once and cached." },
+	{ "setPixels",		(PyCFunction)Canvas_setPixels,		METH_VARARGS, "Replace the canvas with a buffer of rgb triples." },
+
+	// viewport
+	{ "setWrap",		(PyCFunction)Canvas_setWrap,		METH_VARARGS, "Repeat the canvas in both directions." },
+	{ "scrollTo",		(PyCFunction)Canvas_scrollTo,		METH_VARARGS, "Move the viewport origin to x, y." },
+	{ "scroll",			(PyCFunction)Canvas_scroll,			METH_VARARGS, "Move the viewport origin by dx, dy." },
+	{ "invalidate",		(PyCFunction)Canvas_invalidate,		METH_NOARGS,  "Draw the whole viewport on the next show()." },
+	{ "damage",			(PyCFunction)Canvas_damage,			METH_VARARGS, "Panel area drawn over since show(), restored by the next show()." },
+	{ "show",			(PyCFunction)Canvas_show,			METH_NOARGS,  "Draw the viewport into the frame, only what moved into view when possible." },
+
+	{ NULL, NULL, 0, NULL }
+};
+
+static PyGetSetDef Canvas_getset[] =
+{
+	{ const_cast<char *>("width"),	(getter)Canvas_getter, NULL, const_cast<char *>("Canvas width"), (void *)0 },
+	{ const_cast<char *>("height"),	(getter)Canvas_getter, NULL, const_cast<char *>("Canvas height"), (void *)1 },
+	{ const_cast<char *>("x"),		(getter)Canvas_getter, NULL, const_cast<char *>("Viewport origin x"), (void *)2 },
+	{ const_cast<char *>("y"),		(getter)Canvas_getter, NULL, const_cast<char *>("Viewport origin y"), (void *)3 },
+
+	{ NULL, 0, 0, 0, NULL }
+};
+
+static PyTypeObject tCanvasObjectType =
+{
+	PyObject_HEAD_INIT(NULL)
+	0,                              // ob_size (not used, always set to 0)
+	"ledmatrix.canvas",             // tp_name (module name, object name)
+	sizeof(tCanvasObject),          // tp_basicsize
+	0,                              // tp_itemsize
+	(destructor)Canvas_dealloc,     // tp_dealloc
+	0,                              // tp_print
+	0,                              // tp_getattr
+	0,                              // tp_setattr
+	0,                              // tp_compare
+	0,                              // tp_repr
+	0,                              // tp_as_number
+	0,                              // tp_as_sequence
+	0,                              // tp_as_mapping
+	0,                              // tp_hash
+	0,                              // tp_call
+	0,                              // tp_str
+	0,                              // tp_getattro
+	0,                              // tp_setattro
+	0,                              // tp_as_buffer
+	Py_TPFLAGS_DEFAULT,             // tp_flags
+	0,                              // tp_doc
+	0,                              // tp_traverse
+	0,                              // tp_clear
+	0,                              // tp_richcompare
+	0,                              // tp_weaklistoffset
+	0,                              // tp_iter
+	0,                              // tp_iternext
+	Canvas_methods,                 // tp_methods
+	0,                              // tp_members
+	Canvas_getset,                  // tp_getset
+	0,                              // tp_base
+	0,                              // tp_dict
+	0,                              // tp_descr_get
+	0,                              // tp_descr_set
+	0,                              // tp_dictoffset
+	(initproc)Canvas_init,          // tp_init
+	0,                              // tp_alloc
+	Canvas_new,                     // tp_new
+	0,                              // tp_free
+};
+
+
+
+//=============================================================================
+// Module functions, color tables and gradients
+//=============================================================================
+
+// palette by colorPalette id or a custom buffer of COLORTABLE_SIZE rgb24 byte triples
+static const rgb24* parseColorTable(PyObject *src, const char *name)
+{
+	const rgb24	*table;
+	const void	*data;
+	size_t		 size;
+
+
+	if(PyInt_Check(src))
+	{
+		if(!(table = colorTable((colorPalette)PyInt_AsLong(src))))
+			PyErr_Format(PyExc_ValueError, "%s: unknown palette", name);
+		return table;
+	}
+
+	if(!parseBuffer(data, size, src, name))
+		return NULL;
+
+	if(size < (COLORTABLE_SIZE * sizeof(rgb24)))
+	{
+		PyErr_Format(PyExc_ValueError, "%s: palette needs %d colors", name, COLORTABLE_SIZE);
+		return NULL;
+	}
+
+	return (const rgb24 *)data;
+}
+
+static PyObject *Module_colorWheel(PyObject *self, PyObject *args)
+{
+	int			pos;
+
+
+	if(!PyArg_ParseTuple(args, "i:colorWheel", &pos))
+		return NULL;
+
+	const rgb24 &color = colorTable(colorPalette::Wheel)[(uint8_t)pos];
+	return Py_BuildValue("[i,i,i]", color.red, color.green, color.blue);
+}
+
+static PyObject *Module_colorHSV(PyObject *self, PyObject *args)
+{
+	int			h, s, v;
+
+
+	if(!PyArg_ParseTuple(args, "iii:colorHSV", &h, &s, &v))
+		return NULL;
+
+	rgb24 color = colorHSV((uint8_t)h, (uint8_t)s, (uint8_t)v);
+	return Py_BuildValue("[i,i,i]", color.red, color.green, color.blue);
+}
+
+static PyObject *Module_colorTable(PyObject *self, PyObject *args)
+{
+	PyObject	*palette;
+	const rgb24	*table;
+
+
+	if(!PyArg_ParseTuple(args, "O:colorTable", &palette) ||
+		!(table = parseColorTable(palette, "colorTable")))
+		return NULL;
+
+	return PyByteArray_FromStringAndSize((const char *)table, COLORTABLE_SIZE * sizeof(rgb24));
+}
+
+static PyObject *Module_colorTableFromStops(PyObject *self, PyObject *args)
+{
+	PyObject	*stops;
+	const void	*data;
+	size_t		 size;
+	rgb24		 table[COLORTABLE_SIZE];
+
+
+	if(!PyArg_ParseTuple(args, "O:colorTableFromStops", &stops) ||
+		!parseBuffer(data, size, stops, "colorTableFromStops"))
+		return NULL;
+
+	colorTableFromStops(table, (const rgb24 *)data, size / sizeof(rgb24));
+	return PyByteArray_FromStringAndSize((const char *)table, sizeof(table));
+}
+
+static PyObject *Module_gradient(PyObject *self, PyObject *args)
+{
+	PyObject	*palette;
+	const rgb24	*table;
+	int			count;
+	int			start = 0;
+	int			step  = 256;
+	PyObject	*result;
+
+
+	if(!PyArg_ParseTuple(args, "Oi|ii:gradient", &palette, &count, &start, &step) ||
+		!(table = parseColorTable(palette, "gradient")))
+		return NULL;
+
+	if(count < 0)
+	{
+		PyErr_Format(PyExc_ValueError, "gradient: negative count");
+		return NULL;
+	}
+
+	if(!(result = PyByteArray_FromStringAndSize(NULL, count * sizeof(rgb24))))
+		return NULL;
+
+	gradientRow((rgb24 *)PyByteArray_AsString(result), count, table, (uint16_t)start, (int16_t)step);
+	return result;
+}
+
+static PyMethodDef Module_methods[] =
+{
+	{ "colorWheel",				(PyCFunction)Module_colorWheel,				METH_VARARGS, "Color wheel entry as [r, g, b]." },
+	{ "colorHSV",				(PyCFunction)Module_colorHSV,				METH_VARARGS, "Hue, saturation and value (0-255) to [r, g, b]." },
+	{ "colorTable",				(PyCFunction)Module_colorTable,				METH_VARARGS, "Palette's 256 colors as bytearray of rgb triples." },
+	{ "colorTableFromStops",	(PyCFunction)Module_colorTableFromStops,	METH_VARARGS, "256 colors interpolated between a buffer of rgb triples." },
+	{ "gradient",				(PyCFunction)Module_gradient,				METH_VARARGS, "count gradient colors as bytearray of rgb triples, 8.8 fixed point start and step." },
+
+	{ NULL, NULL, 0, NULL }
+};
+
+
+
 static bool PythonHook_Matrix()
 {
 	PyObject* m;
+	PyObject* canvas = (PyObject *)&tCanvasObjectType;	// through a PyObject pointer, keeps Py_INCREF clear of type punning
 
 
-	m = Py_InitModule("ledmatrix", NULL);
+	m = Py_InitModule("ledmatrix", Module_methods);
 	if(!m ||
 		(PyType_Ready(&tTextScrollerObjectType)	< 0) ||
-		(PyType_Ready(&tMatrixObjectType)		< 0))
+		(PyType_Ready(&tMatrixObjectType)		< 0) ||
+		(PyType_Ready(&tCanvasObjectType)		< 0))
 		return false;
 	
 	Py_INCREF(&tMatrixObjectType);
@@ -1075,6 +1994,9 @@ static bool PythonHook_Matrix()
 	Py_INCREF(&tTextScrollerObjectType);
 	PyModule_AddObject(m, "textscroller", (PyObject *)&tTextScrollerObjectType);
 
+	Py_INCREF(canvas);
+	PyModule_AddObject(m, "canvas", canvas);
+
 
 	// fonts
 	PyModule_AddIntConstant(m, "FONT_font3x5",		font3x5);
@@ -1084,6 +2006,21 @@ static bool PythonHook_Matrix()
 	PyModule_AddIntConstant(m, "FONT_gohufont11",	gohufont11);
 	PyModule_AddIntConstant(m, "FONT_gohufont11b",	gohufont11b);
 
+	// color palettes
+	PyModule_AddIntConstant(m, "PALETTE_Wheel",		(int)colorPalette::Wheel);
+	PyModule_AddIntConstant(m, "PALETTE_Hue",		(int)colorPalette::Hue);
+	PyModule_AddIntConstant(m, "PALETTE_Heat",		(int)colorPalette::Heat);
+	PyModule_AddIntConstant(m, "PALETTE_Ocean",		(int)colorPalette::Ocean);
+	PyModule_AddIntConstant(m, "PALETTE_Lava",		(int)colorPalette::Lava);
+	PyModule_AddIntConstant(m, "PALETTE_Forest",	(int)colorPalette::Forest);
+	PyModule_AddIntConstant(m, "PALETTE_Gray",		(int)colorPalette::Gray);
+
+	// image fit
+	PyModule_AddIntConstant(m, "IMAGE_Stretch",		(int)imageFit::Stretch);
+	PyModule_AddIntConstant(m, "IMAGE_Contain",		(int)imageFit::Contain);
+	PyModule_AddIntConstant(m, "IMAGE_Cover",		(int)imageFit::Cover);
+	PyModule_AddIntConstant(m, "IMAGE_None",		(int)imageFit::None);
+
 	// scroll mode
 	PyModule_AddIntConstant(m, "SCROLL_wrapForward",			wrapForward);
 	PyModule_AddIntConstant(m, "SCROLL_bounceForward",			bounceForward);
@@ -1100,6 +2037,13 @@ static bool PythonHook_Matrix()
 	PyModule_AddIntConstant(m, "DISPLAY_Timer",			DisplayState_Timer);
 	PyModule_AddIntConstant(m, "DISPLAY_Messages",		DisplayState_Messages);
 	PyModule_AddIntConstant(m, "DISPLAY_Manual",		DisplayState_Manual);
+
+	// frame encodings
+	PyModule_AddIntConstant(m, "ENCODING_None",			(int)FrameEncoding::None);
+	PyModule_AddIntConstant(m, "ENCODING_DrawList",		(int)FrameEncoding::DrawList);
+	PyModule_AddIntConstant(m, "ENCODING_Regions",		(int)FrameEncoding::Regions);
+	PyModule_AddIntConstant(m, "ENCODING_Delta",		(int)FrameEncoding::Delta);
+	PyModule_AddIntConstant(m, "ENCODING_Full",			(int)FrameEncoding::Full);
 	
 	return true;
 }
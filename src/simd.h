@@ -0,0 +1,82 @@
+#ifndef XPM_SIMD_H_
+#define XPM_SIMD_H_
+
+/*
+ * Small vector helpers shared by the frame encoders, NEON on the ARM boards
+ * and SSE2 on x86 hosts with a plain scalar fallback.
+ */
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define XPM_SIMD_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define XPM_SIMD_SSE2
+#endif
+
+
+/**
+ * Compare two byte buffers for equality, 16 bytes at a time.
+ */
+static inline bool simdEqual(const uint8_t *a, const uint8_t *b, size_t size)
+{
+	size_t i = 0;
+
+#if defined(XPM_SIMD_NEON)
+	for(; (i + 16) <= size; i += 16)
+	{
+		uint8x16_t diff = veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+		uint32x2_t fold = vreinterpret_u32_u8(vorr_u8(vget_low_u8(diff), vget_high_u8(diff)));
+		if(vget_lane_u32(fold, 0) | vget_lane_u32(fold, 1))
+			return false;
+	}
+#elif defined(XPM_SIMD_SSE2)
+	for(; (i + 16) <= size; i += 16)
+	{
+		__m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF)
+			return false;
+	}
+#endif
+
+	return !memcmp(a + i, b + i, size - i);
+}
+
+/**
+ * Number of equal leading bytes of two buffers, 16 bytes at a time.
+ */
+static inline size_t simdMatchLength(const uint8_t *a, const uint8_t *b, size_t max)
+{
+	size_t i = 0;
+
+#if defined(XPM_SIMD_NEON)
+	for(; (i + 16) <= max; i += 16)
+	{
+		uint8x16_t diff = veorq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+		uint64_t   lo   = vgetq_lane_u64(vreinterpretq_u64_u8(diff), 0);
+		uint64_t   hi   = vgetq_lane_u64(vreinterpretq_u64_u8(diff), 1);
+
+		if(lo)
+			return i + (__builtin_ctzll(lo) / 8);
+		if(hi)
+			return i + 8 + (__builtin_ctzll(hi) / 8);
+	}
+#elif defined(XPM_SIMD_SSE2)
+	for(; (i + 16) <= max; i += 16)
+	{
+		__m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+		int     eq = _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+
+		if(eq != 0xFFFF)
+			return i + __builtin_ctz(~eq);
+	}
+#endif
+
+	for(; (i < max) && (a[i] == b[i]); i++);
+	return i;
+}
+
+
+#endif // XPM_SIMD_H_
@@ -0,0 +1,192 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "sprite.h"
+
+
+/**
+ * Draw a bitmap as batched spans, one per run of set bits or equal pixels.
+ *
+ * @param color			Mono set bits color, else the key color skipped when transparent.
+ * @return	false on device error.
+ */
+bool blitSpans(int16_t x, int16_t y, uint8_t width, uint8_t height, rpcBitmapFormat format, const uint8_t *data,
+			   const rgb24 &color, bool transparent)
+{
+	struct
+	{
+		int16_t  x0, x1, y;
+		rgb24    color;
+	} PACKED p;
+
+	const bool		batch  = rpc.batching();
+	const bool		mono   = (format == rpcBitmapFormat::Mono);
+	const size_t	pitch  = mono? ((width + 7) / 8) : (width * sizeof(rgb24));
+	bool			result = true;
+
+	if(!batch)
+		rpc.batchBegin();
+
+	for(int r=0; result && (r<height); r++, data += pitch)
+	{
+		const rgb24 *rgb = (const rgb24 *)data;
+
+		for(int c=0; result && (c<width);)
+		{
+			const int start = c;
+
+			if(mono)
+			{
+				while((c < width) && (data[c / 8] & (0x80 >> (c % 8))))
+					c++;
+				p.color = color;
+			} else
+			{
+				while((c < width) && (rgb[c] == rgb[start]))
+					c++;
+				p.color = rgb[start];
+			}
+
+			// clear bits or key colored pixels
+			if(c == start)
+			{
+				c++;
+				continue;
+			}
+			if(!mono && transparent && (p.color == color))
+				continue;
+
+			p.x0   = x + start;
+			p.x1   = x + c -1;
+			p.y    = y + r;
+			result = rpc.send(rpcType::Drawing, rpcDrawing::DrawFastHLine, &p, sizeof(p));
+		}
+	}
+
+	if(!batch)
+		rpc.batchEnd();
+
+	return result;
+}
+
+
+
+//=============================================================================
+// Sprite class
+//=============================================================================
+Sprite::Sprite()
+:	mData(sizeof(tRPCBitmap), 0),
+	mHandle(0)
+{
+}
+Sprite::~Sprite()
+{
+	release();
+}
+
+bool Sprite::assign(uint8_t width, uint8_t height, const uint8_t *bits)
+{
+	const size_t	size   = (size_t)((width + 7) / 8) * height;
+	tRPCBitmap		bitmap = { (uint8_t)rpcBitmapFormat::Mono, width, height };
+
+
+	if((sizeof(bitmap) + size) > RPCSPR_MAXSIZE)
+		return false;
+
+	release();
+	mData.assign((const uint8_t *)&bitmap, (const uint8_t *)&bitmap + sizeof(bitmap));
+	mData.insert(mData.end(), bits, bits + size);
+	return true;
+}
+
+bool Sprite::assign(uint8_t width, uint8_t height, const rgb24 *pixels)
+{
+	const size_t	size   = (size_t)width * height * sizeof(rgb24);
+	tRPCBitmap		bitmap = { (uint8_t)rpcBitmapFormat::RGB24, width, height };
+
+
+	if((sizeof(bitmap) + size) > RPCSPR_MAXSIZE)
+		return false;
+
+	release();
+	mData.assign((const uint8_t *)&bitmap, (const uint8_t *)&bitmap + sizeof(bitmap));
+	mData.insert(mData.end(), (const uint8_t *)pixels, (const uint8_t *)pixels + size);
+	return true;
+}
+
+bool Sprite::upload(uint8_t handle)
+{
+	tRPCSprite p;
+
+
+	release();
+
+	if(!rpc.hasCapability(RPCCAP_SPRITES) || !handle || (handle > RPCSPR_HANDLES) || !width() || !height())
+		return false;
+
+	memset(&p, 0, sizeof(p));
+	p.op     = (uint8_t)rpcSpriteOp::Store;
+	p.handle = handle;
+	p.slot   = DRAWSTRING_SLOT;
+
+	// sprite data through the transfer slot, one slot worth at a time
+	for(size_t offset = 0, chunk; offset < mData.size(); offset += chunk)
+	{
+		chunk = std::min<size_t>(mData.size() - offset, gm_IOBuffers[DRAWSTRING_SLOT].size);
+
+		if(!rpc.transfer(DRAWSTRING_SLOT, &mData[offset], chunk) ||
+			!rpc.send(rpcType::Drawing, rpcDrawing::Sprite, &p, sizeof(p)))
+			return false;
+
+		p.op = (uint8_t)rpcSpriteOp::Append;
+	}
+
+	mHandle = handle;
+	return true;
+}
+
+void Sprite::release()
+{
+	if(!mHandle)
+		return;
+
+	tRPCSprite p;
+
+	memset(&p, 0, sizeof(p));
+	p.op     = (uint8_t)rpcSpriteOp::Free;
+	p.handle = mHandle;
+	rpc.send(rpcType::Drawing, rpcDrawing::Sprite, &p, sizeof(p));
+
+	mHandle = 0;
+}
+
+bool Sprite::blit(int16_t x, int16_t y, const rgb24 &color, bool transparent) const
+{
+	if(mHandle)
+	{
+		tRPCSprite p;
+
+		memset(&p, 0, sizeof(p));
+		p.op       = (uint8_t)rpcSpriteOp::Blit;
+		p.handle   = mHandle;
+		p.x        = x;
+		p.y        = y;
+		p.flags    = transparent? RPCSPR_FLAG_KEY : 0;
+		p.color[0] = color.red;
+		p.color[1] = color.green;
+		p.color[2] = color.blue;
+		return rpc.send(rpcType::Drawing, rpcDrawing::Sprite, &p, sizeof(p));
+	}
+
+	// not stored on the panel
+	return blitSpans(x, y, width(), height(), format(), data(), color, transparent);
+}
+
+void Sprite::draw(FrameBuffer &dest, int16_t x, int16_t y, const rgb24 &color, bool transparent) const
+{
+	if(format() == rpcBitmapFormat::Mono)
+		dest.drawMonoBitmap(x, y, width(), height(), color, data());
+	else
+		dest.drawBitmap(x, y, width(), height(), (const rgb24 *)data(), transparent? &color : NULL);
+}
@@ -0,0 +1,47 @@
+#ifndef XPM_SPRITE_H_
+#define XPM_SPRITE_H_
+
+
+// Mono or rgb24 bitmap blitted by handle, stored on the display panel when supported
+class Sprite
+{
+private:
+	std::vector<uint8_t>	mData;			// tRPCBitmap followed by pixel data
+	uint8_t					mHandle;		// panel side handle, 0 when drawn from the host
+
+
+	const tRPCBitmap& header() const				{ return *(const tRPCBitmap *)mData.data(); }
+
+
+public:
+	Sprite();
+	~Sprite();
+
+	// mono rows of (width +7) / 8 bytes, most significant bit leftmost, false when too large
+	bool assign(uint8_t width, uint8_t height, const uint8_t *bits);
+	bool assign(uint8_t width, uint8_t height, const rgb24 *pixels);
+
+	rpcBitmapFormat format() const					{ return (rpcBitmapFormat)header().format; }
+	uint8_t width() const							{ return header().width; }
+	uint8_t height() const							{ return header().height; }
+	const uint8_t* data() const						{ return &mData[sizeof(tRPCBitmap)]; }
+	bool stored() const								{ return mHandle != 0; }
+
+	// store the bitmap on the panel, false if it has to be drawn from the host
+	bool upload(uint8_t handle);
+	void release();
+
+	// draw at a position, mono sprites draw set bits in color, rgb24 sprites skip pixels
+	// equal to color when transparent, by handle when stored on the panel, else as spans
+	bool blit(int16_t x, int16_t y, const rgb24 &color, bool transparent) const;
+	// same into a host framebuffer
+	void draw(FrameBuffer &dest, int16_t x, int16_t y, const rgb24 &color, bool transparent) const;
+};
+
+
+// draw a bitmap as batched spans, mono rows or rgb24 pixels as in tRPCBitmap
+extern bool blitSpans(int16_t x, int16_t y, uint8_t width, uint8_t height, rpcBitmapFormat format, const uint8_t *data,
+					  const rgb24 &color, bool transparent);
+
+
+#endif // XPM_SPRITE_H_
@@ -0,0 +1,189 @@
+#include <xpmcommon.h>
+#include "threadpool.h"
+
+
+//=============================================================================
+// Work stealing thread pool class
+//=============================================================================
+ThreadPool::ThreadPool()
+:	mTask(NULL),
+	mArg(NULL),
+	mRemaining(0),
+	mGeneration(0),
+	mStop(false),
+	steals(0)
+{
+}
+ThreadPool::~ThreadPool()
+{
+	stop();
+}
+
+/**
+ * Spawn the worker threads. They sleep until parallelFor() hands out work
+ * and stay around for the next loop, so loops don't pay thread creation.
+ *
+ * @param threads	Threads running a loop including the caller, 0 for one per CPU core.
+ * @return	false if already started.
+ */
+bool ThreadPool::start(size_t threads)
+{
+	if(!mWorkers.empty())
+		return false;
+
+	if(!threads)
+		threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+	threads = std::min<size_t>(threads, THREADPOOL_THREADS_MAX);
+
+	mStop = false;
+	steals = 0;
+	for(size_t i=1; i<threads; i++)
+		mWorkers.push_back(std::thread(&ThreadPool::run, this, i));
+
+	return true;
+}
+
+void ThreadPool::stop()
+{
+	if(mWorkers.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mWake.notify_all();
+
+	for(size_t i=0; i<mWorkers.size(); i++)
+		mWorkers[i].join();
+	mWorkers.clear();
+}
+
+/**
+ * Run a task for every index below count. Each thread's queue gets a
+ * contiguous run of indices, in order, so neighbouring indices, e.g. tiles,
+ * stay on one core. Threads that finish early steal from the end of the
+ * others' runs. Returns once every index has been run, only one loop runs at
+ * a time.
+ *
+ * @param count	Indices to run.
+ * @param task	Called once per index, from any of the threads.
+ * @param arg	Passed to task.
+ */
+void ThreadPool::parallelFor(size_t count, tTask task, void *arg)
+{
+	const size_t n = threads();
+
+
+	if(!count)
+		return;
+
+	// nothing to share
+	if((n == 1) || (count == 1))
+	{
+		for(size_t i=0; i<count; i++)
+			task(arg, i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		mTask      = task;
+		mArg       = arg;
+		mRemaining = count;
+		for(size_t q=0; q<n; q++)
+		{
+			std::lock_guard<std::mutex> queueLock(mQueues[q].lock);
+
+			for(size_t i=(q * count) / n; i<((q +1) * count) / n; i++)
+				mQueues[q].items.push_back(i);
+		}
+		mGeneration++;
+	}
+	mWake.notify_all();
+
+	// the caller works on queue 0 and then waits for the stragglers
+	const size_t done = work(0);
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	mRemaining -= done;
+	mDone.wait(lock, [this] { return !mRemaining; });
+}
+
+void ThreadPool::run(size_t queue)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	size_t generation = mGeneration;
+
+
+	for(;;)
+	{
+		mWake.wait(lock, [this, &generation] { return mStop || (mGeneration != generation); });
+		if(mStop)
+			break;
+		generation = mGeneration;
+
+		lock.unlock();
+		const size_t done = work(queue);
+		lock.lock();
+
+		// a late wake finds the queues empty and did nothing
+		if(done && !(mRemaining -= done))
+			mDone.notify_one();
+	}
+}
+
+// run indices until all queues are empty, returns how many
+size_t ThreadPool::work(size_t queue)
+{
+	size_t	done = 0, stolen = 0, index;
+	bool	own;
+
+
+	while(take(queue, index, own))
+	{
+		mTask(mArg, index);
+		done++;
+		if(!own)
+			stolen++;
+	}
+
+	if(stolen)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		steals += stolen;
+	}
+
+	return done;
+}
+
+// next index of the own queue, else one from the back of another's, false once all are empty
+bool ThreadPool::take(size_t queue, size_t &index, bool &own)
+{
+	const size_t n = threads();
+
+
+	for(size_t i=0; i<n; i++)
+	{
+		tQueue &q = mQueues[(queue + i) % n];
+		std::lock_guard<std::mutex> lock(q.lock);
+
+		if(q.items.empty())
+			continue;
+
+		own = !i;
+		if(own)
+		{
+			index = q.items.front();
+			q.items.pop_front();
+		} else
+		{
+			index = q.items.back();
+			q.items.pop_back();
+		}
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,58 @@
+#ifndef XPM_THREADPOOL_H_
+#define XPM_THREADPOOL_H_
+
+
+#define THREADPOOL_THREADS_MAX	16		// workers including the calling thread
+
+
+// Parallel for loops on persistent worker threads, each worker owns a deque of indices and steals
+// from the others once its own runs dry
+class ThreadPool
+{
+public:
+	typedef void (*tTask)(void *arg, size_t index);
+
+
+private:
+	struct tQueue
+	{
+		std::mutex			lock;
+		std::deque<size_t>	items;		// owner takes from the front, thieves from the back
+	};
+
+	tQueue					mQueues[THREADPOOL_THREADS_MAX];	// [0] is the calling thread's
+	std::vector<std::thread> mWorkers;
+	std::mutex				mMutex;
+	std::condition_variable	mWake;		// workers, new loop or stopping
+	std::condition_variable	mDone;		// caller, last index finished
+	tTask					mTask;
+	void					*mArg;
+	size_t					mRemaining;	// indices of the current loop not yet finished
+	size_t					mGeneration;	// loops started, wakes workers once per loop
+	bool					mStop;
+
+
+	void run(size_t queue);
+	size_t work(size_t queue);
+	bool take(size_t queue, size_t &index, bool &own);
+
+
+public:
+	size_t					steals;		// indices run by another worker than their owner
+
+
+	ThreadPool();
+	~ThreadPool();
+
+	// spawn threads -1 workers, the caller of parallelFor() is the last one, 0 for one per CPU core
+	bool start(size_t threads = 0);
+	void stop();
+	size_t threads() const							{ return mWorkers.size() +1; }
+
+	// run task(arg, index) for every index below count and return once all are done, indices are
+	// handed out in contiguous runs per thread, runs inline while stopped
+	void parallelFor(size_t count, tTask task, void *arg);
+};
+
+
+#endif // XPM_THREADPOOL_H_
@@ -0,0 +1,91 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "threadpool.h"
+#include "tilerender.h"
+
+
+//=============================================================================
+// Tiled framebuffer renderer class
+//=============================================================================
+TileRenderer::TileRenderer()
+:	mTileWidth(TILERENDER_TILE_WIDTH),
+	mTileHeight(TILERENDER_TILE_HEIGHT)
+{
+	memset(&mJob, 0, sizeof(mJob));
+}
+TileRenderer::~TileRenderer()
+{
+	stop();
+}
+
+void TileRenderer::setTileSize(int16_t width, int16_t height)
+{
+	mTileWidth  = std::max<int16_t>(0, width);
+	mTileHeight = std::max<int16_t>(1, height);
+}
+
+void TileRenderer::render(FrameBuffer &dest, tSpanShader shader, void *user)
+{
+	mJob.span  = shader;
+	mJob.pixel = NULL;
+	mJob.user  = user;
+	render(dest);
+}
+
+void TileRenderer::render(FrameBuffer &dest, tPixelShader shader, void *user)
+{
+	mJob.span  = NULL;
+	mJob.pixel = shader;
+	mJob.user  = user;
+	render(dest);
+}
+
+/**
+ * Split the framebuffer into tiles, numbered row by row, and shade them on
+ * the pool. Tiles of one row are consecutive indices, so each thread starts
+ * on a contiguous band of the frame.
+ *
+ * @param dest	Framebuffer to shade completely.
+ */
+void TileRenderer::render(FrameBuffer &dest)
+{
+	if(!dest.width() || !dest.height())
+		return;
+
+	const int16_t width = mTileWidth? std::min(mTileWidth, dest.width()) : dest.width();
+	const size_t  rows  = (dest.height() + mTileHeight -1) / mTileHeight;
+
+	mJob.dest    = &dest;
+	mJob.columns = (dest.width() + width -1) / width;
+	mPool.parallelFor(rows * mJob.columns, renderTile, this);
+	mJob.dest    = NULL;
+}
+
+void TileRenderer::renderTile(void *arg, size_t index)
+{
+	TileRenderer	*self = (TileRenderer *)arg;
+	FrameBuffer		&dest = *self->mJob.dest;
+
+
+	const int16_t width = self->mTileWidth? std::min(self->mTileWidth, dest.width()) : dest.width();
+	const int16_t x0    = (int16_t)(index % self->mJob.columns) * width;
+	const int16_t y0    = (int16_t)(index / self->mJob.columns) * self->mTileHeight;
+	const int16_t count = std::min<int16_t>(width, dest.width() - x0);
+	const int16_t y1    = std::min<int16_t>(y0 + self->mTileHeight, dest.height());
+
+	for(int16_t y=y0; y<y1; y++)
+	{
+		rgb24 *row = dest.row(y) + x0;
+
+		if(self->mJob.span)
+		{
+			self->mJob.span(row, x0, y, count, self->mJob.user);
+			continue;
+		}
+
+		for(int16_t x=0; x<count; x++)
+			row[x] = self->mJob.pixel(x0 + x, y, self->mJob.user);
+	}
+}
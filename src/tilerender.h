@@ -0,0 +1,55 @@
+#ifndef XPM_TILERENDER_H_
+#define XPM_TILERENDER_H_
+
+
+#define TILERENDER_TILE_WIDTH	32		// default tile size in pixels
+#define TILERENDER_TILE_HEIGHT	8
+
+
+// Shaders, called concurrently for different tiles and must only depend on their arguments
+// count pixels of row y from x on
+typedef void  (*tSpanShader)(rgb24 *dest, int16_t x, int16_t y, int16_t count, void *user);
+typedef rgb24 (*tPixelShader)(int16_t x, int16_t y, void *user);
+
+
+// Renders host framebuffers tile by tile on a thread pool, each pixel is written by exactly one
+// shader call so the result doesn't depend on scheduling
+class TileRenderer
+{
+private:
+	ThreadPool				mPool;
+	int16_t					mTileWidth;		// 0 for full width scanline bands
+	int16_t					mTileHeight;
+	struct
+	{
+		FrameBuffer			*dest;
+		tSpanShader			span;
+		tPixelShader		pixel;
+		void				*user;
+		int16_t				columns;		// tiles per row of tiles
+	}						mJob;
+
+
+	static void renderTile(void *arg, size_t index);
+	void render(FrameBuffer &dest);
+
+
+public:
+	TileRenderer();
+	~TileRenderer();
+
+	// threads including the caller, 0 for one per CPU core, renders on the caller alone until started
+	bool start(size_t threads = 0)					{ return mPool.start(threads); }
+	void stop()										{ mPool.stop(); }
+	const ThreadPool& pool() const					{ return mPool; }
+
+	// width 0 splits into bands of height scanlines
+	void setTileSize(int16_t width, int16_t height);
+
+	// shade every pixel of dest, returns once all tiles are done, e.g. before the frame gets encoded
+	void render(FrameBuffer &dest, tSpanShader shader, void *user);
+	void render(FrameBuffer &dest, tPixelShader shader, void *user);
+};
+
+
+#endif // XPM_TILERENDER_H_
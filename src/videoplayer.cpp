@@ -0,0 +1,406 @@
+#include <xpmcommon.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "framepalette.h"
+#include "framestream.h"
+#include "framescheduler.h"
+#include "colorpipeline.h"
+#include "videoplayer.h"
+
+
+#define VIDEOPLAYER_POLL			5		// msec, device polling slice while waiting for a swap
+#define VIDEOPLAYER_SWAP_TIMEOUT	1000	// msec, give up waiting for a swap the panel never reports
+
+
+//-----------------------------------------------------------------------------
+// YUV to rgb24, BT.601 studio range as y4m files usually are
+//-----------------------------------------------------------------------------
+static inline uint8_t clamp8(int v)
+{
+	return (v < 0)? 0 : ((v > 255)? 255 : v);
+}
+
+static void yuvToRGB(rgb24 *dest, const uint8_t *y, const uint8_t *u, const uint8_t *v, size_t count, int shift)
+{
+	for(size_t i=0; i<count; i++)
+	{
+		const int c = (y[i] - 16) * 298;
+		const int d = (u? u[i >> shift] : 128) - 128;
+		const int e = (v? v[i >> shift] : 128) - 128;
+
+		dest[i] = rgb24(clamp8((c + (409 * e) + 128) >> 8),
+						clamp8((c - (100 * d) - (208 * e) + 128) >> 8),
+						clamp8((c + (516 * d) + 128) >> 8));
+	}
+}
+
+
+
+//=============================================================================
+// Memory mapped video player class
+//=============================================================================
+VideoPlayer::VideoPlayer()
+:	mMap(NULL),
+	mMapSize(0),
+	mFormat(videoFormat::Raw),
+	mWidth(0),
+	mHeight(0),
+	mRate(VIDEOPLAYER_RATE),
+	mChroma(0),
+	mFrameSize(0),
+	mPosition(0),
+	mStop(false),
+	played(0),
+	dropped(0)
+{
+}
+VideoPlayer::~VideoPlayer()
+{
+	close();
+}
+
+/**
+ * Map a frame file and index its frames. Raw files are told apart from y4m
+ * ones by the YUV4MPEG2 signature, their trailing partial frame is ignored.
+ *
+ * @param path		Frame file.
+ * @param width		Raw frame width, 0 for the panel width.
+ * @param height	Raw frame height, 0 for the panel height.
+ * @param fps		Frame rate, 0 for the y4m header's or VIDEOPLAYER_RATE.
+ * @return	false if the file can't be mapped or holds no frames.
+ */
+bool VideoPlayer::open(const char *path, int16_t width, int16_t height, double fps)
+{
+	struct stat st;
+
+
+	close();
+
+	const int fd = ::open(path, O_RDONLY);
+	if(fd < 0)
+	{
+		printf("%s error: can't open video '%s'\n", __METHOD_NAME_C__, path);
+		return false;
+	}
+
+	if((fstat(fd, &st) != 0) || !st.st_size)
+	{
+		::close(fd);
+		return false;
+	}
+
+	void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(map == MAP_FAILED)
+		return false;
+
+	// mostly read front to back, the reader thread asks for what comes next explicitly
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+	mMap     = (const uint8_t *)map;
+	mMapSize = st.st_size;
+	mRate    = VIDEOPLAYER_RATE;
+
+	if((mMapSize > 10) && !memcmp(mMap, "YUV4MPEG2 ", 10))
+	{
+		mFormat = videoFormat::Y4M;
+		if(!parseY4M())
+		{
+			printf("%s error: unsupported y4m file '%s'\n", __METHOD_NAME_C__, path);
+			close();
+			return false;
+		}
+	} else
+	{
+		mFormat    = videoFormat::Raw;
+		mWidth     = width?  width  : matrix.width;
+		mHeight    = height? height : matrix.height;
+		mFrameSize = (size_t)mWidth * mHeight * sizeof(rgb24);
+
+		for(size_t offset = 0; mFrameSize && ((offset + mFrameSize) <= mMapSize); offset += mFrameSize)
+			mFrames.push_back(offset);
+	}
+
+	if(fps > 0)
+		mRate = fps;
+
+	if(mFrames.empty())
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void VideoPlayer::close()
+{
+	if(mMap)
+		munmap((void *)mMap, mMapSize);
+
+	mMap       = NULL;
+	mMapSize   = 0;
+	mWidth     = 0;
+	mHeight    = 0;
+	mFrameSize = 0;
+	mFrames.clear();
+}
+
+// header tags and frame offsets of a YUV4MPEG2 file
+bool VideoPlayer::parseY4M()
+{
+	const uint8_t	*end = mMap + mMapSize;
+	const uint8_t	*p   = mMap + 10;
+	const uint8_t	*eol = (const uint8_t *)memchr(p, '\n', end - p);
+	char			 tag[32];
+	int				 width  = 0;
+	int				 height = 0;
+
+
+	if(!eol)
+		return false;
+
+	mChroma = 420;
+	while(p < eol)
+	{
+		const uint8_t *next = p;
+
+		while((next < eol) && (*next != ' '))
+			next++;
+
+		const size_t length = std::min<size_t>(next - p, sizeof(tag) -1);
+		memcpy(tag, p, length);
+		tag[length] = '\0';
+		p = next +1;
+
+		switch(tag[0])
+		{
+			case 'W':	width  = atoi(tag +1);		break;
+			case 'H':	height = atoi(tag +1);		break;
+
+			case 'F':
+			{
+				unsigned int num = 0, den = 0;
+				if((sscanf(tag +1, "%u:%u", &num, &den) == 2) && num && den)
+					mRate = (double)num / den;
+				break;
+			}
+
+			case 'C':
+			{
+				if(!strcmp(tag, "C444"))
+					mChroma = 444;
+				else if(!strcmp(tag, "Cmono"))
+					mChroma = 0;
+				else if(!strncmp(tag, "C420", 4))
+					mChroma = 420;
+				else
+					return false;
+				break;
+			}
+		}
+	}
+
+	if((width <= 0) || (height <= 0) || (width > INT16_MAX) || (height > INT16_MAX))
+		return false;
+
+	mWidth  = width;
+	mHeight = height;
+
+	const size_t luma   = (size_t)mWidth * mHeight;
+	const size_t chroma = (mChroma == 444)? luma : ((mChroma == 420)? (size_t)((mWidth +1) / 2) * ((mHeight +1) / 2) : 0);
+	mFrameSize = luma + (2 * chroma);
+
+	// FRAME lines may carry parameters of their own
+	for(p = eol +1; ((end - p) > 5) && !memcmp(p, "FRAME", 5); p += mFrameSize)
+	{
+		if(!(eol = (const uint8_t *)memchr(p, '\n', end - p)) || ((size_t)(end - (eol +1)) < mFrameSize))
+			break;
+
+		p = eol +1;
+		mFrames.push_back(p - mMap);
+	}
+
+	return true;
+}
+
+bool VideoPlayer::frame(size_t index, FrameBuffer &dest) const
+{
+	if(index >= mFrames.size())
+		return false;
+
+	const uint8_t *data = mMap + mFrames[index];
+
+	if((dest.width() != mWidth) || (dest.height() != mHeight))
+		dest.resize(mWidth, mHeight);
+
+	if(mFormat == videoFormat::Raw)
+	{
+		memcpy((uint8_t *)dest.pixels(), data, mFrameSize);
+		return true;
+	}
+
+	// planar y, u, v, chroma rows of 4:2:0 cover two luma rows
+	const size_t	 luma   = (size_t)mWidth * mHeight;
+	const int		 shift  = (mChroma == 420)? 1 : 0;
+	const size_t	 pitch  = (mChroma == 420)? ((mWidth +1) / 2) : mWidth;
+	const size_t	 chroma = pitch * ((mChroma == 420)? ((mHeight +1) / 2) : mHeight);
+
+	for(int16_t y=0; y<mHeight; y++)
+	{
+		const uint8_t *u = mChroma? (data + luma + ((y >> shift) * pitch)) : NULL;
+		const uint8_t *v = mChroma? (u + chroma) : NULL;
+
+		yuvToRGB(dest.row(y), data + ((size_t)y * mWidth), u, v, mWidth, shift);
+	}
+
+	return true;
+}
+
+// fault in a frame's pages
+void VideoPlayer::touch(size_t index) const
+{
+	static const size_t	page  = sysconf(_SC_PAGESIZE);
+	const size_t		start = mFrames[index] & ~(page -1);
+	const size_t		end   = mFrames[index] + mFrameSize;
+	volatile uint8_t	sink  = 0;
+
+
+	madvise((void *)(mMap + start), end - start, MADV_WILLNEED);
+
+	// readahead is only a hint, reading a byte per page makes sure they're in
+	for(size_t offset = start; offset < end; offset += page)
+		sink = sink + mMap[std::max(offset, mFrames[index])];
+}
+
+// reader thread, stays up to VIDEOPLAYER_PREFETCH frames ahead of playback
+void VideoPlayer::read()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	size_t next = 0;
+
+
+	while(!mStop)
+	{
+		// frames dropped meanwhile aren't worth reading any more
+		next = std::max(next, mPosition);
+		if(next >= (mPosition + VIDEOPLAYER_PREFETCH))
+		{
+			mWake.wait(lock);
+			continue;
+		}
+
+		const size_t index = next++ % mFrames.size();
+		lock.unlock();
+		touch(index);
+		lock.lock();
+	}
+}
+
+bool VideoPlayer::send(size_t index)
+{
+	const ColorPipeline *pipeline = mStream.colorPipeline();
+
+
+	// the mapped frame is the wire frame as is
+	if((mFormat == videoFormat::Raw) && (mWidth == matrix.width) && (mHeight == matrix.height) &&
+		(mStream.format() == rpcFrameFormat::RGB888) && (!pipeline || pipeline->identity()))
+	{
+		const uint8_t *data = mMap + mFrames[index];
+
+		if(rpc.hasCapability(RPCCAP_FB_SEGMENTS))
+			return mStream.sendDelta(data, mFrameSize, mWidth * sizeof(rgb24));
+		return mStream.sendFull(data, mFrameSize);
+	}
+
+	if((mWidth == matrix.width) && (mHeight == matrix.height))
+	{
+		frame(index, mFrame);
+		return mStream.send(mFrame);
+	}
+
+	// other sizes centered on black
+	frame(index, mDecoded);
+	mFrame.resize(matrix.width, matrix.height);
+	mFrame.drawImage((matrix.width - mWidth) / 2, (matrix.height - mHeight) / 2, mDecoded);
+	return mStream.send(mFrame);
+}
+
+/**
+ * Stream frames at the file's rate. Each frame waits for its slot, slots
+ * that passed while the previous frame was still being sent are skipped so
+ * playback keeps its speed when USB falls behind.
+ *
+ * @param loops	Times to play the file, 0 until gm_Exit.
+ * @return	false on device error.
+ */
+bool VideoPlayer::play(size_t loops)
+{
+	const FrameScheduler	*scheduler = matrix.getScheduler();
+	const double			 previous  = scheduler? scheduler->getRate() : 0;
+	const size_t			 total     = loops? (loops * mFrames.size()) : SIZE_MAX;
+	size_t					 position  = 0;
+	size_t					 swaps     = matrix.bufferswaps;
+	bool					 result    = true;
+
+
+	if(!mMap)
+		return false;
+
+	played   = 0;
+	dropped  = 0;
+	mStop    = false;
+	mPosition = 0;
+	mStream.reset();
+	mReader = std::thread(&VideoPlayer::read, this);
+	matrix.setFrameRate(mRate);
+
+	while(result && rpc.ok() && !gm_Exit)
+	{
+		const size_t slots = matrix.waitFrame();
+		if(!slots)
+			break;
+
+		// the first frame starts the schedule
+		if(played)
+		{
+			position += slots;
+			dropped  += slots -1;
+		}
+		if(position >= total)
+			break;
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mPosition = position;
+		}
+		mWake.notify_one();
+
+		// the next frame goes into the drawing buffer, the panel has to swap the previous one in first
+		for(int64_t start = clock_getnstime(CLOCK_MONOTONIC); played && rpc.ok() && !gm_Exit && (swaps == matrix.bufferswaps);)
+		{
+			rpc.poll(VIDEOPLAYER_POLL);
+			if((clock_getnstime(CLOCK_MONOTONIC) - start) > (VIDEOPLAYER_SWAP_TIMEOUT * 1000000LL))
+				break;
+		}
+
+		swaps  = matrix.bufferswaps;
+		result = send(position % mFrames.size());
+		played++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mWake.notify_one();
+	mReader.join();
+
+	matrix.setFrameRate(previous);
+	return result;
+}
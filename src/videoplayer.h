@@ -0,0 +1,81 @@
+#ifndef XPM_VIDEOPLAYER_H_
+#define XPM_VIDEOPLAYER_H_
+
+
+#define VIDEOPLAYER_PREFETCH	8		// frames the reader thread keeps resident ahead of playback
+#define VIDEOPLAYER_RATE		30.0	// frames per second of raw files when not given
+
+
+// Frame file layouts
+enum class videoFormat
+{
+	Raw = 0,		// headerless rgb24 frames back to back, ffmpeg -f rawvideo -pix_fmt rgb24
+	Y4M,			// YUV4MPEG2 with 4:2:0, 4:4:4 or mono frames, converted to rgb24 while playing
+};
+
+
+// Plays frame files from a read only mapping, paced at the file's frame rate, a reader thread faults
+// in the frames ahead of playback and frames are dropped when sending falls behind
+class VideoPlayer
+{
+private:
+	const uint8_t			*mMap;			// whole file, NULL while closed
+	size_t					mMapSize;
+	videoFormat				mFormat;
+	int16_t					mWidth;
+	int16_t					mHeight;
+	double					mRate;
+	uint16_t				mChroma;		// y4m chroma subsampling, 420, 444 or 0 for mono
+	size_t					mFrameSize;		// bytes of one frame's pixels in the file
+	std::vector<size_t>		mFrames;		// file offset of each frame's pixels
+	FrameStream				mStream;
+	FrameBuffer				mFrame;			// frames that can't be sent straight from the mapping
+	FrameBuffer				mDecoded;		// frames of another size than the panel's, before centering
+
+	// reader thread
+	std::thread				mReader;
+	std::mutex				mMutex;
+	std::condition_variable	mWake;
+	size_t					mPosition;		// frames played since play() started, counts on across loops
+	bool					mStop;
+
+
+	bool parseY4M();
+	void read();
+	void touch(size_t index) const;
+	bool send(size_t index);
+
+
+public:
+	size_t					played;			// frames sent by the last play()
+	size_t					dropped;		// frames skipped by the last play() to keep up
+
+
+	VideoPlayer();
+	~VideoPlayer();
+
+	// width and height of raw files default to the panel size, fps 0 takes the file's or VIDEOPLAYER_RATE
+	bool open(const char *path, int16_t width = 0, int16_t height = 0, double fps = 0);
+	void close();
+	bool opened() const								{ return mMap != NULL; }
+
+	videoFormat format() const						{ return mFormat; }
+	int16_t width() const							{ return mWidth; }
+	int16_t height() const							{ return mHeight; }
+	double rate() const								{ return mRate; }
+	size_t frames() const							{ return mFrames.size(); }
+
+	// wire format and color correction, raw frames of panel size without either are sent straight
+	// from the mapping
+	FrameStream& stream()							{ return mStream; }
+
+	// decode one frame, e.g. to composite it with other content
+	bool frame(size_t index, FrameBuffer &dest) const;
+
+	// play the file loops times, 0 until stopped or gm_Exit, drawing functions and rendering ahead
+	// shouldn't be used meanwhile, false on device error
+	bool play(size_t loops = 1);
+};
+
+
+#endif // XPM_VIDEOPLAYER_H_
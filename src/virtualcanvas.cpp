@@ -0,0 +1,204 @@
+#include <xpmcommon.h>
+#include "rpc.h"
+#include "matrix.h"
+#include "framebuffer.h"
+#include "virtualcanvas.h"
+
+
+// non-negative remainder
+static inline int wrap(int value, int size)
+{
+	value %= size;
+	return (value < 0)? (value + size) : value;
+}
+
+// the movement equivalent to delta modulo size that is the shortest
+static inline int nearest(int delta, int size)
+{
+	delta = wrap(delta, size);
+	return (delta > (size / 2))? (delta - size) : delta;
+}
+
+
+
+//=============================================================================
+// Virtual canvas class
+//=============================================================================
+VirtualCanvas::VirtualCanvas(int16_t width, int16_t height)
+:	mCanvas(width, height),
+	mX(0),
+	mY(0),
+	mShownX(0),
+	mShownY(0),
+	mShown(false),
+	mWrap(false),
+	mBackground(0, 0, 0),
+	mDamage({0, 0, -1, -1}),
+	shifted(0),
+	redrawn(0)
+{
+}
+VirtualCanvas::~VirtualCanvas()
+{
+}
+
+bool VirtualCanvas::resize(int16_t width, int16_t height)
+{
+	mShown = false;
+	return mCanvas.resize(width, height);
+}
+
+void VirtualCanvas::setWrap(bool wrap)
+{
+	mWrap = wrap;
+	scrollTo(mX, mY);
+	mShown = false;
+}
+
+void VirtualCanvas::setBackground(const rgb24 &color)
+{
+	mBackground = color;
+	mShown = false;
+}
+
+void VirtualCanvas::scrollTo(int16_t x, int16_t y)
+{
+	mX = (mWrap && mCanvas.width())?  wrap(x, mCanvas.width())  : x;
+	mY = (mWrap && mCanvas.height())? wrap(y, mCanvas.height()) : y;
+}
+
+void VirtualCanvas::damage(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+	if(x0 > x1)	std::swap(x0, x1);
+	if(y0 > y1)	std::swap(y0, y1);
+
+	if(mDamage.x0 > mDamage.x1)
+	{
+		mDamage = {x0, y0, x1, y1};
+		return;
+	}
+
+	mDamage.x0 = std::min(mDamage.x0, x0);
+	mDamage.y0 = std::min(mDamage.y0, y0);
+	mDamage.x1 = std::max(mDamage.x1, x1);
+	mDamage.y1 = std::max(mDamage.y1, y1);
+}
+
+// count pixels of canvas row cy from column cx on, background outside unless wrapping
+void VirtualCanvas::copyRow(rgb24 *dest, int cx, int cy, int count) const
+{
+	const int w = mCanvas.width();
+	const int h = mCanvas.height();
+
+
+	if(mWrap)
+		cy = wrap(cy, h);
+	else if((cy < 0) || (cy >= h))
+	{
+		std::fill(dest, dest + count, mBackground);
+		return;
+	}
+
+	const rgb24 *src = mCanvas.row(cy);
+
+	while(count > 0)
+	{
+		int n;
+
+		if(mWrap)
+			cx = wrap(cx, w);
+
+		if(cx < 0)
+		{
+			n = std::min(count, -cx);
+			std::fill(dest, dest + n, mBackground);
+		} else if(cx >= w)
+		{
+			n = count;
+			std::fill(dest, dest + n, mBackground);
+		} else
+		{
+			n = std::min(count, w - cx);
+			memcpy((uint8_t *)dest, (const uint8_t *)(src + cx), n * sizeof(rgb24));
+		}
+
+		dest  += n;
+		cx    += n;
+		count -= n;
+	}
+}
+
+// viewport area in panel coordinates
+bool VirtualCanvas::drawArea(int x0, int y0, int x1, int y1)
+{
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min(x1, matrix.width  -1);
+	y1 = std::min(y1, matrix.height -1);
+	if((x0 > x1) || (y0 > y1))
+		return true;
+
+	const int w = x1 - x0 +1;
+	const int h = y1 - y0 +1;
+
+	if((mStrip.width() != w) || (mStrip.height() != h))
+		mStrip.resize(w, h);
+
+	for(int r=0; r<h; r++)
+		copyRow(mStrip.row(r), mX + x0, mY + y0 + r, w);
+
+	return matrix.drawImage(x0, y0, mStrip);
+}
+
+/**
+ * Bring the panel's drawing buffer up to the viewport. A viewport that
+ * moved less than the panel size since the last show() shifts the panel's
+ * previous frame and draws the columns and rows moved into view, so the
+ * bandwidth follows the scroll speed rather than the panel area.
+ *
+ * @return	false on device error or if there is nothing to show.
+ */
+bool VirtualCanvas::show()
+{
+	const int	W      = matrix.width;
+	const int	H      = matrix.height;
+	int			dx     = mX - mShownX;
+	int			dy     = mY - mShownY;
+	bool		result = true;
+
+
+	if(!W || !H || !mCanvas.width() || !mCanvas.height())
+		return false;
+
+	if(mWrap)
+	{
+		dx = nearest(dx, mCanvas.width());
+		dy = nearest(dy, mCanvas.height());
+	}
+
+	if(mShown && (dx || dy) && (abs(dx) < W) && (abs(dy) < H) && matrix.shiftBuffer(-dx, -dy))
+	{
+		// moved into view
+		if(dx)
+			result = drawArea((dx > 0)? (W - dx) : 0, 0, (dx > 0)? (W -1) : (-dx -1), H -1);
+		if(dy && result)
+			result = drawArea(0, (dy > 0)? (H - dy) : 0, W -1, (dy > 0)? (H -1) : (-dy -1));
+
+		// whatever was drawn over the last frame moved along
+		if((mDamage.x0 <= mDamage.x1) && result)
+			result = drawArea(mDamage.x0 - dx, mDamage.y0 - dy, mDamage.x1 - dx, mDamage.y1 - dy);
+
+		shifted++;
+	} else if(!mShown || dx || dy)
+	{
+		result = drawArea(0, 0, W -1, H -1);
+		redrawn++;
+	} else if(mDamage.x0 <= mDamage.x1)
+		result = drawArea(mDamage.x0, mDamage.y0, mDamage.x1, mDamage.y1);
+
+	mShownX = mX;
+	mShownY = mY;
+	mShown  = result;
+	mDamage = {0, 0, -1, -1};
+	return result;
+}
@@ -0,0 +1,65 @@
+#ifndef XPM_VIRTUALCANVAS_H_
+#define XPM_VIRTUALCANVAS_H_
+
+
+// Content of any size rendered once on the host and shown through a panel sized viewport. Moving
+// the viewport shifts the panel's previous frame and draws only the columns and rows moved into
+// view, panels without RPCCAP_SHIFTBUFFER get the whole viewport drawn
+class VirtualCanvas
+{
+private:
+	FrameBuffer			mCanvas;
+	FrameBuffer			mStrip;			// viewport area being drawn
+	int16_t				mX, mY;			// viewport origin in canvas coordinates
+	int16_t				mShownX;		// viewport origin of the frame show() drew last
+	int16_t				mShownY;
+	bool				mShown;			// panel holds that frame, else show() draws the whole viewport
+	bool				mWrap;			// canvas repeats in both directions
+	rgb24				mBackground;	// around a canvas that doesn't wrap
+	struct
+	{
+		int16_t			x0, y0;
+		int16_t			x1, y1;
+	}					mDamage;		// panel area drawn over since show(), x0 > x1 if none
+
+
+	void copyRow(rgb24 *dest, int cx, int cy, int count) const;
+	bool drawArea(int x0, int y0, int x1, int y1);
+
+
+public:
+	size_t				shifted;		// frames show() scrolled on the panel
+	size_t				redrawn;		// frames show() drew the whole viewport of
+
+
+	VirtualCanvas(int16_t width = 0, int16_t height = 0);
+	~VirtualCanvas();
+
+	bool resize(int16_t width, int16_t height);
+	int16_t width() const							{ return mCanvas.width(); }
+	int16_t height() const							{ return mCanvas.height(); }
+
+	// draw into with the FrameBuffer functions, invalidate() afterwards if it is being shown
+	FrameBuffer& canvas()							{ return mCanvas; }
+
+	void setWrap(bool wrap);
+	bool getWrap() const							{ return mWrap; }
+	void setBackground(const rgb24 &color);
+
+	// viewport origin, shown by the next show(), taken modulo the canvas size when wrapping
+	void scrollTo(int16_t x, int16_t y);
+	void scroll(int16_t dx, int16_t dy)				{ scrollTo(mX + dx, mY + dy); }
+	int16_t x() const								{ return mX; }
+	int16_t y() const								{ return mY; }
+
+	// canvas changed or the panel showed something else, the next show() draws the whole viewport
+	void invalidate()								{ mShown = false; }
+	// panel area drawn over since show(), e.g. by an overlay, drawn from the canvas by the next show()
+	void damage(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+	// draw the viewport into the frame before anything else is drawn into it, swap afterwards
+	bool show();
+};
+
+
+#endif // XPM_VIRTUALCANVAS_H_
@@ -10,6 +10,12 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 #include <time.h>
 
 
@@ -104,6 +110,18 @@ extern tIOBuffer gm_IOBuffers[IOBUFFERS_COUNT];
 //#define PACKED __attribute__((packed))
 #define PACKED __attribute__ ((aligned(1), packed))
 
+// index sequences for compile time generated tables, tMakeIndices<N>::type is tIndices<0, .., N -1>,
+// built from halves so long tables stay within the template nesting limit
+template<size_t... I> struct tIndices {};
+template<typename A, typename B> struct tJoinIndices;
+template<size_t... A, size_t... B> struct tJoinIndices<tIndices<A...>, tIndices<B...>> { typedef tIndices<A..., (sizeof...(A) + B)...> type; };
+template<size_t N> struct tMakeIndices
+{
+	typedef typename tJoinIndices<typename tMakeIndices<N / 2>::type, typename tMakeIndices<N - (N / 2)>::type>::type type;
+};
+template<> struct tMakeIndices<0> { typedef tIndices<> type; };
+template<> struct tMakeIndices<1> { typedef tIndices<0> type; };
+
 
 // http://stackoverflow.com/a/15775519/139041
 extern std::string methodName(const std::string& prettyFunction);
@@ -161,13 +179,13 @@ typedef struct rgb24
 	}
 
 	// compare
-	bool operator==(const rgb24 &rv)
+	bool operator==(const rgb24 &rv) const
 	{
 		return (red   == rv.red)   &&
 			   (green == rv.green) &&
 			   (blue  == rv.blue);
 	}
-	bool operator!=(const rgb24 &rv)
+	bool operator!=(const rgb24 &rv) const
 	{
 		return !(*this == rv);
 	}